@@ -161,7 +161,7 @@ int dram_init (void)
 	/*
 	 * Disable all DDR Bridge buffers
 	 * We suspect some bug in the buffering scheme, so disable
-	 * this for now
+	 * this for now. "ddrb on" enables them after a self-test.
 	 */
 	M2S_SYSREG->ddrb_cr = 0;
 #endif
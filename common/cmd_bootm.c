@@ -34,6 +34,7 @@
 #include <bzlib.h>
 #include <environment.h>
 #include <lmb.h>
+#include <bootstage.h>
 #include <linux/ctype.h>
 #include <asm/byteorder.h>
 #include <asm/cache.h>
@@ -46,6 +47,10 @@
 #include <hush.h>
 #endif
 
+#ifdef CONFIG_IMGCACHE
+#include <imgcache.h>
+#endif
+
 #if defined(CONFIG_OF_LIBFDT)
 #include <fdt.h>
 #include <libfdt.h>
@@ -214,6 +219,8 @@ static int bootm_start(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 	void		*os_hdr;
 	int		ret;
 
+	bootstage_mark ("bootm_start");
+
 	memset ((void *)&images, 0, sizeof (images));
 	images.verify = getenv_yesno ("verify");
 
@@ -522,6 +529,7 @@ int do_bootm_subcommand (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 			ret = bootm_load_os(images.os, &load_end, 0);
 			if (ret)
 				return ret;
+			bootstage_mark ("bootm_loados");
 
 			lmb_reserve(&images.lmb, images.os.load,
 					(load_end - images.os.load));
@@ -651,6 +659,7 @@ int do_bootm (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 #endif
 
 	ret = bootm_load_os(images.os, &load_end, 1);
+	bootstage_mark ("bootm_loados");
 
 	if (ret < 0) {
 		if (ret == BOOTM_ERR_RESET)
@@ -755,12 +764,23 @@ static image_header_t *image_get_kernel (ulong img_addr, int verify)
 
 	if (verify) {
 		puts ("   Verifying Checksum ... ");
-		if (!image_check_dcrc (hdr)) {
-			printf ("Bad Data CRC\n");
-			show_boot_progress (-3);
-			return NULL;
+#ifdef CONFIG_IMGCACHE
+		if (imgcache_check (img_addr, hdr)) {
+			puts ("OK (cached)\n");
+		} else
+#endif
+		{
+			if (!image_check_dcrc (hdr)) {
+				printf ("Bad Data CRC\n");
+				show_boot_progress (-3);
+				return NULL;
+			}
+			puts ("OK\n");
+#ifdef CONFIG_IMGCACHE
+			imgcache_update (img_addr, hdr);
+#endif
 		}
-		puts ("OK\n");
+		bootstage_mark ("bootm_verify");
 	}
 	show_boot_progress (4);
 
@@ -1040,9 +1060,15 @@ int do_bootd (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 	if (run_command (getenv ("bootcmd"), flag) < 0)
 		rcode = 1;
 #else
+# ifdef CONFIG_SYS_HUSH_CACHE
+	if (parse_string_cached ("bootcmd", getenv ("bootcmd"),
+			FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP) != 0)
+		rcode = 1;
+# else
 	if (parse_string_outer (getenv ("bootcmd"),
 			FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP) != 0)
 		rcode = 1;
+# endif
 #endif
 	return rcode;
 }
@@ -0,0 +1,118 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Boot stage timestamps.
+ *
+ * Each mark stores timer_get_us(), so the first mark must come after
+ * the clocks and timer_init() are set up. On Cortex-M3 the time source
+ * is the DWT cycle counter; the 32-bit stamps wrap after about 71 minutes.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <bootstage.h>
+
+#ifndef CONFIG_BOOTSTAGE_MAX
+#define CONFIG_BOOTSTAGE_MAX	32
+#endif
+
+struct bootstage_rec {
+	const char		*name;
+	ulong			id;
+	ulong			time;		/* us */
+};
+
+static struct bootstage_rec rec[CONFIG_BOOTSTAGE_MAX];
+static int rec_count;
+
+void bootstage_mark_id(const char *name, ulong id)
+{
+	if (rec_count >= CONFIG_BOOTSTAGE_MAX)
+		return;
+
+	rec[rec_count].time = timer_get_us();
+	rec[rec_count].name = name;
+	rec[rec_count].id = id;
+	rec_count++;
+}
+
+int bootstage_get(int i, ulong *time_us, char *name, int len)
+{
+	char buf[64];
+
+	if (i >= rec_count || len <= 0)
+		return -1;
+
+	*time_us = rec[i].time;
+	if (rec[i].id)
+		sprintf(buf, "%.40s@%lx", rec[i].name, rec[i].id);
+	else
+		sprintf(buf, "%.40s", rec[i].name);
+	strncpy(name, buf, len - 1);
+	name[len - 1] = '\0';
+
+	return 0;
+}
+
+static int do_bootstage(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	ulong prev = 0;
+	int i;
+
+	if (argc > 1 && strcmp(argv[1], "mark") == 0 && argc > 2) {
+		/*
+		 * Names from the command line do not outlive the command,
+		 * so they share one static label.
+		 */
+		bootstage_mark_id("user", simple_strtoul(argv[2], NULL, 16));
+		return 0;
+	}
+
+	if (argc > 1 && strcmp(argv[1], "report") != 0) {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	printf("%12s %12s  %s\n", "Time (us)", "Delta (us)", "Stage");
+	for (i = 0; i < rec_count; i++) {
+		ulong us = rec[i].time;
+
+		printf("%12lu %12lu  %s", us, us - prev, rec[i].name);
+		if (rec[i].id)
+			printf(" 0x%08lx", rec[i].id);
+		puts("\n");
+		prev = us;
+	}
+	if (rec_count >= CONFIG_BOOTSTAGE_MAX)
+		printf("(record full, later marks were dropped)\n");
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	bootstage,	3,	1,	do_bootstage,
+	"boot stage timing",
+	"[report]  - print boot stage timestamps\n"
+	"bootstage mark id - add a 'user' mark with hex 'id'"
+);
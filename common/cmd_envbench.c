@@ -0,0 +1,127 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Cost of environment lookups and of running scripts, with and without
+ * the getenv() hash index (CONFIG_ENV_HASH).
+ */
+
+#include <common.h>
+#include <command.h>
+#include <environment.h>
+#ifdef CONFIG_SYS_HUSH_PARSER
+#include <hush.h>
+#endif
+
+#ifndef CONFIG_ENV_HASH
+# error "envbench compares against CONFIG_ENV_HASH"
+#endif
+
+/*
+ * Look up every variable, and one that is not there, "count" times
+ */
+static ulong envbench_getenv(ulong count)
+{
+	ulong start;
+	uchar *env, *nxt;
+	char name[64];
+	ulong n;
+	int i;
+
+	start = timer_get_us();
+	for (n = 0; n < count; n++) {
+		for (env = env_get_addr(0); *env; env = nxt + 1) {
+			for (i = 0; env[i] && env[i] != '=' &&
+			     i < sizeof(name) - 1; i++)
+				name[i] = env[i];
+			name[i] = '\0';
+			getenv(name);
+			for (nxt = env; *nxt; ++nxt)
+				;
+		}
+		getenv("envbench-no-such-variable");
+	}
+	return timer_get_us() - start;
+}
+
+static ulong envbench_cmd(char *cmd, ulong count)
+{
+	ulong start;
+	ulong n;
+
+	start = timer_get_us();
+	for (n = 0; n < count; n++) {
+#ifndef CONFIG_SYS_HUSH_PARSER
+		run_command(cmd, 0);
+#else
+		parse_string_outer(cmd,
+			FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP);
+#endif
+	}
+	return timer_get_us() - start;
+}
+
+static int do_envbench(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	int saved = env_hash_enabled;
+	ulong count = 100;
+	ulong t[2];
+	char *cmd = NULL;
+	int i;
+
+	if (argc > 1 && strcmp(argv[1], "cmd") == 0) {
+		if (argc < 3) {
+			cmd_usage(cmdtp);
+			return 1;
+		}
+		cmd = argv[2];
+		if (argc > 3)
+			count = simple_strtoul(argv[3], NULL, 10);
+	} else if (argc > 1) {
+		count = simple_strtoul(argv[1], NULL, 10);
+	}
+
+	if (count == 0)
+		count = 1;
+
+	/* Linear scan first, then with the index */
+	for (i = 0; i < 2; i++) {
+		env_hash_enabled = i;
+		t[i] = cmd ? envbench_cmd(cmd, count) :
+			envbench_getenv(count);
+	}
+	env_hash_enabled = saved;
+
+	printf("%lu runs: linear %lu us, hashed %lu us\n",
+		count, t[0], t[1]);
+	return 0;
+}
+
+U_BOOT_CMD(
+	envbench,	4,	0,	do_envbench,
+	"time environment lookups with and without the hash index",
+	"[count]\n"
+	"    - look up every variable count times (default 100)\n"
+	"envbench cmd 'command' [count]\n"
+	"    - run command count times, e.g. a script with many ${var}"
+);
@@ -0,0 +1,140 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+
+/*
+ * Throughput of the library routines that can be run from on-chip RAM
+ * (see CONFIG_ARMCORTEXM3_HOTCODE). Run the same command on builds with
+ * and without that option to see what the RAM they take buys.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <div64.h>
+#include <u-boot/crc.h>
+#include <linux/lzo.h>
+#include <net.h>
+
+#ifndef CONFIG_SYS_BOOTM_LEN
+#define CONFIG_SYS_BOOTM_LEN	0x800000
+#endif
+
+static const char *hotbench_where(void *fn)
+{
+	ulong a = (ulong)fn & ~1;	/* Thumb bit */
+
+#if defined(CONFIG_MEM_RAM_BASE) && defined(CONFIG_MEM_RAM_LEN)
+	if (a >= CONFIG_MEM_RAM_BASE &&
+	    a < CONFIG_MEM_RAM_BASE + CONFIG_MEM_RAM_LEN)
+		return "RAM";
+#endif
+#if defined(CONFIG_MEM_RAMCODE_BASE) && defined(CONFIG_MEM_RAMCODE_LEN)
+	if (a >= CONFIG_MEM_RAMCODE_BASE &&
+	    a < CONFIG_MEM_RAMCODE_BASE + CONFIG_MEM_RAMCODE_LEN)
+		return "RAM";
+#endif
+	return "Flash";
+}
+
+static void hotbench_report(const char *name, void *fn, ulong len,
+	ulong start)
+{
+	unsigned long long kbs;
+	ulong us = timer_get_us() - start;
+
+	if (!us)
+		us = 1;
+
+	kbs = (unsigned long long)len * 1000000;
+	do_div(kbs, us);
+	do_div(kbs, 1024);
+
+	printf("%-10s %-6s %8lu bytes %10lu us %8lu KB/s\n",
+		name, fn ? hotbench_where(fn) : "", len, us, (ulong)kbs);
+}
+
+static int do_hotbench(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	ulong start;
+	uchar *src, *dst;
+	ulong len, dlen;
+	int ret;
+
+	if (argc < 3) {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	src = (uchar *)simple_strtoul(argv[1], NULL, 16);
+	len = simple_strtoul(argv[2], NULL, 16);
+	dst = argc > 3 ? (uchar *)simple_strtoul(argv[3], NULL, 16) :
+		src + len;
+
+	start = timer_get_us();
+	crc32(0, src, len);
+	hotbench_report("crc32", crc32_no_comp, len, start);
+
+	start = timer_get_us();
+	memcpy(dst, src, len);
+	hotbench_report("memcpy", memcpy, len, start);
+
+#ifdef CONFIG_CMD_NET
+	start = timer_get_us();
+	NetCksum(src, len / 2);
+	hotbench_report("cksum", NetCksum, len & ~1, start);
+#endif
+
+	/*
+	 * Decompress the buffer, if it holds something we know about.
+	 * Throughput is given for the uncompressed data.
+	 */
+	if (src[0] == 0x1f && src[1] == 0x8b) {
+		dlen = len;
+		start = timer_get_us();
+		ret = gunzip(dst, CONFIG_SYS_BOOTM_LEN, src, &dlen);
+		if (ret == 0)
+			hotbench_report("gunzip", NULL, dlen, start);
+		return ret != 0;
+	}
+
+#ifdef CONFIG_LZO
+	{
+		size_t size = CONFIG_SYS_BOOTM_LEN;
+
+		start = timer_get_us();
+		ret = lzop_decompress(src, len, dst, &size);
+		if (ret == LZO_E_OK)
+			hotbench_report("unlzo", NULL, size, start);
+	}
+#endif
+
+	return 0;
+}
+
+U_BOOT_CMD(
+	hotbench,	4,	0,	do_hotbench,
+	"time crc32, memcpy, checksum and decompression",
+	"addr len [dst]\n"
+	"    - run each routine over len bytes at addr, copying\n"
+	"      or decompressing to dst (default: addr + len)"
+);
@@ -0,0 +1,299 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Verified-image cache.
+ *
+ * The cache is a single record in a reserved eNVM page. It holds a
+ * flash write generation counter and a few slot markers. A marker is
+ * valid only while its generation equals the record generation; any
+ * "sf erase"/"sf write" touching a valid slot bumps the generation,
+ * which drops all markers at once.
+ *
+ * The record is only reprogrammed when a marker is added or the
+ * generation is bumped, so a normal boot of an unchanged image costs
+ * no eNVM wear at all.
+ *
+ * A full data CRC check can be forced for one boot with "verify=full",
+ * or for all slots with "imgcache clear".
+ *
+ * Only the data of the last "sf read" can skip the check, and only if
+ * no download or memory command ("tftp", "loady", "cp", "mw"...) wrote
+ * over it since. The RAM tests are not tracked: "sf read" again after
+ * running one.
+ *
+ * Note that flash writes made outside of U-Boot (e.g. by Linux) are not
+ * seen here. Such updaters must rewrite the image header, or run
+ * "imgcache clear", for the new data to be verified.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <image.h>
+#include <imgcache.h>
+#include <envm.h>
+#include <linux/stddef.h>
+
+#ifndef CONFIG_SYS_IMGCACHE_ENVM_OFFSET
+# error "CONFIG_SYS_IMGCACHE_ENVM_OFFSET must be defined"
+#endif
+
+#define IMGCACHE_MAGIC		0x56434831	/* "VCH1" */
+#define IMGCACHE_SLOTS		4
+
+#define IMGCACHE_ADDR		(CONFIG_MEM_NVM_BASE + \
+				 CONFIG_SYS_IMGCACHE_ENVM_OFFSET)
+
+struct imgcache_slot {
+	u32	offset;		/* Image offset in SPI flash	*/
+	u32	len;		/* Header + data length		*/
+	u32	hcrc;		/* Header CRC			*/
+	u32	dcrc;		/* Data CRC			*/
+	u32	gen;		/* Generation when verified	*/
+};
+
+struct imgcache_rec {
+	u32			magic;
+	u32			gen;
+	struct imgcache_slot	slot[IMGCACHE_SLOTS];
+	u32			crc;
+};
+
+static struct imgcache_rec rec;
+static int rec_loaded;
+
+/*
+ * Where the last "sf read" put its data. Downloads and the memory
+ * commands drop it when they write over it, and the next imgcache_check()
+ * uses it up, so that each "sf read" vouches for one bootm at most.
+ * "checked" carries the outcome on to imgcache_update() in that bootm.
+ */
+static struct {
+	ulong	addr;
+	ulong	offset;
+	ulong	len;
+	u32	gen;
+	int	valid;
+	int	checked;
+} origin;
+
+static u32 imgcache_crc(struct imgcache_rec *r)
+{
+	return crc32(0, (uchar *)r, offsetof(struct imgcache_rec, crc));
+}
+
+static void imgcache_load(void)
+{
+	if (rec_loaded)
+		return;
+
+	memcpy(&rec, (void *)IMGCACHE_ADDR, sizeof(rec));
+	if (rec.magic != IMGCACHE_MAGIC || rec.crc != imgcache_crc(&rec)) {
+		memset(&rec, 0, sizeof(rec));
+		rec.magic = IMGCACHE_MAGIC;
+		/* No slot is valid with a zero generation */
+		rec.gen = 1;
+	}
+	rec_loaded = 1;
+}
+
+static void imgcache_save(void)
+{
+	rec.crc = imgcache_crc(&rec);
+	if (envm_write(CONFIG_SYS_IMGCACHE_ENVM_OFFSET, &rec,
+			sizeof(rec)) != sizeof(rec))
+		puts("imgcache: eNVM write failed\n");
+}
+
+static int imgcache_overlap(ulong o1, ulong l1, ulong o2, ulong l2)
+{
+	return o1 < o2 + l2 && o2 < o1 + l1;
+}
+
+static int imgcache_slot_valid(struct imgcache_slot *s)
+{
+	return s->gen == rec.gen && s->len != 0;
+}
+
+/*
+ * Check that the image at addr came whole out of an "sf read"
+ * and the flash has not changed since then
+ */
+static int imgcache_origin_ok(ulong addr, const image_header_t *hdr)
+{
+	return origin.valid && origin.addr == addr &&
+		origin.gen == rec.gen &&
+		image_get_image_size(hdr) <= origin.len;
+}
+
+void imgcache_flash_read(ulong addr, ulong offset, ulong len)
+{
+	imgcache_load();
+
+	origin.addr = addr;
+	origin.offset = offset;
+	origin.len = len;
+	origin.gen = rec.gen;
+	origin.valid = 1;
+	origin.checked = 0;
+}
+
+void imgcache_flash_write(ulong offset, ulong len)
+{
+	int i;
+
+	imgcache_load();
+
+	if (origin.valid &&
+	    imgcache_overlap(offset, len, origin.offset, origin.len))
+		origin.valid = origin.checked = 0;
+
+	for (i = 0; i < IMGCACHE_SLOTS; i++) {
+		struct imgcache_slot *s = &rec.slot[i];
+
+		if (imgcache_slot_valid(s) &&
+		    imgcache_overlap(offset, len, s->offset, s->len)) {
+			rec.gen++;
+			imgcache_save();
+			break;
+		}
+	}
+}
+
+void imgcache_ram_write(ulong addr, ulong len)
+{
+	if (origin.valid &&
+	    imgcache_overlap(addr, len, origin.addr, origin.len))
+		origin.valid = origin.checked = 0;
+}
+
+int imgcache_check(ulong addr, const image_header_t *hdr)
+{
+	char *s = getenv("verify");
+	int i;
+
+	imgcache_load();
+
+	origin.checked = imgcache_origin_ok(addr, hdr);
+	origin.valid = 0;
+	if (!origin.checked)
+		return 0;
+
+	/* "verify=full" forces a complete check */
+	if (s && *s == 'f')
+		return 0;
+
+	for (i = 0; i < IMGCACHE_SLOTS; i++) {
+		struct imgcache_slot *sl = &rec.slot[i];
+
+		if (imgcache_slot_valid(sl) &&
+		    sl->offset == origin.offset &&
+		    sl->len == image_get_image_size(hdr) &&
+		    sl->hcrc == image_get_hcrc(hdr) &&
+		    sl->dcrc == image_get_dcrc(hdr)) {
+			origin.checked = 0;
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void imgcache_update(ulong addr, const image_header_t *hdr)
+{
+	struct imgcache_slot *sl = NULL;
+	int i;
+
+	imgcache_load();
+
+	if (!origin.checked || origin.addr != addr)
+		return;
+	origin.checked = 0;
+
+	/*
+	 * Re-use the marker for this slot, else a stale one, else the first
+	 */
+	for (i = 0; i < IMGCACHE_SLOTS; i++) {
+		if (rec.slot[i].offset == origin.offset) {
+			sl = &rec.slot[i];
+			break;
+		}
+		if (!sl && !imgcache_slot_valid(&rec.slot[i]))
+			sl = &rec.slot[i];
+	}
+	if (!sl)
+		sl = &rec.slot[0];
+
+	if (imgcache_slot_valid(sl) &&
+	    sl->offset == origin.offset &&
+	    sl->len == image_get_image_size(hdr) &&
+	    sl->hcrc == image_get_hcrc(hdr) &&
+	    sl->dcrc == image_get_dcrc(hdr))
+		return;
+
+	sl->offset = origin.offset;
+	sl->len = image_get_image_size(hdr);
+	sl->hcrc = image_get_hcrc(hdr);
+	sl->dcrc = image_get_dcrc(hdr);
+	sl->gen = rec.gen;
+	imgcache_save();
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int do_imgcache(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	int i;
+
+	imgcache_load();
+
+	if (argc < 2 || strcmp(argv[1], "info") == 0) {
+		printf("Flash write generation: %u\n", rec.gen);
+		for (i = 0; i < IMGCACHE_SLOTS; i++) {
+			struct imgcache_slot *sl = &rec.slot[i];
+
+			if (!imgcache_slot_valid(sl))
+				continue;
+			printf("  slot 0x%08x: len 0x%08x hcrc 0x%08x "
+				"dcrc 0x%08x\n",
+				sl->offset, sl->len, sl->hcrc, sl->dcrc);
+		}
+		return 0;
+	}
+
+	if (strcmp(argv[1], "clear") == 0) {
+		rec.gen++;
+		imgcache_save();
+		return 0;
+	}
+
+	cmd_usage(cmdtp);
+	return 1;
+}
+
+U_BOOT_CMD(
+	imgcache,	2,	1,	do_imgcache,
+	"verified-image cache",
+	"[info]  - show verified image slots\n"
+	"imgcache clear - forget all slots, forcing full verification"
+);
@@ -29,12 +29,14 @@
 #include <s_record.h>
 #include <net.h>
 #include <exports.h>
+#include <imgcache.h>
 #include <xyzModem.h>
+#include <malloc.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
 #if defined(CONFIG_CMD_LOADB)
-static ulong load_serial_ymodem (ulong offset);
+static ulong load_serial_ymodem (ulong offset, int mode);
 #endif
 
 #if defined(CONFIG_CMD_LOADS)
@@ -180,6 +182,7 @@ load_serial (long offset)
 #endif
 		    {
 			memcpy ((char *)(store_addr), binbuf, binlen);
+			imgcache_ram_write (store_addr, binlen);
 		    }
 		    if ((store_addr) < start_addr)
 			start_addr = store_addr;
@@ -481,7 +484,19 @@ int do_load_serial_bin (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 			offset,
 			load_baudrate);
 
-		addr = load_serial_ymodem (offset);
+		addr = load_serial_ymodem (offset, xyzModem_ymodem);
+		if (addr == ~0)
+			rcode = 1;
+
+	} else if (strcmp(argv[0],"loadyg")==0) {
+		printf ("## Ready for binary (ymodem-g) download "
+			"to 0x%08lX at %d bps...\n",
+			offset,
+			load_baudrate);
+
+		addr = load_serial_ymodem (offset, xyzModem_ymodem_g);
+		if (addr == ~0)
+			rcode = 1;
 
 	} else {
 
@@ -524,6 +539,7 @@ static ulong load_serial_bin (ulong offset)
 
 	set_kerm_bin_mode ((ulong *) offset);
 	size = k_recv ();
+	imgcache_ram_write (offset, size);
 
 	/*
 	 * Gather any trailing characters (for instance, the ^D which
@@ -963,7 +979,39 @@ static int getcxmodem(void) {
 		return (getc());
 	return -1;
 }
-static ulong load_serial_ymodem (ulong offset)
+
+#ifdef CONFIG_GZIP
+/*
+ * Files sent under a "*.gz" name are gunzipped as they arrive
+ */
+static int load_serial_is_gz (const char *name)
+{
+	int len = name ? strlen (name) : 0;
+
+	return len > 3 && strcmp (name + len - 3, ".gz") == 0;
+}
+
+/*
+ * Room for the uncompressed data, below the malloc() pool. None if the
+ * destination is in or above the pool, which is at the top of RAM.
+ */
+static ulong load_serial_room (ulong offset)
+{
+	if (offset < mem_malloc_start)
+		return mem_malloc_start - offset;
+	return 0;
+}
+#endif
+
+/* Bytes per second */
+static ulong load_serial_rate (ulong bytes, ulong ms)
+{
+	if (ms == 0)
+		return 0;
+	return bytes / ms * 1000 + bytes % ms * 1000 / ms;
+}
+
+static ulong load_serial_ymodem (ulong offset, int mode)
 {
 	int size;
 	char buf[32];
@@ -973,17 +1021,54 @@ static ulong load_serial_ymodem (ulong offset)
 	char ymodemBuf[1024];
 	ulong store_addr = ~0;
 	ulong addr = 0;
+	ulong start = 0, ms;
+	int gz = 0;
 
 	size = 0;
-	info.mode = xyzModem_ymodem;
+	info.mode = mode;
 	res = xyzModem_stream_open (&info, &err);
 	if (!res) {
+		start = get_timer (0);
+#ifdef CONFIG_GZIP
+		gz = load_serial_is_gz (info.filename);
+#ifndef CONFIG_SYS_NO_FLASH
+		if (gz && addr2info (offset)) {
+			puts ("## Can't gunzip into flash\n");
+			xyzModem_stream_terminate (true, &getcxmodem);
+			return (~0);
+		}
+#endif
+		if (gz && !load_serial_room (offset)) {
+			puts ("## Can't gunzip into the malloc() pool\n");
+			xyzModem_stream_terminate (true, &getcxmodem);
+			return (~0);
+		}
+		if (gz)
+			imgcache_ram_write (offset, load_serial_room (offset));
+		if (gz && gunzip_stream_start ((void *)offset,
+				load_serial_room (offset)) < 0) {
+			xyzModem_stream_terminate (true, &getcxmodem);
+			return (~0);
+		}
+#endif
 
 		while ((res =
 			xyzModem_stream_read (ymodemBuf, 1024, &err)) > 0) {
 			store_addr = addr + offset;
 			size += res;
 			addr += res;
+#ifdef CONFIG_GZIP
+			if (gz) {
+				if (gunzip_stream_feed ((uchar *)ymodemBuf,
+						res) < 0) {
+					xyzModem_stream_terminate (true,
+						&getcxmodem);
+					gunzip_stream_end ();
+					return (~0);
+				}
+				continue;
+			}
+#endif
 #ifndef CONFIG_SYS_NO_FLASH
 			if (addr2info (store_addr)) {
 				int rc;
@@ -999,6 +1084,7 @@ static ulong load_serial_ymodem (ulong offset)
 			{
 				memcpy ((char *) (store_addr), ymodemBuf,
 					res);
+				imgcache_ram_write (store_addr, res);
 			}
 
 		}
@@ -1009,6 +1095,23 @@ static ulong load_serial_ymodem (ulong offset)
 	xyzModem_stream_close (&err);
 	xyzModem_stream_terminate (false, &getcxmodem);
 
+	ms = get_timer (start);
+	if (size)
+		printf ("## Wire: %d Bytes in %lu.%03lu s, %lu Bytes/s\n",
+			size, ms / 1000, ms % 1000,
+			load_serial_rate (size, ms));
+
+#ifdef CONFIG_GZIP
+	if (gz) {
+		long len = gunzip_stream_end ();
+
+		if (len < 0)
+			return (~0);
+		printf ("## Uncompressed %ld Bytes, effective %lu Bytes/s\n",
+			len, load_serial_rate (len, ms));
+		size = len;
+	}
+#endif
 
 	flush_cache (offset, size);
 
@@ -1083,7 +1186,19 @@ U_BOOT_CMD(
 	"load binary file over serial line (ymodem mode)",
 	"[ off ] [ baud ]\n"
 	"    - load binary file over serial line"
-	" with offset 'off' and baudrate 'baud'"
+	" with offset 'off' and baudrate 'baud'\n"
+	"      (a file sent as \"*.gz\" is gunzipped as it arrives)"
+);
+
+U_BOOT_CMD(
+	loadyg, 3, 0,	do_load_serial_bin,
+	"load binary file over serial line (ymodem-g mode)",
+	"[ off ] [ baud ]\n"
+	"    - load binary file over serial line"
+	" with offset 'off' and baudrate 'baud',\n"
+	"      streamed without per-block handshake: the receiver asks\n"
+	"      for Y-modem-G, the sender must support it (lrzsz \"sb\" does)\n"
+	"      (a file sent as \"*.gz\" is gunzipped as it arrives)"
 );
 
 #endif
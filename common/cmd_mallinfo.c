@@ -0,0 +1,381 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * malloc() instrumentation.
+ *
+ * With CONFIG_SYS_MALLOC_STATS, dlmalloc only provides the dl* routines,
+ * and the public malloc(), free() etc. here record each call against
+ * its caller first. The "mallinfo" command then shows:
+ *
+ * - the peak of the arena obtained from sbrk(), i.e. how much of the
+ *   malloc() region was ever needed, and the bytes in use and their peak;
+ * - fragmentation: the free space outside the largest free chunk;
+ * - per call site: calls, failures, bytes requested, largest request,
+ *   and what is still allocated from there.
+ *
+ * Callers are return addresses, to look up in System.map. Live blocks
+ * are found again on free() through a small hash table; blocks that did
+ * not fit in it are still counted in the totals, but not per caller.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <malloc.h>
+
+#ifndef CONFIG_SYS_MALLOC_STATS_SITES
+#define CONFIG_SYS_MALLOC_STATS_SITES	32
+#endif
+#ifndef CONFIG_SYS_MALLOC_STATS_LIVE
+#define CONFIG_SYS_MALLOC_STATS_LIVE	256
+#endif
+
+#if CONFIG_SYS_MALLOC_STATS_LIVE & (CONFIG_SYS_MALLOC_STATS_LIVE - 1)
+# error "CONFIG_SYS_MALLOC_STATS_LIVE must be a power of 2"
+#endif
+
+#define LIVE_MASK	(CONFIG_SYS_MALLOC_STATS_LIVE - 1)
+
+struct malloc_site {
+	void	*caller;
+	ulong	calls;
+	ulong	fails;
+	ulong	bytes;		/* Requested in all			*/
+	ulong	max;		/* Largest request			*/
+	ulong	live;		/* Blocks not freed yet			*/
+	ulong	live_bytes;	/* Their usable size			*/
+	ulong	peak_bytes;	/* Highest live_bytes			*/
+};
+
+/*
+ * The last site collects the callers that did not fit
+ */
+static struct malloc_site sites[CONFIG_SYS_MALLOC_STATS_SITES + 1];
+static int nsites;
+
+static struct {
+	void	*mem;
+	int	site;
+} live[CONFIG_SYS_MALLOC_STATS_LIVE];
+static ulong nlive;
+
+static struct {
+	ulong	calls;
+	ulong	frees;
+	ulong	fails;
+	ulong	blocks;		/* Allocated now			*/
+	ulong	used;		/* Their usable size			*/
+	ulong	peak;		/* Highest "used"			*/
+	ulong	untracked;	/* Live blocks not in live[]		*/
+} ms;
+
+static struct malloc_site *malloc_site(void *caller)
+{
+	int i;
+
+	for (i = 0; i < nsites; i++) {
+		if (sites[i].caller == caller)
+			return &sites[i];
+	}
+	if (nsites < CONFIG_SYS_MALLOC_STATS_SITES) {
+		sites[nsites].caller = caller;
+		return &sites[nsites++];
+	}
+	return &sites[CONFIG_SYS_MALLOC_STATS_SITES];
+}
+
+static ulong live_hash(void *mem)
+{
+	return ((ulong)mem >> 3) & LIVE_MASK;
+}
+
+/*
+ * One slot is always left empty, so that the probes in live_add() and
+ * live_del() end
+ */
+static void live_add(void *mem, int site)
+{
+	ulong i;
+
+	if (nlive == CONFIG_SYS_MALLOC_STATS_LIVE - 1) {
+		ms.untracked++;
+		return;
+	}
+	for (i = live_hash(mem); live[i].mem; i = (i + 1) & LIVE_MASK)
+		;
+	live[i].mem = mem;
+	live[i].site = site;
+	nlive++;
+}
+
+/*
+ * Returns the site "mem" was allocated from, or -1 if it is not tracked
+ */
+static int live_del(void *mem)
+{
+	ulong i, j, h;
+	int site;
+
+	for (i = live_hash(mem); live[i].mem != mem; i = (i + 1) & LIVE_MASK) {
+		if (!live[i].mem)
+			return -1;
+	}
+	site = live[i].site;
+	nlive--;
+
+	/*
+	 * Move back the following entries that probed past the hole
+	 */
+	for (j = (i + 1) & LIVE_MASK; live[j].mem; j = (j + 1) & LIVE_MASK) {
+		h = live_hash(live[j].mem);
+		if (((j - h) & LIVE_MASK) >= ((j - i) & LIVE_MASK)) {
+			live[i] = live[j];
+			i = j;
+		}
+	}
+	live[i].mem = NULL;
+
+	return site;
+}
+
+/*
+ * Counts "mem" as allocated from "site", or untracked if "site" is -1
+ */
+static void malloc_stats_live(void *mem, int site)
+{
+	ulong size = malloc_usable_size(mem);
+	struct malloc_site *s;
+
+	ms.blocks++;
+	ms.used += size;
+	if (ms.used > ms.peak)
+		ms.peak = ms.used;
+
+	if (site < 0) {
+		ms.untracked++;
+		return;
+	}
+	s = &sites[site];
+	s->live++;
+	s->live_bytes += size;
+	if (s->live_bytes > s->peak_bytes)
+		s->peak_bytes = s->live_bytes;
+
+	live_add(mem, site);
+}
+
+static void malloc_stats_alloc(void *caller, void *mem, size_t bytes)
+{
+	struct malloc_site *s = malloc_site(caller);
+
+	ms.calls++;
+	s->calls++;
+	s->bytes += bytes;
+	if (bytes > s->max)
+		s->max = bytes;
+
+	if (!mem) {
+		ms.fails++;
+		s->fails++;
+		return;
+	}
+	malloc_stats_live(mem, s - sites);
+}
+
+/*
+ * Returns the site "mem" was allocated from, or -1 if it is not tracked
+ */
+static int malloc_stats_free(void *mem)
+{
+	ulong size = malloc_usable_size(mem);
+	int site;
+
+	ms.blocks--;
+	ms.used -= size;
+
+	site = live_del(mem);
+	if (site < 0) {
+		if (ms.untracked)
+			ms.untracked--;
+		return -1;
+	}
+	sites[site].live--;
+	sites[site].live_bytes -= size;
+	return site;
+}
+
+void *malloc(size_t bytes)
+{
+	void *mem = dlmalloc(bytes);
+
+	malloc_stats_alloc(__builtin_return_address(0), mem, bytes);
+	return mem;
+}
+
+void *calloc(size_t n, size_t elem_size)
+{
+	void *mem = dlcalloc(n, elem_size);
+
+	malloc_stats_alloc(__builtin_return_address(0), mem, n * elem_size);
+	return mem;
+}
+
+void *memalign(size_t alignment, size_t bytes)
+{
+	void *mem = dlmemalign(alignment, bytes);
+
+	malloc_stats_alloc(__builtin_return_address(0), mem, bytes);
+	return mem;
+}
+
+void *realloc(void *oldmem, size_t bytes)
+{
+	void *mem;
+	int site;
+
+	if (!oldmem) {
+		mem = dlmalloc(bytes);
+		malloc_stats_alloc(__builtin_return_address(0), mem, bytes);
+		return mem;
+	}
+
+	/*
+	 * Account the old block as freed first: dlrealloc() may free it.
+	 * On failure it stays allocated, and goes back to its own site.
+	 * Shrinking cannot fail, so NULL for 0 bytes means dlmalloc was
+	 * built with REALLOC_ZERO_BYTES_FREES and freed the block.
+	 */
+	site = malloc_stats_free(oldmem);
+	mem = dlrealloc(oldmem, bytes);
+	if (!mem && !bytes) {
+		ms.frees++;
+		return NULL;
+	}
+	malloc_stats_alloc(__builtin_return_address(0), mem, bytes);
+	if (!mem)
+		malloc_stats_live(oldmem, site);
+	return mem;
+}
+
+void free(void *mem)
+{
+	if (mem) {
+		ms.frees++;
+		malloc_stats_free(mem);
+	}
+	dlfree(mem);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static ulong percent(ulong part, ulong whole)
+{
+	return whole ? (ulong)((unsigned long long)part * 100 / whole) : 0;
+}
+
+static void mallinfo_report(int verbose)
+{
+	struct malloc_arena_info ai;
+	ulong len = mem_malloc_end - mem_malloc_start;
+	struct malloc_site *s;
+	int i;
+
+	malloc_arena_info(&ai);
+
+	printf("Region: 0x%08lx..0x%08lx, %lu KiB\n",
+		mem_malloc_start, mem_malloc_end, len >> 10);
+	printf("Arena:  %lu bytes now, peak %lu (%lu%% of the region)\n",
+		ai.arena, ai.max_arena, percent(ai.max_arena, len));
+	printf("In use: %lu bytes in %lu blocks, peak %lu\n",
+		ms.used, ms.blocks, ms.peak);
+	printf("Free:   %lu bytes in %lu chunks + top %lu, largest %lu, "
+		"fragmentation %lu%%\n",
+		ai.free - ai.topsize, ai.free_chunks, ai.topsize, ai.largest,
+		percent(ai.free - ai.largest, ai.free));
+	printf("Calls:  %lu allocations (%lu failed), %lu frees\n",
+		ms.calls, ms.fails, ms.frees);
+	if (ms.untracked)
+		printf("        %lu live blocks not tracked per caller\n",
+			ms.untracked);
+
+	if (!verbose)
+		return;
+
+	puts("\n  Caller        Calls  Fails      Bytes      Max   "
+		"Live  Live bytes       Peak\n");
+	for (i = 0; i <= CONFIG_SYS_MALLOC_STATS_SITES; i++) {
+		s = &sites[i];
+		if (!s->calls)
+			continue;
+		if (i == CONFIG_SYS_MALLOC_STATS_SITES)
+			printf("  (others)  ");
+		else
+			printf("  0x%08lx", (ulong)s->caller & ~1UL);
+		printf(" %7lu %6lu %10lu %8lu %6lu %11lu %10lu\n",
+			s->calls, s->fails, s->bytes, s->max,
+			s->live, s->live_bytes, s->peak_bytes);
+	}
+}
+
+/*
+ * Restart the peaks and call counts from the current state
+ */
+static void mallinfo_reset(void)
+{
+	int i;
+
+	ms.calls = ms.frees = ms.fails = 0;
+	ms.peak = ms.used;
+	for (i = 0; i <= CONFIG_SYS_MALLOC_STATS_SITES; i++) {
+		sites[i].calls = sites[i].fails = 0;
+		sites[i].bytes = sites[i].max = 0;
+		sites[i].peak_bytes = sites[i].live_bytes;
+	}
+}
+
+static int do_mallinfo(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	if (argc < 2) {
+		mallinfo_report(0);
+		return 0;
+	}
+	if (strcmp(argv[1], "-v") == 0) {
+		mallinfo_report(1);
+		return 0;
+	}
+	if (strcmp(argv[1], "reset") == 0) {
+		mallinfo_reset();
+		return 0;
+	}
+
+	cmd_usage(cmdtp);
+	return 1;
+}
+
+U_BOOT_CMD(
+	mallinfo,	2,	1,	do_mallinfo,
+	"show malloc() arena usage",
+	"    - show arena peak, use and fragmentation\n"
+	"mallinfo -v - also show statistics per caller\n"
+	"mallinfo reset - restart peaks and counts from now"
+);
@@ -0,0 +1,385 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Fast march-style memory test.
+ *
+ * Unlike "mtest", all passes move data in 16-byte LDM/STM bursts
+ * (on ARM), which the DDR controller serves as full bursts:
+ *
+ *  - data bus:    walking ones and zeros at the first word
+ *  - address bus: walking ones over the address lines
+ *  - address:     each word holds its own address, then its inverse
+ *  - MATS+:       {up(w0); up(r0,w1); down(r1,w0)}
+ *
+ * The march elements step over 16-byte blocks: blocks are visited in
+ * ascending or descending order, the words within a block always in
+ * ascending order.
+ *
+ * The passes run in chunks, so that the time limit and ctrl-c are
+ * honoured within a pass too. The contents of the test area are
+ * destroyed.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <watchdog.h>
+#include <div64.h>
+
+#define MT_BLOCK	16		/* Bytes per burst			*/
+#define MT_CHUNK	(64 * 1024)	/* Bytes between ctrl-c/time checks	*/
+#define MT_REPORT	16		/* Errors printed in full		*/
+
+static struct {
+	ulong			errors;
+	ulong			start;		/* get_timer() at start	*/
+	ulong			limit;		/* ms, 0 if no limit	*/
+	int			stop;		/* ctrl-c or time limit	*/
+} mt;
+
+#ifdef __arm__
+static inline ulong *mt_store4(ulong *p, ulong a, ulong b, ulong c, ulong d)
+{
+	register ulong r2 asm("r2") = a;
+	register ulong r3 asm("r3") = b;
+	register ulong r4 asm("r4") = c;
+	register ulong r5 asm("r5") = d;
+
+	asm volatile("stmia %0!, {r2-r5}"
+		: "+r" (p)
+		: "r" (r2), "r" (r3), "r" (r4), "r" (r5)
+		: "memory");
+	return p;
+}
+
+static inline ulong *mt_load4(ulong *p, ulong *v)
+{
+	register ulong r2 asm("r2");
+	register ulong r3 asm("r3");
+	register ulong r4 asm("r4");
+	register ulong r5 asm("r5");
+
+	asm volatile("ldmia %4!, {r2-r5}"
+		: "=r" (r2), "=r" (r3), "=r" (r4), "=r" (r5), "+r" (p)
+		:
+		: "memory");
+	v[0] = r2;
+	v[1] = r3;
+	v[2] = r4;
+	v[3] = r5;
+	return p;
+}
+#else
+static inline ulong *mt_store4(ulong *p, ulong a, ulong b, ulong c, ulong d)
+{
+	vu_long *q = p;
+
+	q[0] = a;
+	q[1] = b;
+	q[2] = c;
+	q[3] = d;
+	return p + 4;
+}
+
+static inline ulong *mt_load4(ulong *p, ulong *v)
+{
+	vu_long *q = p;
+
+	v[0] = q[0];
+	v[1] = q[1];
+	v[2] = q[2];
+	v[3] = q[3];
+	return p + 4;
+}
+#endif
+
+static void mt_error(ulong *addr, ulong expect, ulong actual)
+{
+	if (mt.errors++ < MT_REPORT)
+		printf("  FAIL at 0x%08lx: expected 0x%08lx, read 0x%08lx\n",
+			(ulong)addr, expect, actual);
+}
+
+/*
+ * Check a block read from p against what it should hold
+ */
+static inline void mt_check4(ulong *p, const ulong *v, ulong a, ulong b,
+			     ulong c, ulong d)
+{
+	if (((v[0] ^ a) | (v[1] ^ b) | (v[2] ^ c) | (v[3] ^ d)) == 0)
+		return;
+
+	if (v[0] != a)
+		mt_error(p, a, v[0]);
+	if (v[1] != b)
+		mt_error(p + 1, b, v[1]);
+	if (v[2] != c)
+		mt_error(p + 2, c, v[2]);
+	if (v[3] != d)
+		mt_error(p + 3, d, v[3]);
+}
+
+/*
+ * Returns 1 once the test is to stop
+ */
+static int mt_poll(void)
+{
+	WATCHDOG_RESET();
+	if (ctrlc()) {
+		puts("  interrupted\n");
+		mt.stop = 1;
+	} else if (mt.limit && get_timer(mt.start) >= mt.limit) {
+		puts("  time limit reached\n");
+		mt.stop = 1;
+	}
+	return mt.stop;
+}
+
+/*
+ * Fill with pat, or with pat ^ address if addr is set
+ */
+static void mt_fill(ulong *start, ulong *end, ulong pat, int addr)
+{
+	ulong *p = start, *c;
+	ulong a = addr ? ~0 : 0;
+
+	while (p < end && !mt_poll()) {
+		c = p + MT_CHUNK / sizeof(ulong);
+		if (c > end)
+			c = end;
+		while (p < c) {
+			ulong x = pat ^ ((ulong)p & a);
+
+			p = mt_store4(p, x, x ^ (4 & a), x ^ (8 & a),
+				x ^ (12 & a));
+		}
+	}
+}
+
+static void mt_verify(ulong *start, ulong *end, ulong pat, int addr)
+{
+	ulong *p = start, *c;
+	ulong a = addr ? ~0 : 0;
+	ulong v[4];
+
+	while (p < end && !mt_poll()) {
+		c = p + MT_CHUNK / sizeof(ulong);
+		if (c > end)
+			c = end;
+		while (p < c) {
+			ulong x = pat ^ ((ulong)p & a);
+
+			mt_load4(p, v);
+			mt_check4(p, v, x, x ^ (4 & a), x ^ (8 & a),
+				x ^ (12 & a));
+			p += 4;
+		}
+	}
+}
+
+/*
+ * March element: read and check each block for "expect", then write
+ * "write" to it. Blocks are visited upwards, or downwards if down is set.
+ */
+static void mt_march(ulong *start, ulong *end, int down, ulong expect,
+		     ulong write)
+{
+	ulong v[4];
+	ulong *p, *c;
+
+	if (!down) {
+		p = start;
+		while (p < end && !mt_poll()) {
+			c = p + MT_CHUNK / sizeof(ulong);
+			if (c > end)
+				c = end;
+			while (p < c) {
+				mt_load4(p, v);
+				mt_check4(p, v, expect, expect, expect, expect);
+				p = mt_store4(p, write, write, write, write);
+			}
+		}
+	} else {
+		p = end;
+		while (p > start && !mt_poll()) {
+			c = p - MT_CHUNK / sizeof(ulong);
+			if (c < start)
+				c = start;
+			while (p > c) {
+				p -= 4;
+				mt_load4(p, v);
+				mt_check4(p, v, expect, expect, expect, expect);
+				mt_store4(p, write, write, write, write);
+			}
+		}
+	}
+}
+
+/*
+ * Walking ones and zeros on the data bus
+ */
+static void mt_data_bus(vu_long *p)
+{
+	ulong pat;
+
+	for (pat = 1; pat != 0; pat <<= 1) {
+		*p = pat;
+		if (*p != pat)
+			mt_error((ulong *)p, pat, *p);
+		*p = ~pat;
+		if (*p != ~pat)
+			mt_error((ulong *)p, ~pat, *p);
+	}
+}
+
+/*
+ * Walking ones on the address lines: any stuck or shorted line makes
+ * two of the power-of-two offsets alias
+ */
+static void mt_addr_bus(vu_long *base, ulong words)
+{
+	const ulong pat = 0xaaaaaaaa, anti = 0x55555555;
+	ulong off, t;
+
+	for (off = 1; off < words; off <<= 1)
+		base[off] = pat;
+	base[0] = anti;
+	for (off = 1; off < words; off <<= 1)
+		if (base[off] != pat)
+			mt_error((ulong *)&base[off], pat, base[off]);
+	base[0] = pat;
+
+	for (t = 1; t < words; t <<= 1) {
+		base[t] = anti;
+		if (base[0] != pat)
+			mt_error((ulong *)base, pat, base[0]);
+		for (off = 1; off < words; off <<= 1)
+			if (off != t && base[off] != pat)
+				mt_error((ulong *)&base[off], pat, base[off]);
+		base[t] = pat;
+	}
+}
+
+static ulong mt_us(ulong start)
+{
+	ulong us = timer_get_us() - start;
+
+	return us ? us : 1;
+}
+
+/*
+ * Print the time a pass took, and the bandwidth for "len" bytes moved
+ */
+static void mt_report(const char *name, ulong len, ulong start)
+{
+	ulong us = mt_us(start);
+	unsigned long long kbs = (unsigned long long)len * 1000000;
+
+	do_div(kbs, us);
+	do_div(kbs, 1024);
+	printf("  %-16s %10lu us", name, us);
+	if (len)
+		printf(" %8lu KB/s", (ulong)kbs);
+	puts(mt.stop ? " (incomplete)\n" : "\n");
+}
+
+static int marchtest(ulong *start, ulong *end, ulong seconds)
+{
+	ulong len = (ulong)end - (ulong)start;
+	ulong t;
+	ulong words;
+
+	memset(&mt, 0, sizeof(mt));
+	mt.start = get_timer(0);
+	mt.limit = seconds * 1000;
+
+	printf("Testing 0x%08lx ... 0x%08lx", (ulong)start, (ulong)end);
+	if (seconds)
+		printf(", at most %lu s", seconds);
+	puts(":\n");
+
+	t = timer_get_us();
+	mt_data_bus((vu_long *)start);
+	for (words = 1; words * 2 <= len / sizeof(ulong); words *= 2)
+		;
+	mt_addr_bus((vu_long *)start, words);
+	mt_report("data/addr bus", 0, t);
+
+	if (!mt.stop) {
+		t = timer_get_us();
+		mt_fill(start, end, 0, 1);
+		mt_verify(start, end, 0, 1);
+		mt_report("address", 2 * len, t);
+	}
+	if (!mt.stop) {
+		t = timer_get_us();
+		mt_fill(start, end, ~0, 1);
+		mt_verify(start, end, ~0, 1);
+		mt_report("~address", 2 * len, t);
+	}
+	if (!mt.stop) {
+		t = timer_get_us();
+		mt_fill(start, end, 0, 0);
+		mt_march(start, end, 0, 0, ~0);
+		mt_march(start, end, 1, ~0, 0);
+		mt_report("MATS+", 5 * len, t);
+	}
+
+	printf("%lu errors%s, %lu ms\n", mt.errors,
+		mt.errors > MT_REPORT ? " (not all shown)" : "",
+		get_timer(mt.start));
+
+	return mt.errors || mt.stop ? -1 : 0;
+}
+
+static int do_marchtest(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	ulong start = CONFIG_SYS_MEMTEST_START;
+	ulong end = CONFIG_SYS_MEMTEST_END;
+	ulong seconds = 0;
+
+	if (argc > 1)
+		start = simple_strtoul(argv[1], NULL, 16);
+	if (argc > 2)
+		end = simple_strtoul(argv[2], NULL, 16);
+	if (argc > 3)
+		seconds = simple_strtoul(argv[3], NULL, 10);
+
+	start = (start + MT_BLOCK - 1) & ~(MT_BLOCK - 1);
+	end &= ~(MT_BLOCK - 1);
+	if (end <= start) {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	return marchtest((ulong *)start, (ulong *)end, seconds) != 0;
+}
+
+U_BOOT_CMD(
+	marchtest,	4,	0,	do_marchtest,
+	"fast march-style RAM test",
+	"[start [end [seconds]]]\n"
+	"    - test RAM from start to end with data/address bus,\n"
+	"      address-in-address and MATS+ passes, in bursts;\n"
+	"      stop (and fail) after 'seconds' if given"
+);
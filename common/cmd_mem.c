@@ -33,6 +33,7 @@
 #include <dataflash.h>
 #endif
 #include <watchdog.h>
+#include <imgcache.h>
 #ifdef CONFIG_SPIFI
 #include <spifi.h>
 #endif
@@ -204,6 +205,7 @@ int do_mem_mw ( cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 		count = 1;
 	}
 
+	imgcache_ram_write(addr, count * size);
 	while (count-- > 0) {
 		if (size == 4)
 			*((ulong  *)addr) = (ulong )writeval;
@@ -485,6 +487,7 @@ int do_mem_cp ( cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 	}
 #endif
 
+	imgcache_ram_write(dest, count * size);
 	while (count-- > 0) {
 		if (size == 4)
 			*((ulong  *)dest) = *((ulong  *)addr);
@@ -1111,6 +1114,7 @@ mod_mem(cmd_tbl_t *cmdtp, int incrflag, int flag, int argc, char *argv[])
 					*((ushort *)addr) = i;
 				else
 					*((u_char *)addr) = i;
+				imgcache_ram_write(addr, size);
 				if (incrflag)
 					addr += size;
 			}
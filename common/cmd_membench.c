@@ -0,0 +1,202 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+
+/*
+ * Memory bandwidth and latency benchmark. The contents of the
+ * test area are destroyed.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <div64.h>
+
+/*
+ * Stride between the random access slots. One slot per DDR burst
+ * (and per DDR bridge buffer line) makes each access a miss.
+ */
+#define MEMBENCH_SLOT		32
+
+static ulong membench_seed;
+
+static ulong membench_random(void)
+{
+	membench_seed = membench_seed * 1664525 + 1013904223;
+	return membench_seed >> 8;
+}
+
+static ulong membench_us(ulong start)
+{
+	ulong us = timer_get_us() - start;
+
+	return us ? us : 1;
+}
+
+static void membench_bw(const char *name, ulong len, ulong start)
+{
+	ulong us = membench_us(start);
+	unsigned long long kbs = (unsigned long long)len * 1000000;
+
+	do_div(kbs, us);
+	do_div(kbs, 1024);
+	printf("  %-12s %10lu us %8lu KB/s\n", name, us, (ulong)kbs);
+}
+
+static void membench_lat(const char *name, ulong n, ulong start)
+{
+	unsigned long long ns = (unsigned long long)membench_us(start) * 1000;
+
+	do_div(ns, n);
+	printf("  %-12s %10lu accesses %5lu ns each\n", name, n, (ulong)ns);
+}
+
+static void membench_seq_read(ulong *p, ulong len)
+{
+	ulong *end = p + len / sizeof(*p);
+	ulong sum = 0;
+
+	while (p + 4 <= end) {
+		sum += p[0] + p[1] + p[2] + p[3];
+		p += 4;
+	}
+	while (p < end)
+		sum += *p++;
+
+	/* Make sure the loads are not optimized away */
+	membench_seed ^= sum;
+}
+
+static void membench_seq_write(ulong *p, ulong len)
+{
+	ulong *end = p + len / sizeof(*p);
+
+	while (p + 4 <= end) {
+		p[0] = 0;
+		p[1] = 0;
+		p[2] = 0;
+		p[3] = 0;
+		p += 4;
+	}
+	while (p < end)
+		*p++ = 0;
+}
+
+/*
+ * Link the slots into one random cycle (Sattolo's algorithm)
+ * and follow it, so that each load depends on the previous one
+ */
+static void membench_chase(ulong base, ulong n)
+{
+	ulong start;
+	ulong i, j, t;
+	ulong *p;
+
+	for (i = 0; i < n; i++)
+		*(ulong *)(base + i * MEMBENCH_SLOT) = i;
+	for (i = n - 1; i > 0; i--) {
+		j = membench_random() % i;
+		t = *(ulong *)(base + i * MEMBENCH_SLOT);
+		*(ulong *)(base + i * MEMBENCH_SLOT) =
+			*(ulong *)(base + j * MEMBENCH_SLOT);
+		*(ulong *)(base + j * MEMBENCH_SLOT) = t;
+	}
+	for (i = 0; i < n; i++) {
+		p = (ulong *)(base + i * MEMBENCH_SLOT);
+		*p = base + *p * MEMBENCH_SLOT;
+	}
+
+	p = (ulong *)base;
+	start = timer_get_us();
+	for (i = 0; i < n; i++)
+		p = (ulong *)*p;
+	membench_lat("rand read", n, start);
+
+	membench_seed ^= (ulong)p;
+}
+
+static void membench_rand_write(ulong base, ulong n)
+{
+	ulong start;
+	ulong i, x = membench_seed;
+
+	start = timer_get_us();
+	for (i = 0; i < n; i++) {
+		/* Inline the generator to keep it out of the timing */
+		x = x * 1664525 + 1013904223;
+		*(volatile ulong *)(base + ((x >> 8) % n) * MEMBENCH_SLOT) = i;
+	}
+	membench_lat("rand write", n, start);
+}
+
+static int membench(ulong addr, ulong len)
+{
+	ulong start;
+	ulong n;
+
+	addr = (addr + MEMBENCH_SLOT - 1) & ~(MEMBENCH_SLOT - 1);
+	len &= ~(MEMBENCH_SLOT - 1);
+	n = len / MEMBENCH_SLOT;
+	if (n < 2) {
+		puts("membench: area too small\n");
+		return -1;
+	}
+
+	printf("Memory at 0x%08lx, 0x%lx bytes:\n", addr, len);
+	membench_seed = get_timer(0);
+
+	start = timer_get_us();
+	membench_seq_write((ulong *)addr, len);
+	membench_bw("seq write", len, start);
+
+	start = timer_get_us();
+	membench_seq_read((ulong *)addr, len);
+	membench_bw("seq read", len, start);
+
+	start = timer_get_us();
+	memcpy((void *)addr, (void *)(addr + len / 2), len / 2);
+	membench_bw("copy", len / 2, start);
+
+	membench_chase(addr, n);
+	membench_rand_write(addr, n);
+
+	return 0;
+}
+
+static int do_membench(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	if (argc < 3) {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	return membench(simple_strtoul(argv[1], NULL, 16),
+			simple_strtoul(argv[2], NULL, 16)) != 0;
+}
+
+U_BOOT_CMD(
+	membench,	3,	0,	do_membench,
+	"memory bandwidth and latency benchmark",
+	"addr len\n"
+	"    - time sequential read/write/copy and random read/write\n"
+	"      of len bytes at addr (contents are destroyed)"
+);
@@ -27,10 +27,14 @@
 #include <common.h>
 #include <command.h>
 #include <net.h>
+#if defined(CONFIG_CMD_NETBENCH)
+#include <netbench.h>
+#endif
 
 extern int do_bootm (cmd_tbl_t *, int, int, char *[]);
 
 static int netboot_common (proto_t, cmd_tbl_t *, int , char *[]);
+static void netboot_update_env (void);
 
 int do_bootp (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 {
@@ -91,6 +95,45 @@ U_BOOT_CMD(
 );
 #endif
 
+#if defined(CONFIG_CMD_WGET)
+int do_wget (cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	int size;
+
+#if defined(CONFIG_CMD_SF)
+	/* wget sf offset [file]: stream the file into SPI flash */
+	if (argc > 2 && strcmp(argv[1], "sf") == 0) {
+		if (argc > 4) {
+			cmd_usage(cmdtp);
+			return 1;
+		}
+		WgetFlashOffset = simple_strtoul(argv[2], NULL, 16);
+		if (argc == 4)
+			copy_filename(BootFile, argv[3], sizeof(BootFile));
+
+		size = NetLoop(WGET);
+		WgetFlashOffset = WGET_TO_RAM;
+		if (size < 0)
+			return 1;
+
+		netboot_update_env();
+		return 0;
+	}
+#endif
+	return netboot_common(WGET, cmdtp, argc, argv);
+}
+
+U_BOOT_CMD(
+	wget,	4,	1,	do_wget,
+	"load a file via network using HTTP",
+	"[loadAddress] [[hostIPaddr[:port]]/path]"
+#if defined(CONFIG_CMD_SF)
+	"\nwget sf offset [[hostIPaddr[:port]]/path]\n"
+	"    - write the file straight to SPI flash at offset"
+#endif
+);
+#endif
+
 static void netboot_update_env (void)
 {
 	char tmp[22];
@@ -386,3 +429,88 @@ U_BOOT_CMD(
 );
 
 #endif	/* CONFIG_CMD_DNS */
+
+#if defined(CONFIG_CMD_NETBENCH)
+int do_netbench(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	char *p;
+	int i = 2;
+	int ret;
+
+	if (argc < 2) {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	if (strcmp(argv[1], "sink") == 0) {
+		NetbenchSink = 1;
+		NetbenchPort = argc > 2 ?
+			simple_strtoul(argv[2], NULL, 10) : NETBENCH_PORT;
+		NetbenchSeconds = argc > 3 ?
+			simple_strtoul(argv[3], NULL, 10) : 0;
+	} else if (strcmp(argv[1], "send") == 0) {
+		NetbenchSink = 0;
+		NetbenchIP = getenv_IPaddr("serverip");
+		NetbenchPort = NETBENCH_PORT;
+
+		/* The target is the only argument with dots */
+		if (argc > i && strchr(argv[i], '.')) {
+			NetbenchIP = string_to_ip(argv[i]);
+			p = strchr(argv[i], ':');
+			if (p)
+				NetbenchPort = simple_strtoul(p + 1, NULL, 10);
+			i++;
+		}
+		NetbenchSeconds = argc > i ?
+			simple_strtoul(argv[i], NULL, 10) : 10;
+		i++;
+		NetbenchLen = argc > i ?
+			simple_strtoul(argv[i], NULL, 10) : NETBENCH_MAX_LEN;
+
+		if (NetbenchIP == 0) {
+			puts("*** ERROR: `serverip' not set\n");
+			return 1;
+		}
+		if (NetbenchLen < sizeof(struct netbench_hdr) ||
+		    NetbenchLen > NETBENCH_MAX_LEN) {
+			printf("Frame length must be %d..%d\n",
+				sizeof(struct netbench_hdr), NETBENCH_MAX_LEN);
+			return 1;
+		}
+	} else {
+		cmd_usage(cmdtp);
+		return 1;
+	}
+
+	ret = NetLoop(NETBENCH);
+	NetbenchReport();
+
+	return ret < 0;
+}
+
+U_BOOT_CMD(
+	netbench,	5,	1,	do_netbench,
+	"UDP throughput benchmark",
+	"send [hostIPaddr[:port]] [seconds [len]]\n"
+	"    - send len-byte UDP frames (default 1472) for seconds (default 10)\n"
+	"netbench sink [port [seconds]]\n"
+	"    - count frames to port (default 5001), with losses and jitter"
+);
+#endif	/* CONFIG_CMD_NETBENCH */
+
+#if defined(CONFIG_CMD_FASTBOOT)
+int do_fastboot(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	FastbootWait = argc > 1 ? simple_strtoul(argv[1], NULL, 10) : 0;
+
+	return NetLoop(FASTBOOT) < 0;
+}
+
+U_BOOT_CMD(
+	fastboot,	2,	1,	do_fastboot,
+	"serve fastboot-style UDP flashing requests",
+	"[seconds]\n"
+	"    - flash SPI partitions from a host running tools/fastboot;\n"
+	"      give up if no host shows up within seconds"
+);
+#endif	/* CONFIG_CMD_FASTBOOT */
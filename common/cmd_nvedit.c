@@ -52,6 +52,9 @@
 #if defined(CONFIG_CMD_NET)
 #include <net.h>
 #endif
+#ifdef CONFIG_SYS_HUSH_CACHE
+#include <hush.h>
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -95,6 +98,179 @@ int get_env_id (void)
 {
 	return env_id;
 }
+
+#ifdef CONFIG_ENV_HASH
+/*
+ * Hash index over the in-RAM environment, so getenv() does not have to
+ * walk the whole environment. setenv keeps it up to date: the changed
+ * variable leaves and re-enters the index, and the variables behind it,
+ * which move down, have their offsets adjusted. Anything else that
+ * changes the environment invalidates the index, and it is rebuilt on
+ * the next lookup.
+ */
+#ifndef CONFIG_ENV_HASH_SIZE
+# define CONFIG_ENV_HASH_SIZE	256	/* Power of 2 */
+#endif
+
+int env_hash_enabled = 1;
+
+static int env_hash_slot[CONFIG_ENV_HASH_SIZE];	/* Name index + 1 */
+static int env_hash_id;
+static uchar *env_hash_data;
+static int env_hash_full;
+static uint env_hash_count;
+
+void env_hash_invalidate (void)
+{
+	env_hash_id = 0;
+}
+
+static uint env_hash_name (uchar *s)
+{
+	uint h = 5381;
+
+	while (*s != '\0' && *s != '=')
+		h = h * 33 + *s++;
+	return h;
+}
+
+/*
+ * Same as envmatch(), for a name in the RAM copy of the environment
+ */
+static int env_hash_match (uchar *name, uchar *env)
+{
+	uchar *p = env;
+
+	while (*name != '\0' && *name != '=' && *name == *p) {
+		name++;
+		p++;
+	}
+	if ((*name == '\0' || *name == '=') && *p == '=')
+		return p + 1 - env;
+	return -1;
+}
+
+/*
+ * Add the variable at "off" to the index. The first definition wins, as
+ * for the linear scan.
+ */
+static void env_hash_add (uchar *data, int off)
+{
+	uint h;
+
+	/* Keep a quarter of the table free */
+	if (++env_hash_count > CONFIG_ENV_HASH_SIZE * 3 / 4) {
+		env_hash_full = 1;
+		return;
+	}
+
+	h = env_hash_name(data + off);
+	for (;;) {
+		int *slot = &env_hash_slot[h & (CONFIG_ENV_HASH_SIZE - 1)];
+
+		if (*slot == 0) {
+			*slot = off + 1;
+			break;
+		}
+		if (env_hash_match(data + off, data + *slot - 1) >= 0)
+			break;
+		h++;
+	}
+}
+
+/*
+ * Drop the variable at "off", "len" bytes long, from the index, before
+ * setenv moves the ones behind it down over it
+ */
+static void env_hash_del (uchar *data, int off, int len)
+{
+	uint mask = CONFIG_ENV_HASH_SIZE - 1;
+	uint i, j, h;
+
+	for (i = env_hash_name(data + off) & mask;
+	     env_hash_slot[i] != off + 1; i = (i + 1) & mask) {
+		if (!env_hash_slot[i])
+			goto shift;
+	}
+	env_hash_count--;
+
+	/*
+	 * Move back the following entries that probed past the hole
+	 */
+	for (j = (i + 1) & mask; env_hash_slot[j]; j = (j + 1) & mask) {
+		h = env_hash_name(data + env_hash_slot[j] - 1) & mask;
+		if (((j - h) & mask) >= ((j - i) & mask)) {
+			env_hash_slot[i] = env_hash_slot[j];
+			i = j;
+		}
+	}
+	env_hash_slot[i] = 0;
+
+shift:
+	for (i = 0; i < CONFIG_ENV_HASH_SIZE; i++) {
+		if (env_hash_slot[i] > off + 1)
+			env_hash_slot[i] -= len;
+	}
+}
+
+static void env_hash_build (uchar *data)
+{
+	uchar *env, *nxt;
+
+	memset(env_hash_slot, 0, sizeof(env_hash_slot));
+	env_hash_full = 0;
+	env_hash_count = 0;
+
+	for (env = data; *env; env = nxt + 1) {
+		for (nxt = env; *nxt; ++nxt) {
+			if (nxt - data >= ENV_SIZE) {
+				env_hash_full = 1;
+				return;
+			}
+		}
+
+		env_hash_add(data, env - data);
+		if (env_hash_full)
+			return;
+	}
+}
+
+/*
+ * Look up "name" in the index.
+ * Returns the index of its value, -1 if not defined,
+ * or -2 if the index cannot be used.
+ */
+static int env_hash_lookup (char *name)
+{
+	uchar *data;
+	uint h;
+
+	if (!env_hash_enabled || !(gd->flags & GD_FLG_RELOC))
+		return -2;
+
+	data = env_get_addr(0);
+	if (env_hash_id != env_id || env_hash_data != data) {
+		env_hash_build(data);
+		env_hash_id = env_id;
+		env_hash_data = data;
+	}
+	if (env_hash_full)
+		return -2;
+
+	h = env_hash_name((uchar *)name);
+	for (;;) {
+		int slot = env_hash_slot[h & (CONFIG_ENV_HASH_SIZE - 1)];
+		int val;
+
+		if (slot == 0)
+			return -1;
+		val = env_hash_match((uchar *)name, data + slot - 1);
+		if (val >= 0)
+			return slot - 1 + val;
+		h++;
+	}
+}
+#endif /* CONFIG_ENV_HASH */
 /************************************************************************
  * Command interface: print one or all environment variables
  */
@@ -195,7 +371,16 @@ int _do_setenv (int flag, int argc, char *argv[])
 		return 1;
 	}
 
+#ifdef CONFIG_ENV_HASH
+	/* The index follows this change, see env_hash_del()/env_hash_add() */
+	if (env_hash_id == env_id && env_hash_data == env_data &&
+	    !env_hash_full)
+		env_hash_id = env_id + 1;
+#endif
 	env_id++;
+#ifdef CONFIG_SYS_HUSH_CACHE
+	hush_cache_forget(name);
+#endif
 	/*
 	 * search if variable with this name already exists
 	 */
@@ -296,6 +481,10 @@ int _do_setenv (int flag, int argc, char *argv[])
 			}
 		}
 
+#ifdef CONFIG_ENV_HASH
+		if (env_hash_id == env_id)
+			env_hash_del(env_data, env - env_data, nxt + 1 - env);
+#endif
 		if (*++nxt == '\0') {
 			if (env > env_data) {
 				env--;
@@ -349,6 +538,12 @@ int _do_setenv (int flag, int argc, char *argv[])
 			;
 	}
 
+#ifdef CONFIG_ENV_HASH
+	/* "name=val..." is len - 2 bytes, up to env */
+	if (env_hash_id == env_id)
+		env_hash_add(env_data, env - (len - 2) - env_data);
+#endif
+
 	/* end is marked with double '\0' */
 	*++env = '\0';
 
@@ -547,6 +742,12 @@ char *getenv (char *name)
 
 	WATCHDOG_RESET();
 
+#ifdef CONFIG_ENV_HASH
+	i = env_hash_lookup(name);
+	if (i != -2)
+		return i < 0 ? NULL : (char *)env_get_addr(i);
+#endif
+
 	for (i=0; env_get_char(i) != '\0'; i=nxt+1) {
 		int val;
 
@@ -567,6 +768,21 @@ int getenv_r (char *name, char *buf, unsigned len)
 {
 	int i, nxt;
 
+#ifdef CONFIG_ENV_HASH
+	i = env_hash_lookup(name);
+	if (i == -1)
+		return (-1);
+	if (i >= 0) {
+		int n = 0;
+
+		while ((len > n++) && (*buf++ = env_get_char(i++)) != '\0')
+			;
+		if (len == n)
+			*buf = '\0';
+		return (n);
+	}
+#endif
+
 	for (i=0; env_get_char(i) != '\0'; i=nxt+1) {
 		int val, n;
 
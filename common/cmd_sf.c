@@ -7,6 +7,10 @@
 
 #include <common.h>
 #include <spi_flash.h>
+#include <bootstage.h>
+#ifdef CONFIG_IMGCACHE
+#include <imgcache.h>
+#endif
 
 #include <asm/io.h>
 
@@ -103,10 +107,19 @@ static int do_spi_flash_read_write(int argc, char *argv[])
 		return 1;
 	}
 
-	if (strcmp(argv[0], "read") == 0)
+	if (strcmp(argv[0], "read") == 0) {
 		ret = spi_flash_read(flash, offset, len, buf);
-	else
+		bootstage_mark("sf_read");
+#ifdef CONFIG_IMGCACHE
+		if (!ret)
+			imgcache_flash_read(addr, offset, len);
+#endif
+	} else {
+#ifdef CONFIG_IMGCACHE
+		imgcache_flash_write(offset, len);
+#endif
 		ret = spi_flash_write(flash, offset, len, buf);
+	}
 
 	unmap_physmem(buf, len);
 
@@ -139,6 +152,9 @@ static int do_spi_flash_erase(int argc, char *argv[])
 	if (*argv[2] == 0 || *endp != 0)
 		goto usage;
 
+#ifdef CONFIG_IMGCACHE
+	imgcache_flash_write(offset, len);
+#endif
 	ret = spi_flash_erase(flash, offset, len);
 	if (ret) {
 		printf("SPI flash %s failed\n", argv[0]);
@@ -0,0 +1,505 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * A/B image slot manager.
+ *
+ * Each SPI flash image partition is a slot, with metadata (image size,
+ * data CRC, version, attempts left and whether it ever booted) in the
+ * record described in <slot.h>. "slot boot" tries the active slot,
+ * then the others:
+ *
+ * - a slot with no attempts left is skipped without touching its
+ *   partition;
+ * - the image header is read and checked first, so a bad slot is
+ *   dropped after a 64 byte read, not a full partition read;
+ * - only the image itself is read, not the whole partition;
+ * - if bootm returns, the slot is dropped until it is updated again.
+ *
+ * Every try costs one attempt, good slot or not, and "slot good", or
+ * fw_slot in Linux, gives the attempts back once the system is up. So a
+ * good image that later falls into a boot loop (panic, watchdog) runs
+ * out of attempts too, and the next slot is tried. When no slot has any
+ * attempts left, the good ones are still tried as a last resort.
+ *
+ * Without a record, e.g. on the first boot after an upgrade, all slots
+ * holding a valid image header are taken to be good, which is what the
+ * boot scripts assumed. Attempts are only counted once a slot has been
+ * marked good ("counting" in the record): a root file system without
+ * fw_slot never gives them back, and would otherwise fall over to the
+ * next slot after CONFIG_SYS_SLOT_TRIES boots. Until then a slot is
+ * only dropped when its header is bad or bootm returns.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <image.h>
+#include <malloc.h>
+#include <spi_flash.h>
+#include <bootstage.h>
+#include <slot.h>
+#include <linux/stddef.h>
+#ifdef CONFIG_IMGCACHE
+#include <imgcache.h>
+#endif
+
+#ifndef CONFIG_SYS_SLOT_REC_OFFSET
+# error "CONFIG_SYS_SLOT_REC_OFFSET must be defined"
+#endif
+#ifndef CONFIG_SYS_SLOT_REC_SIZE
+# define CONFIG_SYS_SLOT_REC_SIZE	CONFIG_ENV_SECT_SIZE
+#endif
+#ifndef CONFIG_SYS_SLOT_TRIES
+# define CONFIG_SYS_SLOT_TRIES		3
+#endif
+#ifndef CONFIG_SYS_SLOT_BOOTCMD
+# define CONFIG_SYS_SLOT_BOOTCMD	"bootm"
+#endif
+
+#ifndef CONFIG_SPI_FLASH_BUS
+# define CONFIG_SPI_FLASH_BUS		0
+#endif
+#ifndef CONFIG_SPI_FLASH_CS
+# define CONFIG_SPI_FLASH_CS		0
+#endif
+#ifndef CONFIG_SF_DEFAULT_SPEED
+# define CONFIG_SF_DEFAULT_SPEED	1000000
+#endif
+#ifndef CONFIG_SF_DEFAULT_MODE
+# define CONFIG_SF_DEFAULT_MODE		SPI_MODE_3
+#endif
+
+#define SLOT_REC_END	(CONFIG_SYS_SLOT_REC_OFFSET + CONFIG_SYS_SLOT_REC_SIZE)
+
+/*
+ * SPI flash partitions of the slots; a zero size leaves a slot unused
+ */
+static const struct {
+	ulong	offset;
+	ulong	size;
+} slot_part[SLOT_MAX] = CONFIG_SYS_SLOT_PARTS;
+
+static struct spi_flash *slot_flash;
+static struct slot_rec rec;
+static ulong slot_next;		/* Where the next entry goes		*/
+static int slot_clean;		/* slot_next is in erased space		*/
+
+static char slot_name(int i)
+{
+	return 'a' + i;
+}
+
+static int slot_parse(const char *s)
+{
+	int i = s[0] - 'a';
+
+	if (i < 0 || i >= SLOT_MAX || s[1] || !slot_part[i].size) {
+		printf("slot: no slot \"%s\"\n", s);
+		return -1;
+	}
+	return i;
+}
+
+/*
+ * Read and check the image header of slot "i".
+ * Returns the image size, or 0 if there is no valid image.
+ */
+static ulong slot_read_header(int i, image_header_t *hdr)
+{
+	ulong size;
+
+	if (spi_flash_read(slot_flash, slot_part[i].offset, sizeof(*hdr), hdr))
+		return 0;
+	if (!image_check_magic(hdr) || !image_check_hcrc(hdr))
+		return 0;
+
+	size = image_get_image_size(hdr);
+	return size <= slot_part[i].size ? size : 0;
+}
+
+static void slot_set(int i, const image_header_t *hdr, int good)
+{
+	struct slot_info *s = &rec.slot[i];
+
+	s->size = image_get_image_size(hdr);
+	s->dcrc = image_get_dcrc(hdr);
+	s->version = image_get_time(hdr);
+	s->tries = rec.limit;
+	s->good = good;
+}
+
+/*
+ * Build a record from the image headers in flash
+ */
+static void slot_init(void)
+{
+	image_header_t hdr;
+	int i;
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = SLOT_MAGIC;
+	rec.booting = SLOT_NONE;
+	rec.limit = CONFIG_SYS_SLOT_TRIES;
+
+	for (i = 0; i < SLOT_MAX; i++) {
+		if (slot_part[i].size && slot_read_header(i, &hdr))
+			slot_set(i, &hdr, 1);
+	}
+}
+
+static int slot_erased(const struct slot_rec *r)
+{
+	const u32 *p = (const u32 *)r;
+	int i;
+
+	for (i = 0; i < SLOT_REC_LEN / 4; i++) {
+		if (p[i] != 0xffffffff)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Find the current record, and the append point after the last entry
+ */
+static int slot_load(void)
+{
+	struct slot_rec *buf, *r;
+	int found = 0;
+	ulong i;
+
+	if (!slot_flash)
+		slot_flash = spi_flash_probe(CONFIG_SPI_FLASH_BUS,
+				CONFIG_SPI_FLASH_CS, CONFIG_SF_DEFAULT_SPEED,
+				CONFIG_SF_DEFAULT_MODE);
+	if (!slot_flash) {
+		puts("slot: no SPI flash\n");
+		return -1;
+	}
+
+	buf = malloc(CONFIG_SYS_SLOT_REC_SIZE);
+	if (!buf) {
+		puts("slot: out of memory\n");
+		return -1;
+	}
+	if (spi_flash_read(slot_flash, CONFIG_SYS_SLOT_REC_OFFSET,
+			CONFIG_SYS_SLOT_REC_SIZE, buf)) {
+		puts("slot: record read failed\n");
+		free(buf);
+		return -1;
+	}
+
+	slot_next = SLOT_REC_END;
+	slot_clean = 0;
+	for (i = 0, r = buf; i < CONFIG_SYS_SLOT_REC_SIZE / SLOT_REC_LEN;
+	     i++, r++) {
+		if (slot_erased(r)) {
+			slot_next = CONFIG_SYS_SLOT_REC_OFFSET +
+				    i * SLOT_REC_LEN;
+			slot_clean = 1;
+			break;
+		}
+		/* An entry cut short by a power failure is skipped */
+		if (r->magic != SLOT_MAGIC || r->crc != SLOT_REC_CRC(r))
+			continue;
+		if (!found || r->seq > rec.seq) {
+			rec = *r;
+			found = 1;
+		}
+	}
+	free(buf);
+
+	if (!found)
+		slot_init();
+	if (rec.active >= SLOT_MAX)
+		rec.active = 0;
+	if (!rec.limit)
+		rec.limit = CONFIG_SYS_SLOT_TRIES;
+
+	return 0;
+}
+
+/*
+ * Append the record. The sector is erased when full; a power failure
+ * right then loses the record, which slot_init() then rebuilds.
+ */
+static int slot_save(void)
+{
+	rec.seq++;
+	rec.crc = SLOT_REC_CRC(&rec);
+
+	if (!slot_clean || slot_next + SLOT_REC_LEN > SLOT_REC_END) {
+		if (spi_flash_erase(slot_flash, CONFIG_SYS_SLOT_REC_OFFSET,
+				CONFIG_SYS_SLOT_REC_SIZE))
+			goto fail;
+		slot_next = CONFIG_SYS_SLOT_REC_OFFSET;
+	}
+
+	slot_clean = 0;
+	if (spi_flash_write(slot_flash, slot_next, SLOT_REC_LEN, &rec))
+		goto fail;
+	slot_next += SLOT_REC_LEN;
+	slot_clean = 1;
+	return 0;
+
+fail:
+	puts("slot: record write failed\n");
+	return -1;
+}
+
+/*
+ * Can slot "i" be tried; once all attempts are used up, only
+ * as a "last_resort", and then only if it ever booted
+ */
+static int slot_bootable(int i, int last_resort)
+{
+	struct slot_info *s = &rec.slot[i];
+
+	if (!slot_part[i].size || !s->size)
+		return 0;
+	return last_resort ? s->good : s->tries != 0;
+}
+
+/*
+ * Drop slot "i" until it is updated again
+ */
+static void slot_fail(int i, const char *why)
+{
+	printf("slot %c: %s\n", slot_name(i), why);
+	rec.slot[i].tries = 0;
+	rec.slot[i].good = 0;
+	slot_save();
+}
+
+/*
+ * Boot slot "i". Only returns on failure.
+ */
+static void slot_try(int i)
+{
+	struct slot_info *s = &rec.slot[i];
+	image_header_t hdr;
+	char name[2];
+	ulong size;
+	int dirty = 0;
+
+	size = slot_read_header(i, &hdr);
+	bootstage_mark("slot_header");
+	if (!size) {
+		slot_fail(i, "bad image header");
+		return;
+	}
+
+	if (size != s->size || image_get_dcrc(&hdr) != s->dcrc) {
+		/* Written by something else than "slot update" */
+		slot_set(i, &hdr, 0);
+		dirty = 1;
+	}
+	if (rec.counting && s->tries) {
+		s->tries--;
+		dirty = 1;
+	}
+	if (rec.booting != i) {
+		rec.booting = i;
+		dirty = 1;
+	}
+	if (dirty)
+		slot_save();
+
+	printf("slot %c: %s image, %lu bytes @ 0x%lx, %u tries left\n",
+		slot_name(i), s->good ? "good" : "new", size,
+		slot_part[i].offset, s->tries);
+
+	if (spi_flash_read(slot_flash, slot_part[i].offset, size,
+			(void *)load_addr)) {
+		slot_fail(i, "read failed");
+		return;
+	}
+	bootstage_mark("sf_read");
+#ifdef CONFIG_IMGCACHE
+	imgcache_flash_read(load_addr, slot_part[i].offset, size);
+#endif
+
+	name[0] = slot_name(i);
+	name[1] = '\0';
+	setenv("slot", name);
+
+	run_command(CONFIG_SYS_SLOT_BOOTCMD, 0);
+
+	slot_fail(i, "boot failed");
+}
+
+static int slot_boot(void)
+{
+	int last_resort, n, i;
+
+	for (last_resort = 0; last_resort < 2; last_resort++) {
+		for (n = 0; n < SLOT_MAX; n++) {
+			i = (rec.active + n) % SLOT_MAX;
+			if (slot_bootable(i, last_resort))
+				slot_try(i);
+		}
+	}
+
+	puts("slot: no bootable slot\n");
+	return 1;
+}
+
+static int slot_update(int i, ulong addr)
+{
+	image_header_t *hdr = (image_header_t *)addr;
+
+	if (!image_check_magic(hdr) || !image_check_hcrc(hdr) ||
+	    image_get_image_size(hdr) > slot_part[i].size) {
+		printf("slot: no valid image at 0x%08lx\n", addr);
+		return 1;
+	}
+
+	slot_set(i, hdr, 0);
+	rec.active = i;
+	return slot_save() ? 1 : 0;
+}
+
+static int slot_good(int i)
+{
+	struct slot_info *s = &rec.slot[i];
+
+	if (!s->size) {
+		printf("slot %c: no image\n", slot_name(i));
+		return 1;
+	}
+	if (s->good && s->tries == rec.limit && rec.counting)
+		return 0;
+
+	s->good = 1;
+	s->tries = rec.limit;
+	rec.counting = 1;
+	return slot_save() ? 1 : 0;
+}
+
+static void slot_info(void)
+{
+	struct slot_info *s;
+	int i;
+
+	printf("Active slot: %c, last tried: %c\n", slot_name(rec.active),
+		rec.booting < SLOT_MAX ? slot_name(rec.booting) : '-');
+
+	for (i = 0; i < SLOT_MAX; i++) {
+		if (!slot_part[i].size)
+			continue;
+		s = &rec.slot[i];
+		printf("  %c @ 0x%08lx: ", slot_name(i), slot_part[i].offset);
+		if (!s->size) {
+			puts("empty\n");
+			continue;
+		}
+		printf("len 0x%08x dcrc 0x%08x time 0x%08x %s, "
+			"%u tries left\n", s->size, s->dcrc, s->version,
+			s->good ? "good" : "new", s->tries);
+	}
+	if (!rec.counting)
+		puts("Tries are not counted until a slot is marked good\n");
+}
+
+/*
+ * The slot partition at "offset" was rewritten: whatever became of the
+ * old image, the slot starts over as a new image with all attempts, or
+ * as empty if it holds no valid image header. The active slot is left
+ * alone.
+ */
+void slot_written(ulong offset)
+{
+	image_header_t hdr;
+	int i;
+
+	for (i = 0; i < SLOT_MAX; i++) {
+		if (slot_part[i].size && slot_part[i].offset == offset)
+			break;
+	}
+	if (i == SLOT_MAX || slot_load())
+		return;
+
+	if (slot_read_header(i, &hdr))
+		slot_set(i, &hdr, 0);
+	else
+		memset(&rec.slot[i], 0, sizeof(rec.slot[i]));
+	slot_save();
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int do_slot(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	const char *cmd = argc < 2 ? "info" : argv[1];
+	int i;
+
+	if (slot_load())
+		return 1;
+	i = rec.booting;
+
+	if (strcmp(cmd, "info") == 0) {
+		slot_info();
+		return 0;
+	}
+	if (strcmp(cmd, "boot") == 0)
+		return slot_boot();
+
+	if (argc > 2) {
+		i = slot_parse(argv[2]);
+		if (i < 0)
+			return 1;
+	}
+
+	if (strcmp(cmd, "update") == 0 && argc > 2)
+		return slot_update(i, argc > 3 ?
+			simple_strtoul(argv[3], NULL, 16) : load_addr);
+
+	if (strcmp(cmd, "good") == 0) {
+		if (i >= SLOT_MAX) {
+			puts("slot: no slot was booted\n");
+			return 1;
+		}
+		return slot_good(i);
+	}
+
+	if (strcmp(cmd, "active") == 0 && argc > 2) {
+		if (rec.active == i)
+			return 0;
+		rec.active = i;
+		return slot_save() ? 1 : 0;
+	}
+
+	cmd_usage(cmdtp);
+	return 1;
+}
+
+U_BOOT_CMD(
+	slot,	4,	0,	do_slot,
+	"A/B image slot manager",
+	"[info]  - show slots\n"
+	"slot boot - boot the active slot, falling back to the others\n"
+	"slot update slot [addr] - record the image at addr (default\n"
+	"    loadaddr), just written to slot, and make the slot active\n"
+	"slot good [slot] - mark slot (default: last tried) as booting fine\n"
+	"slot active slot - try slot first"
+);
@@ -161,7 +161,11 @@ source (ulong addr, const char *fit_uname)
 	*(cmd + len) = 0;
 
 #ifdef CONFIG_SYS_HUSH_PARSER /*?? */
+#ifdef CONFIG_SYS_HUSH_CACHE
+	rcode = parse_string_cached ("source", cmd, FLAG_PARSE_SEMICOLON);
+#else
 	rcode = parse_string_outer (cmd, FLAG_PARSE_SEMICOLON);
+#endif
 #else
 	{
 		char *line = cmd;
@@ -27,6 +27,7 @@
 
 #include <common.h>
 #include <command.h>
+#include <malloc.h>
 
 /*
  * Use puts() instead of printf() to avoid printf buffer overflow
@@ -132,11 +133,90 @@ cmd_tbl_t *find_cmd_tbl (const char *cmd, cmd_tbl_t *table, int table_len)
 	return NULL;	/* not found or ambiguous command */
 }
 
+#ifdef CONFIG_SYS_CMD_INDEX
+/*
+ * Index of the command table sorted by name, built on the first lookup.
+ * Commands with a given prefix are then next to each other, so both
+ * full names and abbreviations are found by binary search.
+ */
+static cmd_tbl_t **cmd_index;
+static int cmd_index_len;
+
+static int cmd_index_cmp (cmd_tbl_t *a, cmd_tbl_t *b)
+{
+	int r = strcmp (a->name, b->name);
+
+	/* Same name: the first in the table wins, as for the linear scan */
+	if (r == 0)
+		r = (a < b) ? -1 : (a > b);
+	return r;
+}
+
+static int cmd_index_build (void)
+{
+	int n = &__u_boot_cmd_end - &__u_boot_cmd_start;
+	int i, j;
+
+	cmd_index = malloc (n * sizeof(*cmd_index));
+	if (!cmd_index)
+		return -1;
+
+	/* Insertion sort: the table is small, and built only once */
+	for (i = 0; i < n; i++) {
+		cmd_tbl_t *cmdtp = &__u_boot_cmd_start + i;
+
+		for (j = i; j > 0 && cmd_index_cmp (cmd_index[j - 1], cmdtp) > 0; j--)
+			cmd_index[j] = cmd_index[j - 1];
+		cmd_index[j] = cmdtp;
+	}
+	cmd_index_len = n;
+	return 0;
+}
+
+cmd_tbl_t *find_cmd (const char *cmd)
+{
+	const char *p;
+	int len, lo, hi, mid;
+
+	if (!cmd_index && cmd_index_build () < 0) {
+		int n = &__u_boot_cmd_end - &__u_boot_cmd_start;
+		return find_cmd_tbl (cmd, &__u_boot_cmd_start, n);
+	}
+
+	/* Compare command name only until first dot, see find_cmd_tbl() */
+	len = ((p = strchr(cmd, '.')) == NULL) ? strlen (cmd) : (p - cmd);
+
+	/* First command not sorting before the prefix */
+	lo = 0;
+	hi = cmd_index_len;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (strncmp (cmd_index[mid]->name, cmd, len) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	if (lo == cmd_index_len || strncmp (cmd_index[lo]->name, cmd, len))
+		return NULL;		/* not found */
+
+	/* A full match sorts first among those with the prefix */
+	if (strlen (cmd_index[lo]->name) == len)
+		return cmd_index[lo];
+
+	if (lo + 1 < cmd_index_len &&
+	    strncmp (cmd_index[lo + 1]->name, cmd, len) == 0)
+		return NULL;		/* ambiguous command */
+
+	return cmd_index[lo];		/* exactly one match */
+}
+#else
 cmd_tbl_t *find_cmd (const char *cmd)
 {
 	int len = &__u_boot_cmd_end - &__u_boot_cmd_start;
 	return find_cmd_tbl(cmd, &__u_boot_cmd_start, len);
 }
+#endif /* CONFIG_SYS_CMD_INDEX */
 
 int cmd_usage(cmd_tbl_t *cmdtp)
 {
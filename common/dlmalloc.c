@@ -3175,6 +3175,41 @@ void malloc_stats()
 }
 #endif	/* 0 */
 
+#ifdef CONFIG_SYS_MALLOC_STATS
+/*
+  malloc_arena_info fills in arena usage for the "mallinfo" command,
+  walking the bins like malloc_update_mallinfo.
+*/
+
+void malloc_arena_info(struct malloc_arena_info *ai)
+{
+  int i;
+  mbinptr b;
+  mchunkptr p;
+  INTERNAL_SIZE_T sz;
+
+  ai->arena = sbrked_mem;
+  ai->max_arena = max_sbrked_mem;
+  ai->topsize = chunksize(top);
+  ai->free = ai->topsize;
+  ai->free_chunks = 0;
+  ai->largest = ai->topsize;
+
+  for (i = 1; i < NAV; ++i)
+  {
+    b = bin_at(i);
+    for (p = last(b); p != b; p = p->bk)
+    {
+      sz = chunksize(p);
+      ai->free += sz;
+      ai->free_chunks++;
+      if (sz > ai->largest)
+	ai->largest = sz;
+    }
+  }
+}
+#endif /* CONFIG_SYS_MALLOC_STATS */
+
 /*
   mallinfo returns a copy of updated current mallinfo.
 */
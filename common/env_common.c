@@ -220,6 +220,9 @@ void set_default_env(void)
 #endif
 	env_crc_update ();
 	gd->env_valid = 1;
+#ifdef CONFIG_ENV_HASH
+	env_hash_invalidate();
+#endif
 }
 
 void env_relocate (void)
@@ -263,6 +266,9 @@ void env_relocate (void)
 		env_relocate_spec ();
 	}
 	gd->env_addr = (ulong)&(env_ptr->data);
+#ifdef CONFIG_ENV_HASH
+	env_hash_invalidate();
+#endif
 
 #ifdef CONFIG_AMIGAONEG3SE
 	disable_nvram();
@@ -29,6 +29,9 @@
 #include <environment.h>
 #include <malloc.h>
 #include <spi_flash.h>
+#ifdef CONFIG_ENV_SF_LOG
+#include <env_log.h>
+#endif
 
 #ifndef CONFIG_ENV_SPI_BUS
 # define CONFIG_ENV_SPI_BUS	0
@@ -58,6 +61,191 @@ uchar env_get_char_spec(int index)
 	return *((uchar *)(gd->env_addr + index));
 }
 
+#ifdef CONFIG_ENV_SF_LOG
+/*
+ * Log-structured environment.
+ *
+ * Each saveenv appends a snapshot of the used part of the environment,
+ * as a CRC protected record, to the erased space of the log area. The
+ * area is only erased, a sector at a time, when the current sector is
+ * full. With two or more sectors the previous snapshot survives that
+ * erase; with a single sector a power failure right after the erase
+ * falls back to the default environment, as a failed saveenv always did.
+ *
+ * Loading picks the valid record with the highest sequence number,
+ * falling back to older records, then to an environment in the original
+ * format at CONFIG_ENV_OFFSET, then to the default environment. A record
+ * torn by a power failure is skipped, and the next one goes after it.
+ * An environment in the original format is written back as a record
+ * once, so that later boots don't scan over it. See <env_log.h> for
+ * the record layout.
+ */
+#if CONFIG_ENV_SF_LOG_SIZE % CONFIG_ENV_SECT_SIZE
+# error "CONFIG_ENV_SF_LOG_SIZE must be a multiple of CONFIG_ENV_SECT_SIZE"
+#endif
+
+static u32 env_log_seq;		/* Sequence number of the last record	*/
+static u32 env_log_next;	/* Where the next record goes		*/
+static int env_log_clean;	/* env_log_next is in erased space	*/
+
+/*
+ * Length of the used part of the environment, up to and including
+ * the terminating double NUL
+ */
+static u32 env_log_data_len(void)
+{
+	u32 i;
+
+	for (i = 0; i + 1 < ENV_SIZE; i++) {
+		if (env_ptr->data[i] == '\0' && env_ptr->data[i + 1] == '\0')
+			return i + 2;
+	}
+	return ENV_SIZE;
+}
+
+/*
+ * Find the valid header with the highest sequence number below "limit".
+ * Also finds the append point, after the last record of the newest
+ * sector.
+ */
+static int env_log_scan(u32 limit, u32 *best_off, struct env_log_hdr *best)
+{
+	struct env_log_hdr h;
+	int found = 0;
+	int s;
+
+	env_log_next = CONFIG_ENV_OFFSET;
+	env_log_clean = 0;
+
+	for (s = 0; s < ENV_LOG_SECTORS; s++) {
+		u32 start = CONFIG_ENV_OFFSET + s * CONFIG_ENV_SECT_SIZE;
+		u32 end = start + CONFIG_ENV_SECT_SIZE;
+		u32 off = start;
+		u32 last = 0;
+		int clean = 0;
+		int any = 0;
+
+		while (off + sizeof(h) <= end) {
+			if (spi_flash_read(env_flash, off, sizeof(h), &h))
+				return found;
+			if (h.magic == 0xffffffff) {
+				clean = 1;
+				break;
+			}
+			/*
+			 * A header cut short by a power failure. Nothing was
+			 * written after it, so step over it to the erased
+			 * space rather than give up on the sector, which the
+			 * next saveenv would then erase.
+			 */
+			if (h.magic != ENV_LOG_MAGIC || h.hcrc != ENV_LOG_HCRC(&h) ||
+			    h.len > ENV_SIZE || off + ENV_LOG_REC_LEN(h.len) > end) {
+				off += ENV_LOG_ALIGN;
+				continue;
+			}
+
+			if (h.seq < limit && (!found || h.seq > best->seq)) {
+				*best = h;
+				*best_off = off;
+				found = 1;
+			}
+			last = h.seq;
+			any = 1;
+			off += ENV_LOG_REC_LEN(h.len);
+		}
+
+		if (any && last >= env_log_seq) {
+			env_log_seq = last;
+			env_log_next = off;
+			env_log_clean = clean;
+		}
+	}
+
+	return found;
+}
+
+static int env_log_load(void)
+{
+	struct env_log_hdr h;
+	u32 limit = ~0;
+	u32 off;
+
+	env_log_seq = 0;
+
+	while (env_log_scan(limit, &off, &h)) {
+		if (!spi_flash_read(env_flash, off + sizeof(h), h.len,
+				env_ptr->data) &&
+		    crc32(0, env_ptr->data, h.len) == h.dcrc) {
+			memset(env_ptr->data + h.len, 0, ENV_SIZE - h.len);
+			env_ptr->crc = crc32(0, env_ptr->data, ENV_SIZE);
+			return 0;
+		}
+		limit = h.seq;
+	}
+
+	return 1;
+}
+
+int saveenv(void)
+{
+	struct env_log_hdr h;
+	u32 sector, end;
+	int ret;
+
+	if (!env_flash) {
+		puts("Environment SPI flash not initialized\n");
+		return 1;
+	}
+
+	h.magic = ENV_LOG_MAGIC;
+	h.seq = env_log_seq + 1;
+	h.len = env_log_data_len();
+	h.dcrc = crc32(0, env_ptr->data, h.len);
+	h.hcrc = ENV_LOG_HCRC(&h);
+
+	if (ENV_LOG_REC_LEN(h.len) > CONFIG_ENV_SECT_SIZE) {
+		puts("Environment too large for the log\n");
+		return 1;
+	}
+
+	sector = (env_log_next - CONFIG_ENV_OFFSET) / CONFIG_ENV_SECT_SIZE;
+	end = CONFIG_ENV_OFFSET + (sector + 1) * CONFIG_ENV_SECT_SIZE;
+
+	if (!env_log_clean || env_log_next + ENV_LOG_REC_LEN(h.len) > end) {
+		if (env_log_clean || env_log_next != CONFIG_ENV_OFFSET ||
+		    env_log_seq != 0)
+			sector = (sector + 1) % ENV_LOG_SECTORS;
+		env_log_next = CONFIG_ENV_OFFSET + sector * CONFIG_ENV_SECT_SIZE;
+
+		puts("Erasing SPI flash...");
+		ret = spi_flash_erase(env_flash, env_log_next,
+				CONFIG_ENV_SECT_SIZE);
+		if (ret)
+			return ret;
+		env_log_clean = 1;
+	}
+
+	/*
+	 * Header first: a record cut short by a power failure then
+	 * fails its data CRC, and its space is not reused
+	 */
+	puts("Writing to SPI flash...");
+	env_log_clean = 0;
+	ret = spi_flash_write(env_flash, env_log_next, sizeof(h), &h);
+	if (!ret)
+		ret = spi_flash_write(env_flash, env_log_next + sizeof(h),
+				h.len, env_ptr->data);
+	if (ret)
+		return ret;
+
+	env_log_seq = h.seq;
+	env_log_next += ENV_LOG_REC_LEN(h.len);
+	env_log_clean = 1;
+
+	puts("done\n");
+	return 0;
+}
+#else
 int saveenv(void)
 {
 	u32 saved_size, saved_offset;
@@ -114,6 +302,7 @@ int saveenv(void)
 		free(saved_buffer);
 	return ret;
 }
+#endif /* CONFIG_ENV_SF_LOG */
 
 void env_relocate_spec(void)
 {
@@ -124,6 +313,13 @@ void env_relocate_spec(void)
 	if (!env_flash)
 		goto err_probe;
 
+#ifdef CONFIG_ENV_SF_LOG
+	if (!env_log_load()) {
+		gd->env_valid = 1;
+		return;
+	}
+#endif
+
 	ret = spi_flash_read(env_flash, CONFIG_ENV_OFFSET, CONFIG_ENV_SIZE, env_ptr);
 	if (ret)
 		goto err_read;
@@ -133,6 +329,10 @@ void env_relocate_spec(void)
 
 	gd->env_valid = 1;
 
+#ifdef CONFIG_ENV_SF_LOG
+	puts("Converting environment to the log format: ");
+	saveenv();
+#endif
 	return;
 
 err_read:
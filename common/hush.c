@@ -1597,6 +1597,8 @@ static int run_pipe_real(struct pipe *pi)
 #endif
 		return rcode;
 	} else if (pi->num_progs == 1 && pi->progs[0].argv != NULL) {
+		int sp = child->sp;	/* Left alone, for cached lists */
+
 		for (i=0; is_assignment(child->argv[i]); i++) { /* nothing */ }
 		if (i!=0 && child->argv[i]==NULL) {
 			/* assignments, but no command: set the local environment */
@@ -1635,11 +1637,11 @@ static int run_pipe_real(struct pipe *pi)
 			set_local_var(p, 0);
 #endif
 			if (p != child->argv[i]) {
-				child->sp--;
+				sp--;
 				free(p);
 			}
 		}
-		if (child->sp) {
+		if (sp) {
 			char * str = NULL;
 
 			str = make_string((child->argv + i));
@@ -3252,6 +3254,217 @@ int parse_string_outer(char *s, int flag)
 #endif
 }
 
+#ifdef CONFIG_SYS_HUSH_CACHE
+/*
+ * Parse tree cache for scripts run again and again: "run", "source"
+ * and bootcmd. Entries are keyed by a name (the variable) and the
+ * CRC of the script text; the lists are run without being freed.
+ *
+ * Lists with a "for" loop are not cached, as running one changes it.
+ * Neither are scripts parsed with a custom IFS.
+ */
+#ifndef CONFIG_SYS_HUSH_CACHE_SIZE
+# define CONFIG_SYS_HUSH_CACHE_SIZE	8
+#endif
+
+struct hush_cache_seg {
+	struct pipe		*list;
+	struct hush_cache_seg	*next;
+};
+
+struct hush_cache {
+	char			*name;
+	uint			crc;
+	int			len;
+	int			flag;
+	struct hush_cache_seg	*segs;
+	int			busy;	/* Being run, maybe nested	*/
+	int			stale;	/* Free when no longer busy	*/
+	ulong			used;	/* For LRU replacement		*/
+};
+
+static struct hush_cache hush_cache[CONFIG_SYS_HUSH_CACHE_SIZE];
+static ulong hush_cache_clock;
+
+static void hush_cache_free_segs(struct hush_cache_seg *seg)
+{
+	struct hush_cache_seg *next;
+
+	for (; seg; seg = next) {
+		next = seg->next;
+		free_pipe_list(seg->list, 0);
+		free(seg);
+	}
+}
+
+static void hush_cache_drop(struct hush_cache *c)
+{
+	if (c->busy) {
+		c->stale = 1;
+		return;
+	}
+	hush_cache_free_segs(c->segs);
+	free(c->name);
+	memset(c, 0, sizeof(*c));
+}
+
+void hush_cache_forget(const char *name)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_SYS_HUSH_CACHE_SIZE; i++) {
+		if (hush_cache[i].name && strcmp(hush_cache[i].name, name) == 0)
+			hush_cache_drop(&hush_cache[i]);
+	}
+}
+
+static int hush_cacheable(struct pipe *pi)
+{
+	int i;
+
+	for (; pi; pi = pi->next) {
+		if (pi->r_mode == RES_FOR)
+			return 0;
+		for (i = 0; i < pi->num_progs; i++) {
+			if (pi->progs[i].group &&
+			    !hush_cacheable(pi->progs[i].group))
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/*
+ * Parse all of "s" the way parse_stream_outer() would, without running
+ * anything. Returns NULL on anything but a clean parse.
+ */
+static struct hush_cache_seg *hush_cache_parse(char *s, int flag)
+{
+	struct hush_cache_seg *head = NULL, **tail = &head;
+	struct hush_cache_seg *seg;
+	struct in_str input;
+	struct p_context ctx;
+	o_string temp = NULL_O_STRING;
+	int rcode;
+
+	setup_string_in_str(&input, s);
+	do {
+		ctx.type = flag;
+		initialize_context(&ctx);
+		update_ifs_map();
+		if (!(flag & FLAG_PARSE_SEMICOLON) || (flag & FLAG_REPARSING))
+			mapset((uchar *)";$&|", 0);
+		input.promptmode = 1;
+		rcode = parse_stream(&temp, &ctx, &input, '\n');
+		if (rcode == 1 || ctx.old_flag != 0) {
+			if (ctx.old_flag != 0)
+				free(ctx.stack);
+			free_pipe_list(ctx.list_head, 0);
+			b_free(&temp);
+			hush_cache_free_segs(head);
+			return NULL;
+		}
+		done_word(&temp, &ctx);
+		done_pipe(&ctx, PIPE_SEQ);
+		b_free(&temp);
+
+		seg = xmalloc(sizeof(*seg));
+		seg->list = ctx.list_head;
+		seg->next = NULL;
+		*tail = seg;
+		tail = &seg->next;
+
+		if (!hush_cacheable(seg->list)) {
+			hush_cache_free_segs(head);
+			return NULL;
+		}
+	} while (rcode != -1 && !(flag & FLAG_EXIT_FROM_LOOP));
+
+	return head;
+}
+
+static int hush_cache_run(struct hush_cache *c)
+{
+	struct hush_cache_seg *seg;
+	int code = 0;
+
+	c->busy++;
+	for (seg = c->segs; seg; seg = seg->next) {
+		code = run_list_real(seg->list);
+		if (code == -2) {	/* exit */
+			code = 0;
+			break;
+		}
+		if (code == -1)
+			flag_repeat = 0;
+	}
+	if (--c->busy == 0 && c->stale)
+		hush_cache_drop(c);
+
+	return (code != 0) ? 1 : 0;
+}
+
+/*
+ * Same as parse_string_outer(), but runs a cached parse of "s"
+ * if "name" was last run with the same text.
+ */
+int parse_string_cached(const char *name, char *s, int flag)
+{
+	struct hush_cache *c, *victim = NULL;
+	struct hush_cache_seg *segs;
+	char *p, *q;
+	uint crc;
+	int len;
+	int i;
+
+	if (!s || !*s)
+		return 1;
+	if (getenv("IFS"))
+		return parse_string_outer(s, flag);
+
+	len = strlen(s);
+	crc = crc32(0, (uchar *)s, len);
+
+	for (i = 0; i < CONFIG_SYS_HUSH_CACHE_SIZE; i++) {
+		c = &hush_cache[i];
+		if (c->name && !c->stale && c->crc == crc && c->len == len &&
+		    c->flag == flag && strcmp(c->name, name) == 0) {
+			c->used = ++hush_cache_clock;
+			return hush_cache_run(c);
+		}
+		if (!c->busy && (!victim || c->used < victim->used))
+			victim = c;
+	}
+
+	/* Everything in use by nested runs: do without */
+	if (!victim)
+		return parse_string_outer(s, flag);
+
+	/* Newline terminated, exactly as by parse_string_outer() */
+	p = xmalloc(len + 2);
+	strcpy(p, s);
+	q = strchr(s, '\n');
+	if (!q || q[1])
+		strcat(p, "\n");
+	segs = hush_cache_parse(p, flag);
+	free(p);
+
+	if (!segs)
+		return parse_string_outer(s, flag);
+
+	hush_cache_drop(victim);
+	victim->name = xmalloc(strlen(name) + 1);
+	strcpy(victim->name, name);
+	victim->crc = crc;
+	victim->len = len;
+	victim->flag = flag;
+	victim->segs = segs;
+	victim->used = ++hush_cache_clock;
+
+	return hush_cache_run(victim);
+}
+#endif /* CONFIG_SYS_HUSH_CACHE */
+
 #ifndef __U_BOOT__
 static int parse_file_outer(FILE *f)
 #else
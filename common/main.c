@@ -39,6 +39,7 @@
 #endif
 
 #include <post.h>
+#include <bootstage.h>
 
 #if defined(CONFIG_SILENT_CONSOLE) || defined(CONFIG_POST) || defined(CONFIG_CMDLINE_EDITING)
 DECLARE_GLOBAL_DATA_PTR;
@@ -398,6 +399,7 @@ void main_loop (void)
 	debug ("### main_loop: bootcmd=\"%s\"\n", s ? s : "<UNDEFINED>");
 
 	if (bootdelay >= 0 && s && !abortboot (bootdelay)) {
+		bootstage_mark ("bootdelay");
 # ifdef CONFIG_AUTOBOOT_KEYED
 		int prev = disable_ctrlc(1);	/* disable Control C checking */
 # endif
@@ -1437,10 +1439,16 @@ int do_run (cmd_tbl_t * cmdtp, int flag, int argc, char *argv[])
 #ifndef CONFIG_SYS_HUSH_PARSER
 		if (run_command (arg, flag) == -1)
 			return 1;
+#else
+#ifdef CONFIG_SYS_HUSH_CACHE
+		if (parse_string_cached(argv[i], arg,
+		    FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP) != 0)
+			return 1;
 #else
 		if (parse_string_outer(arg,
 		    FLAG_PARSE_SEMICOLON | FLAG_EXIT_FROM_LOOP) != 0)
 			return 1;
+#endif
 #endif
 	}
 	return 0;
@@ -87,6 +87,8 @@ static struct
   int len, mode, total_retries;
   int total_SOH, total_STX, total_CAN;
   bool crc_mode, at_eof, tx_ack;
+  bool stream;			/* Y-modem-G: no per-block handshake */
+  char filename[64];		/* From the Y-modem header */
 #ifdef USE_YMODEM_LENGTH
   unsigned long file_length, read_length;
 #endif
@@ -331,6 +333,15 @@ zm_dump (int line)
 #define ZM_DEBUG(x)
 #endif
 
+/* What to send to ask for (more) blocks */
+static char
+xyzModem_want (void)
+{
+  if (xyz.stream)
+    return 'G';
+  return xyz.crc_mode ? 'C' : NAK;
+}
+
 /* Wait for the line to go idle */
 static void
 xyzModem_flush (void)
@@ -551,7 +562,13 @@ xyzModem_stream_open (connection_info_t * info, int *err)
   xyz.crc_mode = true;
   xyz.at_eof = false;
   xyz.tx_ack = false;
-  xyz.mode = info->mode;
+  /*
+   * Y-modem-G is Y-modem with the receiver asking for 'G' rather than 'C';
+   * the sender then streams blocks without waiting for ACKs
+   */
+  xyz.stream = (info->mode == xyzModem_ymodem_g);
+  xyz.mode = xyz.stream ? xyzModem_ymodem : info->mode;
+  info->filename = NULL;
   xyz.total_retries = 0;
   xyz.total_SOH = 0;
   xyz.total_STX = 0;
@@ -561,7 +578,7 @@ xyzModem_stream_open (connection_info_t * info, int *err)
   xyz.file_length = 0;
 #endif
 
-  CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
+  CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_want ());
 
   if (xyz.mode == xyzModem_xmodem)
     {
@@ -578,6 +595,9 @@ xyzModem_stream_open (connection_info_t * info, int *err)
 	  /* Y-modem file information header */
 	  if (xyz.blk == 0)
 	    {
+	      strncpy (xyz.filename, (char *) xyz.bufp, sizeof (xyz.filename) - 1);
+	      xyz.filename[sizeof (xyz.filename) - 1] = '\0';
+	      info->filename = xyz.filename;
 #ifdef USE_YMODEM_LENGTH
 	      /* skip filename */
 	      while (*xyz.bufp++);
@@ -585,7 +605,10 @@ xyzModem_stream_open (connection_info_t * info, int *err)
 	      parse_num ((char *) xyz.bufp, &xyz.file_length, NULL, " ");
 #endif
 	      /* The rest of the file name data block quietly discarded */
-	      xyz.tx_ack = true;
+	      if (xyz.stream)
+		CYGACC_COMM_IF_PUTC (*xyz.__chan, 'G');
+	      else
+		xyz.tx_ack = true;
 	    }
 	  xyz.next_blk = 1;
 	  xyz.len = 0;
@@ -593,10 +616,11 @@ xyzModem_stream_open (connection_info_t * info, int *err)
 	}
       else if (stat == xyzModem_timeout)
 	{
-	  if (--crc_retries <= 0)
+	  /* Y-modem-G has no checksum mode to fall back to */
+	  if (--crc_retries <= 0 && !xyz.stream)
 	    xyz.crc_mode = false;
 	  CYGACC_CALL_IF_DELAY_US (5 * 100000);	/* Extra delay for startup */
-	  CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
+	  CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_want ());
 	  xyz.total_retries++;
 	  ZM_DEBUG (zm_dprintf ("NAK (%d)\n", __LINE__));
 	}
@@ -631,7 +655,7 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		{
 		  if (xyz.blk == xyz.next_blk)
 		    {
-		      xyz.tx_ack = true;
+		      xyz.tx_ack = !xyz.stream;
 		      ZM_DEBUG (zm_dprintf
 				("ACK block %d (%d)\n", xyz.blk, __LINE__));
 		      xyz.next_blk = (xyz.next_blk + 1) & 0xFF;
@@ -675,7 +699,7 @@ xyzModem_stream_read (char *buf, int size, int *err)
 #endif
 		      break;
 		    }
-		  else if (xyz.blk == ((xyz.next_blk - 1) & 0xFF))
+		  else if (xyz.blk == ((xyz.next_blk - 1) & 0xFF) && !xyz.stream)
 		    {
 		      /* Just re-ACK this so sender will get on with it */
 		      CYGACC_COMM_IF_PUTC (*xyz.__chan, ACK);
@@ -696,8 +720,7 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		  ZM_DEBUG (zm_dprintf ("ACK (%d)\n", __LINE__));
 		  if (xyz.mode == xyzModem_ymodem)
 		    {
-		      CYGACC_COMM_IF_PUTC (*xyz.__chan,
-					   (xyz.crc_mode ? 'C' : NAK));
+		      CYGACC_COMM_IF_PUTC (*xyz.__chan, xyzModem_want ());
 		      xyz.total_retries++;
 		      ZM_DEBUG (zm_dprintf ("Reading Final Header\n"));
 		      stat = xyzModem_get_hdr ();
@@ -707,12 +730,21 @@ xyzModem_stream_read (char *buf, int size, int *err)
 		  xyz.at_eof = true;
 		  break;
 		}
+	      /* A streaming sender cannot resend: give up on any error */
+	      if (xyz.stream)
+		{
+		  break;
+		}
 	      CYGACC_COMM_IF_PUTC (*xyz.__chan, (xyz.crc_mode ? 'C' : NAK));
 	      xyz.total_retries++;
 	      ZM_DEBUG (zm_dprintf ("NAK (%d)\n", __LINE__));
 	    }
 	  if (stat < 0)
 	    {
+	      if (xyz.stream && stat != xyzModem_cancel)
+		{
+		  xyzModem_stream_terminate (true, 0);
+		}
 	      *err = stat;
 	      xyz.len = -1;
 	      return total;
@@ -740,7 +772,8 @@ xyzModem_stream_close (int *err)
 {
   diag_printf
     ("xyzModem - %s mode, %d(SOH)/%d(STX)/%d(CAN) packets, %d retries\n",
-     xyz.crc_mode ? "CRC" : "Cksum", xyz.total_SOH, xyz.total_STX,
+     xyz.stream ? "Streaming CRC" : xyz.crc_mode ? "CRC" : "Cksum",
+     xyz.total_SOH, xyz.total_STX,
      xyz.total_CAN, xyz.total_retries);
   ZM_DEBUG (zm_flush ());
 }
@@ -90,6 +90,7 @@ int do_cptf(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 	ulong size = SOC_RAM_BUFFER_SIZE;
 	int do_reset = 0;
 	int ret = 0;
+	ulong start;
 
 	/*
 	 * Check that at least the destination is specified
@@ -119,12 +120,19 @@ int do_cptf(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 	/*
 	 * Copy the buffer to the destination.
 	 */
+	start = get_timer(0);
 	if ((ret = envm_write_and_reset(dst, src, size, do_reset)) <= 0) {
 		printf("%s: envm_write_and_reset failed: %d\n",
 						(char *) argv[0], ret);
 		goto Done;
 	}
 
+#if defined(CONFIG_SYS_M2S)
+	printf("%s: %u pages written, %u unchanged, %lu ms\n",
+		(char *) argv[0], envm_write_stats.written,
+		envm_write_stats.skipped, get_timer(start));
+#endif
+
 	Done:
 	return ret;
 }
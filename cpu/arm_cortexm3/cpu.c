@@ -97,6 +97,17 @@ int arch_cpu_init(void)
  */
 int cleanup_before_linux(void)
 {
+	/*
+	 * Enter the kernel with IRQs masked, and with every IRQ that
+	 * U-Boot has enabled in the NVIC disabled again, as it expects
+	 */
+	disable_interrupts();
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	cortex_m3_irq_enable(CONFIG_SYS_NS16550_RX_IRQ, 0);
+#endif
+#if defined(CONFIG_SYS_M2S) && defined(CONFIG_CMD_M2S_MSS)
+	cortex_m3_irq_enable(M2S_COMBLK_IRQ, 0);
+#endif
 	return 0;
 }
 
@@ -165,6 +176,22 @@ u8 cortex_m3_irq_vec_get(void)
 	return CM3_SCB_REGS->icsr & CM3_ICSR_VECTACT_MSK;
 }
 
+/*
+ * Enable or disable an external IRQ in the NVIC.
+ * Any pending request is dropped when the IRQ is disabled.
+ */
+void cortex_m3_irq_enable(int irq, int enable)
+{
+	u32 bit = 1 << (irq & 31);
+
+	if (enable) {
+		CM3_NVIC_REGS->iser[irq >> 5] = bit;
+	} else {
+		CM3_NVIC_REGS->icer[irq >> 5] = bit;
+		CM3_NVIC_REGS->icpr[irq >> 5] = bit;
+	}
+}
+
 /*
  * Set a custom MPU region
  *
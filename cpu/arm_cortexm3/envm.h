@@ -56,6 +56,18 @@ unsigned int
 #endif
 	envm_write(unsigned int offset, void * buf, unsigned int size);
 
+#if defined(CONFIG_SYS_M2S)
+/*
+ * Page counts of the last envm_write()
+ */
+struct envm_write_stats {
+	unsigned int	written;	/* Pages programmed		*/
+	unsigned int	skipped;	/* Pages already up to date	*/
+};
+
+extern struct envm_write_stats envm_write_stats;
+#endif /* CONFIG_SYS_M2S */
+
 #if defined(CONFIG_SYS_STM32)
 /*
  * Enable instruction cache, prefetch and set the Flash wait latency
@@ -0,0 +1,325 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+
+/*
+ * SmartFusion2 MSS DDR bridge buffer control.
+ *
+ * The DDR bridge can buffer (and combine) M3 writes and prefetch M3
+ * reads of the DDR. dram_init() does not set it up, since the buffers
+ * were once suspected of returning stale data. "ddrb on" only enables
+ * them once a coherency self-test has passed with the new setting, and
+ * falls back to unbuffered DDR access otherwise. With CONFIG_M2S_PDMA,
+ * the test also has the PDMA copy data between the M3's reads and
+ * writes.
+ *
+ * The self-test overwrites CONFIG_SYS_M2S_DDRB_TEST_LEN bytes of DDR
+ * scratch area, given on the command line or by default at
+ * CONFIG_SYS_M2S_DDRB_TEST_BASE. Do not run it over a loaded image.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <asm/arch/m2s.h>
+#ifdef CONFIG_M2S_PDMA
+#include <asm/arch/pdma.h>
+#endif
+
+/*
+ * DDRB_CR value "ddrb on" and "ddrb test" use when none is given and
+ * the buffers are off: the reset value of the register, with all the
+ * bridge buffers enabled, which dram_init() clears.
+ */
+#ifndef CONFIG_SYS_M2S_DDRB_CR
+#define CONFIG_SYS_M2S_DDRB_CR		0x00FF0000
+#endif
+
+/*
+ * Default scratch area for the self-test: the top 64 KB of the memory
+ * U-Boot leaves to images, right below the malloc() pool.
+ */
+#ifndef CONFIG_SYS_M2S_DDRB_TEST_LEN
+#define CONFIG_SYS_M2S_DDRB_TEST_LEN	(64 * 1024)
+#endif
+#ifndef CONFIG_SYS_M2S_DDRB_TEST_BASE
+#define CONFIG_SYS_M2S_DDRB_TEST_BASE	\
+	(CONFIG_SYS_MEMTEST_END - CONFIG_SYS_M2S_DDRB_TEST_LEN)
+#endif
+
+/*
+ * Time to let the bridge drain its write buffers after they were
+ * last written, in microseconds. The bridge flushes a buffer when
+ * DDRB_BUF_TIMER_CR (10 bits of MSS clocks) expires, or when it is
+ * disabled.
+ */
+#define DDRB_FLUSH_US		100
+
+/*
+ * Longest time the PDMA may take to copy half of the scratch area
+ */
+#define DDRB_DMA_TOUT_MS	100
+
+static u32 ddrb_pattern(ulong i, u32 seed)
+{
+	return (i * 0x9E3779B1) ^ seed;
+}
+
+static int ddrb_check(const char *step, volatile u32 *p, u32 val, u32 exp)
+{
+	if (val == exp)
+		return 0;
+
+	printf("ddrb: %s failed at 0x%08lx: read 0x%08x, expected 0x%08x\n",
+		step, (ulong)p, val, exp);
+	return -1;
+}
+
+#ifdef CONFIG_M2S_PDMA
+/*
+ * Bus masters other than the M3 go through the bridge as well. The SPI
+ * driver programs its PDMA channels without flushing the bridge, so the
+ * bridge itself has to keep the M3 and the PDMA coherent: the PDMA must
+ * read what the M3 has just written to "src", and the M3 must read what
+ * the PDMA has written over "dst" lines that are already in the read
+ * buffers.
+ */
+static int ddrb_test_dma(u32 cr, volatile u32 *dst, volatile u32 *src,
+			 ulong n)
+{
+	volatile struct mss_pdma_chan *ch;
+	u32 ctrl = PDMA_CONTROL_SRC_ADDR_INC_4 | PDMA_CONTROL_DST_ADDR_INC_4 |
+		   PDMA_CONTROL_XFER_SIZE_4B;
+	ulong i, start;
+	u32 v, exp;
+	int chan, ret = 0;
+
+	chan = m2s_pdma_request(-1);
+	if (chan < 0) {
+		puts("ddrb: no free PDMA channel\n");
+		return -1;
+	}
+	ch = &MSS_PDMA->chan[chan];
+
+	/* Pull "dst" into the read buffers, leave "src" in the write ones */
+	M2S_SYSREG->ddrb_cr = cr;
+	for (i = 0; i < n; i++) {
+		(void)dst[i];
+		src[i] = ddrb_pattern(i, 0xC3C3C3C3);
+	}
+
+	m2s_pdma_setup(chan, ctrl);
+	ch->buf[0].src = (u32)src;
+	ch->buf[0].dst = (u32)dst;
+	ch->buf[0].cnt = n;
+
+	start = get_timer(0);
+	while (!(ch->status & 1)) {
+		if (get_timer(start) > DDRB_DMA_TOUT_MS) {
+			puts("ddrb: PDMA copy timed out\n");
+			ret = -1;
+			break;
+		}
+	}
+	ch->control = ctrl | PDMA_CONTROL_CLR_A;
+	m2s_pdma_free(chan);
+
+	for (i = 0; i < n && !ret; i++) {
+		exp = ddrb_pattern(i, 0xC3C3C3C3);
+		v = dst[i];
+		if (v == exp)
+			continue;
+		/*
+		 * Disabling the bridge drops its buffers, so a second read
+		 * tells a stale M3 read from a stale PDMA read
+		 */
+		M2S_SYSREG->ddrb_cr = 0;
+		ret = ddrb_check(dst[i] == exp ? "M3 read after PDMA write" :
+				 "PDMA read after M3 write", &dst[i], v, exp);
+	}
+
+	M2S_SYSREG->ddrb_cr = 0;
+	return ret;
+}
+#endif
+
+/*
+ * Run the coherency self-test with the DDR bridge set to "cr", on the
+ * scratch area at "base". The bridge is left with buffers disabled on
+ * return.
+ */
+static int ddrb_test(u32 cr, ulong base)
+{
+	volatile u32 *p = (volatile u32 *)base;
+	volatile u16 *h = (volatile u16 *)p;
+	volatile u8 *b = (volatile u8 *)p;
+	ulong n = CONFIG_SYS_M2S_DDRB_TEST_LEN / 4;
+	ulong i;
+	u32 v;
+	int ret = 0;
+
+	/*
+	 * Known contents, written with the buffers off
+	 */
+	M2S_SYSREG->ddrb_cr = 0;
+	for (i = 0; i < n; i++)
+		p[i] = ddrb_pattern(i, 0);
+
+	M2S_SYSREG->ddrb_cr = cr;
+
+	/*
+	 * Reads through cold buffers see what was written unbuffered
+	 */
+	for (i = 0; i < n && !ret; i++)
+		ret = ddrb_check("cold read", &p[i], p[i],
+				 ddrb_pattern(i, 0));
+
+	/*
+	 * A write to a line held in the read buffer must not leave
+	 * the old data there: read, write, read back each word
+	 */
+	for (i = 0; i < n && !ret; i++) {
+		v = p[i];
+		p[i] = ~v;
+		ret = ddrb_check("read-write-read", &p[i], p[i], ~v);
+	}
+
+	/*
+	 * Byte and halfword writes combine with word writes in the
+	 * write buffer, and must be visible at once
+	 */
+	for (i = 0; i < n && !ret; i++) {
+		v = ddrb_pattern(i, 0x5A5A5A5A);
+		switch (i & 3) {
+		case 0:
+			p[i] = v;
+			break;
+		case 1:
+			h[i * 2] = v;
+			h[i * 2 + 1] = v >> 16;
+			break;
+		default:
+			b[i * 4] = v;
+			b[i * 4 + 1] = v >> 8;
+			b[i * 4 + 2] = v >> 16;
+			b[i * 4 + 3] = v >> 24;
+			break;
+		}
+		ret = ddrb_check("partial write", &p[i], p[i], v);
+	}
+
+	/*
+	 * Finally, the buffered writes must have reached the DDR:
+	 * drain the bridge and read back unbuffered
+	 */
+	udelay(DDRB_FLUSH_US);
+	M2S_SYSREG->ddrb_cr = 0;
+	for (i = 0; i < n && !ret; i++)
+		ret = ddrb_check("write-back", &p[i], p[i],
+			ddrb_pattern(i, 0x5A5A5A5A));
+
+#ifdef CONFIG_M2S_PDMA
+	if (!ret)
+		ret = ddrb_test_dma(cr, p, p + n / 2, n / 2);
+#endif
+
+	return ret;
+}
+
+/*
+ * Enable the DDR bridge buffers as per "cr", if this setting passes
+ * the self-test on the scratch area at "base". Returns 0 on success,
+ * with the buffers enabled.
+ */
+static int ddrb_enable(u32 cr, ulong base)
+{
+	if (ddrb_test(cr, base)) {
+		puts("ddrb: self-test failed, DDR bridge buffers disabled\n");
+		return -1;
+	}
+
+	M2S_SYSREG->ddrb_cr = cr;
+	return 0;
+}
+
+static int do_ddrb(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	ulong base = CONFIG_SYS_M2S_DDRB_TEST_BASE;
+	u32 cr;
+
+	if (argc < 2) {
+		printf("DDRB_CR: 0x%08x, DDRB_BUF_TIMER_CR: 0x%08x\n",
+			M2S_SYSREG->ddrb_cr, M2S_SYSREG->ddrb_buf_timer_cr);
+		return 0;
+	}
+
+	if (strcmp(argv[1], "off") == 0) {
+		M2S_SYSREG->ddrb_cr = 0;
+		return 0;
+	}
+
+	if (strcmp(argv[1], "on") == 0 || strcmp(argv[1], "test") == 0) {
+		if (argc > 2)
+			cr = simple_strtoul(argv[2], NULL, 16);
+		else if (M2S_SYSREG->ddrb_cr)
+			cr = M2S_SYSREG->ddrb_cr;
+		else
+			cr = CONFIG_SYS_M2S_DDRB_CR;
+
+		if (argc > 3)
+			base = simple_strtoul(argv[3], NULL, 16);
+		if ((base & 3) || base < CONFIG_SYS_RAM_BASE ||
+		    base + CONFIG_SYS_M2S_DDRB_TEST_LEN >
+		    CONFIG_SYS_RAM_BASE + CONFIG_SYS_RAM_SIZE) {
+			printf("ddrb: scratch area 0x%08lx is not in DDR\n",
+				base);
+			return 1;
+		}
+
+		if (argv[1][0] == 't') {
+			u32 old = M2S_SYSREG->ddrb_cr;
+			int ret = ddrb_test(cr, base);
+
+			if (!ret)
+				puts("ddrb: self-test passed\n");
+			M2S_SYSREG->ddrb_cr = old;
+			return ret != 0;
+		}
+
+		return ddrb_enable(cr, base) != 0;
+	}
+
+	cmd_usage(cmdtp);
+	return 1;
+}
+
+U_BOOT_CMD(
+	ddrb,	4,	0,	do_ddrb,
+	"M2S MSS DDR bridge buffer control",
+	"       - show the DDR bridge configuration\n"
+	"ddrb on [cr [addr]]   - self-test, then enable buffers as per DDRB_CR=cr\n"
+	"ddrb test [cr [addr]] - self-test only, keeping the current setting\n"
+	"ddrb off              - disable all DDR bridge buffers\n"
+	"The self-test overwrites 64 KB of DDR at addr (default: below the\n"
+	"malloc() pool). cr defaults to the current DDRB_CR if the buffers\n"
+	"are on, else to the DDRB_CR reset value."
+);
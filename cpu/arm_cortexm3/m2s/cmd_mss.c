@@ -31,6 +31,8 @@
 #include <command.h>
 #include <stdint.h>
 #include <spi.h>
+#include <net.h>
+#include <watchdog.h>
 #include "mss_sys_services.h"
 
 #ifdef	CONFIG_SYS_M2S_MSS_DEBUG
@@ -48,6 +50,9 @@
 
 #define SF_CMD_READ_ID	0x9f
 
+/* ISP bitstream bytes handed to the COMBLK per page */
+#define MSS_ISP_PAGE_SIZE	4096
+
 /* Local enums */
 
 enum mss_op_enum {
@@ -59,11 +64,28 @@ enum mss_op_enum {
 	MSS_OP_IAPAUTH,
 	MSS_OP_IAPPROG,
 	MSS_OP_IAPVERI,
+	MSS_OP_ISP,
 };
 
 /* Globals */
 static int g_mss_sys_init_called = 0;
 
+/*
+ * ISP bitstream source, fed to the System Controller page by page
+ */
+static struct {
+	const uint8_t		*base;		/* Bitstream in RAM */
+	volatile ulong		avail;		/* Bytes received so far */
+	ulong			sent;		/* Bytes handed to COMBLK */
+	volatile int		eof;		/* No more bytes to come */
+} g_isp;
+
+/*
+ * Completion of the IAP or ISP request in progress
+ */
+static volatile int g_mss_done;
+static volatile uint32_t g_mss_status;
+
 /* Local string lookup tables */
 
 const char * iap_cmd_str[] = {
@@ -115,6 +137,17 @@ static inline void __attribute__((used)) __disable_irq(void)
 	asm volatile ("cpsid i");
 }
 
+/*
+ * Mask IRQs again once a system service is done, unless U-Boot runs
+ * with IRQs enabled (e.g. for the interrupt-driven console)
+ */
+static inline void mss_irq_done(void)
+{
+#if !defined(CONFIG_SYS_M2S_MSS_DEBUG) && !defined(CONFIG_ARMCORTEXM3_IRQ)
+	__disable_irq();
+#endif
+}
+
 /* Local functions */
 
 static void mss_usage (cmd_tbl_t * cmdtp)
@@ -149,9 +182,7 @@ static int mss_get_serial (cmd_tbl_t * cmdtp, int argc, char *argv[])
 
 	status = MSS_SYS_get_serial_number(serial.u8);
 
-#	ifndef CONFIG_SYS_M2S_MSS_DEBUG
-	__disable_irq();
-#	endif
+	mss_irq_done();
 
 	dbg_printf("MSS_SYS_get_serial_number: status=%d\n", status);
 
@@ -196,9 +227,7 @@ static int mss_get_usercode (cmd_tbl_t * cmdtp, int argc, char *argv[])
 
 	status = MSS_SYS_get_user_code(ucode.u8);
 
-#	ifndef CONFIG_SYS_M2S_MSS_DEBUG
-	__disable_irq();
-#	endif
+	mss_irq_done();
 
 	dbg_printf("MSS_SYS_get_user_code: status=%d\n", status);
 
@@ -243,9 +272,7 @@ static int mss_get_version (cmd_tbl_t * cmdtp, int argc, char *argv[])
 
 	status = MSS_SYS_get_design_version(version.u8);
 
-#	ifndef CONFIG_SYS_M2S_MSS_DEBUG
-	__disable_irq();
-#	endif
+	mss_irq_done();
 
 	dbg_printf("MSS_SYS_get_design_version: status=%d\n", status);
 
@@ -268,6 +295,43 @@ static int mss_get_version (cmd_tbl_t * cmdtp, int argc, char *argv[])
 	return status;
 }
 
+/*
+ * Called from the COMBLK interrupt when an IAP or ISP request is over.
+ */
+static void mss_completion_handler (uint32_t status)
+{
+	g_mss_status = status;
+	g_mss_done = 1;
+}
+
+/*
+ * Wait for the request in progress to complete, kicking the watchdog and
+ * printing the elapsed time (and the share of an ISP bitstream sent, once
+ * its length is known) every second.
+ */
+static void mss_wait_done (int isp)
+{
+	ulong start = get_timer(0);
+	ulong next = 1000;
+	ulong t;
+
+	while (!g_mss_done) {
+		WATCHDOG_RESET();
+
+		t = get_timer(start);
+		if (t < next)
+			continue;
+		next += 1000;
+
+		printf("\r  %lu s", t / 1000);
+		if (isp && g_isp.eof && g_isp.avail >= 100)
+			printf(", %lu%% sent", g_isp.sent / (g_isp.avail / 100));
+	}
+
+	if (next > 1000)
+		putc('\n');
+}
+
 static int mss_iap_cmd (cmd_tbl_t * cmdtp, int argc, char *argv[], int iap_cmd)
 {
 	int status;
@@ -336,15 +400,23 @@ static int mss_iap_cmd (cmd_tbl_t * cmdtp, int argc, char *argv[], int iap_cmd)
 		dbg_printf("MSS_SYS_init succeeded\n");
 	}
 
+	g_mss_done = 0;
+
 	__enable_irq();
 
-	status = MSS_SYS_initiate_iap(iap_cmd, iap_addr);
+	/*
+	 * The System Controller reads the bitstream from SPI flash itself,
+	 * so only the elapsed time can be shown while it works.
+	 */
+	status = MSS_SYS_start_iap(iap_cmd, iap_addr, mss_completion_handler);
+	if (status == MSS_SYS_SUCCESS) {
+		mss_wait_done(0);
+		status = g_mss_status;
+	}
 
-#	ifndef CONFIG_SYS_M2S_MSS_DEBUG
-	__disable_irq();
-#	endif
+	mss_irq_done();
 
-	dbg_printf("MSS_SYS_initiate_iap: status=%d\n", status);
+	dbg_printf("MSS_SYS_start_iap: status=%d\n", status);
 
 	if (status > 128) {
 		if (status > MSS_IAP_PROG_ERROR_MAX)
@@ -384,6 +456,180 @@ cleanup_slave:
 	return status;
 }
 
+/*
+ * Hand the bitstream received but not sent yet to the COMBLK driver,
+ * at most MSS_ISP_PAGE_SIZE bytes at a time so that g_isp.sent tracks
+ * what the System Controller has actually taken. Called from the COMBLK
+ * interrupt.
+ */
+static uint32_t mss_isp_page_handler (uint8_t const ** pp_next_page)
+{
+	ulong avail = g_isp.avail;
+	uint32_t len;
+
+	if (g_isp.sent == avail)
+		return g_isp.eof ? 0 : COMBLK_PAGE_PENDING;
+
+	*pp_next_page = g_isp.base + g_isp.sent;
+	len = avail - g_isp.sent;
+	if (len > MSS_ISP_PAGE_SIZE)
+		len = MSS_ISP_PAGE_SIZE;
+	g_isp.sent += len;
+
+	return len;
+}
+
+
+/*
+ * Let the page handler have TFTP blocks as they arrive in order.
+ * Out-of-order (e.g. multicast) blocks are only sent once the
+ * transfer is complete.
+ */
+static void mss_isp_tftp_store (ulong offset, ulong len)
+{
+	if (offset > g_isp.avail || offset + len <= g_isp.avail)
+		return;
+
+	__disable_irq();
+	g_isp.avail = offset + len;
+	MSS_COMBLK_resume_paged_tx();
+	__enable_irq();
+}
+
+/*
+ * ISP: the M3 feeds the bitstream from RAM to the System Controller,
+ * rather than the System Controller reading it from SPI flash (IAP).
+ * The bitstream is either already in RAM, or streamed from a TFTP
+ * transfer as it arrives.
+ */
+static int mss_isp_cmd (cmd_tbl_t * cmdtp, int argc, char *argv[])
+{
+	int tftp = argc > 3 && !strcmp(argv[3], "tftp");
+	char *s;
+	ulong len;
+	int isp_cmd;
+	int status;
+
+	if (argc < 3) {
+		mss_usage(cmdtp);
+		return MSS_FAILURE;
+	}
+
+	if (!strcmp(argv[2], "auth"))
+		isp_cmd = MSS_SYS_PROG_AUTHENTICATE;
+	else if (!strcmp(argv[2], "prog"))
+		isp_cmd = MSS_SYS_PROG_PROGRAM;
+	else if (!strcmp(argv[2], "veri"))
+		isp_cmd = MSS_SYS_PROG_VERIFY;
+	else {
+		mss_usage(cmdtp);
+		return MSS_FAILURE;
+	}
+
+	memset(&g_isp, 0, sizeof(g_isp));
+	g_mss_done = 0;
+
+	if (tftp) {
+		if (argc > 4)
+			copy_filename(BootFile, argv[4], sizeof(BootFile));
+		g_isp.base = (const uint8_t *)load_addr;
+	}
+
+	/*
+	 * Only "auth" is streamed: a TFTP failure after the System
+	 * Controller has started erasing would leave the device half
+	 * programmed. "prog" and "veri" get the whole file into RAM first,
+	 * and program from there.
+	 */
+	if (tftp && isp_cmd != MSS_SYS_PROG_AUTHENTICATE) {
+		int size = NetLoop(TFTP);
+
+		if (size <= 0) {
+			argv_printf("TFTP failed, device not touched\n");
+			return MSS_FAILURE;
+		}
+		g_isp.avail = size;
+		g_isp.eof = 1;
+		tftp = 0;
+	} else if (!tftp) {
+		g_isp.base = (const uint8_t *)(argc > 3 ?
+			simple_strtoul(argv[3], NULL, 16) : load_addr);
+		if (argc > 4)
+			len = simple_strtoul(argv[4], NULL, 16);
+		else if ((s = getenv("filesize")) != NULL)
+			len = simple_strtoul(s, NULL, 16);
+		else {
+			argv_printf("No bitstream length given!\n");
+			return MSS_FAILURE;
+		}
+		g_isp.avail = len;
+		g_isp.eof = 1;
+	}
+
+	argv_printf("Starting ISP %s from %s at 0x%p...\n", iap_cmd_str[isp_cmd],
+		tftp ? "TFTP stream" : "RAM", g_isp.base);
+
+	if (!g_mss_sys_init_called) {
+		g_mss_sys_init_called = 1;
+		MSS_SYS_init((sys_serv_async_event_handler_t)mss_async_event_handler);
+		dbg_printf("MSS_SYS_init succeeded\n");
+	}
+
+	__enable_irq();
+
+	status = MSS_SYS_start_isp(isp_cmd, mss_isp_page_handler,
+				mss_completion_handler);
+	if (status != MSS_SYS_SUCCESS) {
+		mss_irq_done();
+		argv_printf("Failed to start ISP! status=%d\n", status);
+		return status;
+	}
+
+	if (tftp) {
+		int size;
+
+		TftpStoreHook = mss_isp_tftp_store;
+		size = NetLoop(TFTP);
+		TftpStoreHook = NULL;
+
+		/*
+		 * On failure, ending the bitstream here makes the
+		 * System Controller reject it
+		 */
+		__disable_irq();
+		if (size > 0)
+			g_isp.avail = size;
+		g_isp.eof = 1;
+		MSS_COMBLK_resume_paged_tx();
+		__enable_irq();
+	}
+
+	mss_wait_done(1);
+
+	mss_irq_done();
+
+	status = g_mss_status;
+	dbg_printf("MSS_SYS_start_isp: status=%d, sent=0x%lx\n",
+			status, g_isp.sent);
+
+	if (status > 128) {
+		if (status > MSS_IAP_PROG_ERROR_MAX)
+			argv_printf("Unknown programming error! status=%d\n", status);
+		else
+			argv_printf("Programming error: MSS_SYS_%s\n", iap_prog_err_str[status - 128]);
+	} else if (status > 0) {
+		if (status > MSS_IAP_AUTH_ERROR_MAX)
+			argv_printf("Unknown authentication error! status=%d\n", status);
+		else
+			argv_printf("Authentication error: MSS_SYS_%s\n", iap_auth_err_str[status]);
+	} else {
+		argv_printf("ISP %s success! (0x%lx bytes)\n",
+			iap_cmd_str[isp_cmd], g_isp.sent);
+	}
+
+	return status;
+}
+
 /*
  * Decode the operation string into supported ops enums.
  */
@@ -403,6 +649,8 @@ static int mss_decode_op (char *opstr)
 		op = MSS_OP_IAPPROG;
 	else if (!strcmp ("iapveri", opstr))
 		op = MSS_OP_IAPVERI;
+	else if (!strcmp ("isp", opstr))
+		op = MSS_OP_ISP;
 	else
 		op = MSS_OP_INVALID;
 
@@ -420,6 +668,10 @@ static int mss_decode_op (char *opstr)
  *   'iapprog': IAP Program FPGA image. [arg] = offset in SPI flash.
  *   'iapveri': IAP Verify FPGA image. [arg] = offset in SPI flash.
  *              If [arg] omitted, 'iapaddr' environment variable is used.
+ *   'isp'    : ISP Authenticate/Program/Verify FPGA image from RAM:
+ *              isp <auth|prog|veri> [addr [len]], or from TFTP:
+ *              isp <auth|prog|veri> tftp [file]
+ *              ("auth" is streamed, "prog"/"veri" load to RAM first)
  */
 int do_mss (cmd_tbl_t * cmdtp, int flag, int argc, char *argv[])
 {
@@ -460,6 +712,10 @@ int do_mss (cmd_tbl_t * cmdtp, int flag, int argc, char *argv[])
 		rc = mss_iap_cmd(cmdtp, argc, argv, MSS_SYS_PROG_VERIFY);
 		break;
 
+	case MSS_OP_ISP:
+		rc = mss_isp_cmd(cmdtp, argc, argv);
+		break;
+
 	default:
 		argv_printf("Invalid operation!\n");
 		mss_usage(cmdtp);
@@ -468,7 +724,7 @@ int do_mss (cmd_tbl_t * cmdtp, int flag, int argc, char *argv[])
 	return (rc);
 }
 
-U_BOOT_CMD (mss, 3, 1, do_mss,
+U_BOOT_CMD (mss, 5, 1, do_mss,
 	    "M2S MSS System Services support",
 	    "<operation> [argument]\n"
 	    "  operations:\n"
@@ -479,4 +735,9 @@ U_BOOT_CMD (mss, 3, 1, do_mss,
 	    "    iapprog :\tIAP Program image. [arg] = offset in SPI flash.\n"
 	    "    iapveri :\tIAP Verify image. [arg] = offset in SPI flash.\n"
 	    "             \tIf [arg] omitted, 'iapaddr' environment variable is used.\n"
+	    "    isp <auth|prog|veri> [addr [len]] :\n"
+	    "             \tISP from RAM. Default: ${loadaddr}, ${filesize}.\n"
+	    "    isp <auth|prog|veri> tftp [file] :\n"
+	    "             \tISP from TFTP. \"auth\" is streamed as it is received;\n"
+	    "             \t\"prog\"/\"veri\" load the whole file to ${loadaddr} first.\n"
 );
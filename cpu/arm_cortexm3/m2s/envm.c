@@ -19,6 +19,7 @@
  */
 
 #include <common.h>
+#include "envm.h"
 #include "clock.h"
 
 /*
@@ -88,59 +89,100 @@ void envm_init(void)
 }
 
 /*
- * Update an eNVM page.
- * Note that we need for this function to reside in RAM since it
- * will be used to self-upgrade U-boot in eNMV.
- * @param page		eNVM page
- * @param part_begin	updated area start offset in page
- * @param part_end	updated area end offset in page
- * @param buf		data to write
- * @returns		0 -> success
+ * Page counts of the last envm_write()
  */
-unsigned int __attribute__((section(".ramcode")))
-             __attribute__ ((long_call))
-  envm_write_page_part(
-	unsigned int page, unsigned int part_begin,
-	unsigned int part_end, unsigned char *buf)
-{
-	/*
-	 * If not writing a whole page, save the existing data in this page
-	 */
-	if (part_begin != 0 || part_end != MSS_ENVM_PAGE_SIZE) {
-		memcpy((void *) MSS_ENVM->wdbuff,
-			(const void *) ((unsigned char *) MSS_ENVM_BASE +
-				page * MSS_ENVM_PAGE_SIZE),
-			MSS_ENVM_PAGE_SIZE);
-	}
+struct envm_write_stats envm_write_stats;
 
-	/*
-	 * Copy new data to the Write Buffer
-	 */
-	memcpy((void *) ((unsigned char *) MSS_ENVM->wdbuff + part_begin),
-		buf, part_end - part_begin);
+/*
+ * Pages of the last envm_write() that differ from the eNVM contents
+ */
+static unsigned int envm_dirty[MSS_ENVM_FLASH_SIZE / MSS_ENVM_PAGE_SIZE / 32];
 
-	/*
-	 * Wait for Ready in Status
-	 */
+/*
+ * Staging for the page to be programmed next, and saved copies of the
+ * partially written first and last pages
+ */
+static unsigned int envm_stage[MSS_ENVM_PAGE_SIZE / 4];
+static unsigned int envm_head[MSS_ENVM_PAGE_SIZE / 4];
+static unsigned int envm_tail[MSS_ENVM_PAGE_SIZE / 4];
+
+/*
+ * Nothing below may call out of RAM, hence the forced inlining: the eNVM
+ * cannot be read while a page is being programmed.
+ */
+static inline __attribute__((always_inline)) void
+	envm_wait_ready(void)
+{
 	while (!(MSS_ENVM->status & MSS_ENVM_STATUS_READY));
+}
 
-	/*
-	 * Issue the ProgramADS command (ProgramAd + ProgramDa + ProgramStart)
-	 */
-	MSS_ENVM->cmd = MSS_ENVM_CMD_PROGRAM_ADS | (page * MSS_ENVM_PAGE_SIZE);
+/*
+ * Mask IRQs for the programming session: an ISR (and its vector) would
+ * be fetched from the busy eNVM. This is disable_interrupts() and its
+ * reverse, inlined.
+ */
+static inline __attribute__((always_inline)) unsigned int
+	envm_irq_save(void)
+{
+	unsigned int primask;
 
-	/*
-	 * Wait for Ready in Status
-	 */
-	while (!(MSS_ENVM->status & MSS_ENVM_STATUS_READY));
+	asm volatile ("mrs %0, primask\n"
+		      "cpsid i"
+		      : "=r" (primask) : : "memory");
+	return primask;
+}
+
+static inline __attribute__((always_inline)) void
+	envm_irq_restore(unsigned int primask)
+{
+	asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+}
+
+/*
+ * Build the new contents of a page into dst. Bytes outside of the
+ * written area are taken from the eNVM, so that must not be busy
+ * for the first and last pages.
+ */
+static inline __attribute__((always_inline)) void
+	envm_page_build(unsigned int page, unsigned int offset,
+		unsigned char *buf, unsigned int size, unsigned int *dst)
+{
+	unsigned char *d = (unsigned char *)dst;
+	unsigned int base = page * MSS_ENVM_PAGE_SIZE;
+	unsigned int i;
+
+	for (i = 0; i < MSS_ENVM_PAGE_SIZE; i++) {
+		if (base + i >= offset && base + i < offset + size)
+			d[i] = buf[base + i - offset];
+		else
+			d[i] = *((unsigned char *)MSS_ENVM_BASE + base + i);
+	}
+}
+
+static inline __attribute__((always_inline)) int
+	envm_page_same(unsigned int page, unsigned int *p)
+{
+	unsigned int *f = (unsigned int *)
+		(MSS_ENVM_BASE + page * MSS_ENVM_PAGE_SIZE);
+	unsigned int i;
 
-	return 0;
+	for (i = 0; i < MSS_ENVM_PAGE_SIZE / 4; i++) {
+		if (f[i] != p[i])
+			return 0;
+	}
+	return 1;
 }
 
 /*
  * Write a data buffer to eNVM.
  * Note that we need for this function to reside in RAM since it
  * will be used to self-upgrade U-boot in eNMV.
+ *
+ * Pages which already hold the new data are not programmed at all.
+ * All pages are compared first, while the eNVM can be read; the
+ * changed pages are then programmed back to back, each being built
+ * in RAM while the previous one is programmed.
+ *
  * @param offset	eNVM offset
  * @param buf		data to write
  * @param size		how many bytes to write
@@ -151,33 +193,104 @@ unsigned int __attribute__((section(".ramcode")))
   envm_write(unsigned int offset, void *buf, unsigned int size)
 {
 	unsigned int page, first_page, last_page;
+	unsigned int *p;
+	unsigned int i;
+	unsigned int primask;
+	int src_in_ram;
+
+	envm_write_stats.written = 0;
+	envm_write_stats.skipped = 0;
+
+	if (size == 0 || offset + size > MSS_ENVM_FLASH_SIZE)
+		return 0;
+
+	first_page = offset / MSS_ENVM_PAGE_SIZE;
+	last_page = (offset + size - 1) / MSS_ENVM_PAGE_SIZE;
 
 	/*
-	 * Open exlusive access to eNVM by Cortex-M3
+	 * The source can only be read while programming if it
+	 * is not in the eNVM itself
 	 */
-	MSS_ENVM->reqaccess = MSS_ENVM_REQACCESS_EXCL;
-	while (MSS_ENVM->reqaccess != MSS_ENVM_REQACCESS_BY_M3);
+	src_in_ram = (unsigned int)buf >= MSS_ENVM_FLASH_SIZE &&
+		((unsigned int)buf + size <= MSS_ENVM_BASE ||
+		 (unsigned int)buf >= MSS_ENVM_BASE + MSS_ENVM_FLASH_SIZE);
 
 	/*
-	 * Update eNVM, page by page
+	 * Find the pages that need programming. The partially written
+	 * first and last pages are kept, as their old contents cannot be
+	 * read later on.
 	 */
-	first_page = offset / MSS_ENVM_PAGE_SIZE;
-	last_page = (offset + size - 1) / MSS_ENVM_PAGE_SIZE;
+	for (page = first_page; page <= last_page; page++) {
+		if (page == first_page)
+			p = envm_head;
+		else if (page == last_page)
+			p = envm_tail;
+		else
+			p = envm_stage;
+
+		envm_page_build(page, offset, buf, size, p);
+		if (envm_page_same(page, p)) {
+			envm_dirty[page / 32] &= ~(1 << (page % 32));
+			envm_write_stats.skipped++;
+		} else {
+			envm_dirty[page / 32] |= 1 << (page % 32);
+			envm_write_stats.written++;
+		}
+	}
+
+	if (envm_write_stats.written == 0)
+		return size;
+
+	primask = envm_irq_save();
+
+	/*
+	 * Open exlusive access to eNVM by Cortex-M3
+	 */
+	MSS_ENVM->reqaccess = MSS_ENVM_REQACCESS_EXCL;
+	while (MSS_ENVM->reqaccess != MSS_ENVM_REQACCESS_BY_M3);
 
 	for (page = first_page; page <= last_page; page++) {
-		envm_write_page_part(page,
-			max(0, offset - page * MSS_ENVM_PAGE_SIZE),
-			min(MSS_ENVM_PAGE_SIZE,
-				offset + size - page * MSS_ENVM_PAGE_SIZE),
-			(unsigned char *)buf +
-				max(page * MSS_ENVM_PAGE_SIZE - offset, 0));
+		if (!(envm_dirty[page / 32] & (1 << (page % 32))))
+			continue;
+
+		if (page == first_page) {
+			p = envm_head;
+		} else if (page == last_page) {
+			p = envm_tail;
+		} else {
+			/*
+			 * Build the page while the previous one programs
+			 */
+			if (!src_in_ram)
+				envm_wait_ready();
+			envm_page_build(page, offset, buf, size, envm_stage);
+			p = envm_stage;
+		}
+
+		/*
+		 * Wait for Ready in Status
+		 */
+		envm_wait_ready();
+
+		for (i = 0; i < MSS_ENVM_PAGE_SIZE / 4; i++)
+			MSS_ENVM->wdbuff[i] = p[i];
+
+		/*
+		 * Issue the ProgramADS command (ProgramAd + ProgramDa +
+		 * ProgramStart), without waiting for it to complete
+		 */
+		MSS_ENVM->cmd = MSS_ENVM_CMD_PROGRAM_ADS |
+			(page * MSS_ENVM_PAGE_SIZE);
 	}
 
+	envm_wait_ready();
+
 	/*
 	 * Disable access to eNVM by Cortex-M3 core
 	 */
 	MSS_ENVM->reqaccess = ~MSS_ENVM_REQACCESS_EXCL;
 
+	envm_irq_restore(primask);
+
 	return size;
 }
-
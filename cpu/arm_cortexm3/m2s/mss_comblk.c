@@ -63,6 +63,7 @@ static void handle_tx_okay_irq(void);
 static void handle_rx_okay_irq(void);
 static void complete_request(uint16_t response_length);
 static void process_sys_ctrl_command(uint8_t cmd_opcode);
+static void start_next_request(void);
 
 /*==============================================================================
  * Global variables:
@@ -80,6 +81,8 @@ static uint32_t (*g_comblk_page_handler)(uint8_t const ** pp_next_page) = 0;
 static volatile uint8_t g_request_in_progress = 0u;
 static uint8_t g_comblk_state = COMBLK_IDLE;
 static volatile comblk_async_event_handler_t g_async_event_handler = 0;
+static comblk_request_t * g_comblk_queue = 0;
+static comblk_request_t * volatile g_comblk_active = 0;
 
 /*==============================================================================
  *
@@ -365,6 +368,17 @@ void MSS_COMBLK_send_paged_cmd
 #endif
 }
 
+/*==============================================================================
+ *
+ */
+void MSS_COMBLK_resume_paged_tx(void)
+{
+    if(COMBLK_TX_PAGED_DATA == g_comblk_state)
+    {
+        COMBLK->INT_ENABLE |= TXTOKAY_MASK;
+    }
+}
+
 /*==============================================================================
  * COMBLK interrupt handler.
  */
@@ -391,6 +405,121 @@ void ComBlk_IRQHandler(void)
     {
         handle_tx_okay_irq();
     }
+    
+    /*
+     * Send the next queued request once the previous one is over.
+     */
+    start_next_request();
+}
+
+/*==============================================================================
+ *
+ */
+void MSS_COMBLK_submit
+(
+    comblk_request_t * p_req
+)
+{
+    comblk_request_t ** pp_last;
+    
+    p_req->state = COMBLK_REQ_QUEUED;
+    p_req->response_length = 0u;
+    p_req->bytes_sent = 0u;
+    p_req->p_next = 0;
+    
+    NVIC_DisableIRQ(ComBlk_IRQn);
+    
+    pp_last = &g_comblk_queue;
+    while(*pp_last != 0)
+    {
+        pp_last = &(*pp_last)->p_next;
+    }
+    *pp_last = p_req;
+    
+    start_next_request();
+    
+    NVIC_EnableIRQ(ComBlk_IRQn);
+}
+
+/*==============================================================================
+ * Page and completion handlers for queued requests.
+ */
+static uint32_t queue_page_handler
+(
+    uint8_t const ** pp_next_page
+)
+{
+    comblk_request_t * p_req = g_comblk_active;
+    uint32_t size;
+    
+    size = p_req->page_handler(pp_next_page);
+    if((size != 0u) && (size != COMBLK_PAGE_PENDING))
+    {
+        p_req->bytes_sent += size;
+    }
+    
+    return size;
+}
+
+static void queue_completion_handler
+(
+    uint8_t * p_response,
+    uint16_t response_size
+)
+{
+    comblk_request_t * p_req = g_comblk_active;
+    
+    g_comblk_active = 0;
+    if(p_req != 0)
+    {
+        if(0 == p_req->page_handler)
+        {
+            p_req->bytes_sent = p_req->data_size;
+        }
+        p_req->response_length = response_size;
+        p_req->state = COMBLK_REQ_DONE;
+        if(p_req->completion_handler != 0)
+        {
+            p_req->completion_handler(p_req);
+        }
+    }
+}
+
+/*==============================================================================
+ * Start the request at the head of the queue, if the COMBLK is free.
+ */
+static void start_next_request(void)
+{
+    comblk_request_t * p_req = g_comblk_queue;
+    
+    if((p_req == 0) || (g_comblk_active != 0) || g_request_in_progress)
+    {
+        return;
+    }
+    
+    g_comblk_queue = p_req->p_next;
+    g_comblk_active = p_req;
+    p_req->state = COMBLK_REQ_ACTIVE;
+    
+    if(p_req->page_handler != 0)
+    {
+        MSS_COMBLK_send_paged_cmd(p_req->p_cmd,
+                                  p_req->cmd_size,
+                                  p_req->p_response,
+                                  p_req->response_size,
+                                  queue_page_handler,
+                                  queue_completion_handler);
+    }
+    else
+    {
+        MSS_COMBLK_send_cmd(p_req->p_cmd,
+                            p_req->cmd_size,
+                            p_req->p_data,
+                            p_req->data_size,
+                            p_req->p_response,
+                            p_req->response_size,
+                            queue_completion_handler);
+    }
 }
 
 /*==============================================================================
@@ -474,6 +603,16 @@ static void handle_tx_okay_irq(void)
                 if(g_comblk_page_handler != 0)
                 {
                     g_comblk_data_size = g_comblk_page_handler(&g_comblk_p_data);
+                    if(COMBLK_PAGE_PENDING == g_comblk_data_size)
+                    {
+                        /*
+                         * Page not available yet: wait for
+                         * MSS_COMBLK_resume_paged_tx().
+                         */
+                        g_comblk_data_size = 0u;
+                        COMBLK->INT_ENABLE &= ~TXTOKAY_MASK;
+                        break;
+                    }
                     if(0u == g_comblk_data_size)
                     {
                         COMBLK->INT_ENABLE &= ~TXTOKAY_MASK;
@@ -88,6 +88,49 @@ void MSS_COMBLK_send_paged_cmd
     comblk_completion_handler_t completion_handler
 );
 
+/*------------------------------------------------------------------------------
+ * Asynchronous request queue.
+ *
+ * Requests submitted through MSS_COMBLK_submit() are queued and sent to the
+ * System Controller one after the other from the COMBLK interrupt, so the
+ * caller is free to do other work meanwhile. A request structure must stay
+ * valid until its completion handler has been called.
+ * The MSS_COMBLK_send_xxx() functions above abort the command in progress,
+ * so they must not be used while queued requests are outstanding.
+ */
+typedef struct comblk_request comblk_request_t;
+
+typedef void (*comblk_request_handler_t)(comblk_request_t * p_req);
+
+#define COMBLK_REQ_QUEUED       1u
+#define COMBLK_REQ_ACTIVE       2u
+#define COMBLK_REQ_DONE         3u
+
+struct comblk_request
+{
+    /* Set up by the caller. */
+    const uint8_t * p_cmd;
+    uint16_t cmd_size;
+    const uint8_t * p_data;                     /* Unless paged */
+    uint32_t data_size;
+    uint8_t * p_response;
+    uint16_t response_size;
+    comblk_page_handler_t page_handler;         /* Paged data, or 0 */
+    comblk_request_handler_t completion_handler;
+    void * context;
+    
+    /* Maintained by the driver. */
+    volatile uint8_t state;
+    volatile uint16_t response_length;
+    volatile uint32_t bytes_sent;
+    comblk_request_t * p_next;
+};
+
+void MSS_COMBLK_submit
+(
+    comblk_request_t * p_req
+);
+
 #ifdef __cplusplus
 }
 #endif
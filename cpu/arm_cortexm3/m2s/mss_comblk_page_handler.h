@@ -59,6 +59,21 @@ extern "C" {
  */
 typedef uint32_t (*comblk_page_handler_t)(uint8_t const ** pp_next_page);
 
+/*-------------------------------------------------------------------------*//**
+  A COMBLK page handler may return COMBLK_PAGE_PENDING when the next page of
+  programming data is not available yet, e.g. while it is still being
+  downloaded. Transmission is then suspended until the application calls
+  MSS_COMBLK_resume_paged_tx(), at which point the page handler is called
+  again.
+ */
+#define COMBLK_PAGE_PENDING     0xFFFFFFFFu
+
+/*-------------------------------------------------------------------------*//**
+  Resume transmission of paged data suspended by a page handler returning
+  COMBLK_PAGE_PENDING.
+ */
+void MSS_COMBLK_resume_paged_tx(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1262,6 +1262,11 @@ static void isp_sys_completion_handler
     uint16_t length
 )
 {    
+    /*
+     * Allow further requests, see signal_request_start() in MSS_SYS_start_isp()
+     */
+    g_request_in_progress = 0u;
+
     if(g_mode != MSS_SYS_PROG_AUTHENTICATE)
     {
         /*
@@ -1373,6 +1378,54 @@ uint8_t MSS_SYS_start_isp
 }
 
 
+/*==============================================================================
+ * Prepare the eNVM and clocks for IAP programming or verification, keeping
+ * a copy of the original configuration for iap_restore_clocks().
+ */
+static uint8_t iap_prepare_clocks(void)
+{
+    /*
+     * Keep a copy of the initial eNVM configuration used before IAP was
+     * initiated. The eNVM configuration will be restored, as part of the IAP
+     * completion handler, when IAP completes.
+     */
+    g_initial_envm_cr = SYSREG->ENVM_CR;
+ 
+    /* Store the MSS DDR FACC 2 register value so that its can be restored back 
+     * when the IAP operation is completed.asynchronous_event_handler. */
+    g_initial_mssddr_facc2_cr = SYSREG->MSSDDR_FACC2_CR;
+    
+    /*
+     * Set the eNVM's frequency range to its maximum. This is required to ensure
+     * successful eNVM programming on all devices.
+     */
+    SYSREG->ENVM_CR = (g_initial_envm_cr & ~NVM_FREQRNG_MASK) | NVM_FREQRNG_MAX;                
+
+    /* Select output of MUX 0, MUX 1 and MUX 2 during standby */
+    SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR & ((uint32_t)(FACC_STANDBY_SEL << FACC_STANDBY_SHIFT) | ~FACC_STANDBY_SEL_MASK);
+    
+    /* Enable the signal for the 50 MHz RC oscillator */
+    SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR | ((uint32_t)(MSS_25_50MHZ_EN << MSS_25_50MHZ_EN_SHIFT) & MSS_25_50MHZ_EN_MASK);
+    
+    /* Enable the signal for the 1 MHz RC oscillator */
+    SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR | ((uint32_t)(MSS_1MHZ_EN << MSS_1MHZ_EN_SHIFT) & MSS_1MHZ_EN_MASK);
+    
+    /* SAR 80563
+     * Cortex-M3 firmware dynamically divides down fclk, pclk0, pclk1 and
+     * clk_fic64 to the divided by 32 versions based on device version.
+     */
+    return clk_switching_fix();
+}
+
+/*==============================================================================
+ * Restore the eNVM and clock configuration saved by iap_prepare_clocks().
+ */
+static void iap_restore_clocks(void)
+{
+    SYSREG->ENVM_CR = g_initial_envm_cr;
+    SYSREG->MSSDDR_FACC2_CR = g_initial_mssddr_facc2_cr;
+}
+
 /*==============================================================================
  * See mss_sys_services.h for details.
  */
@@ -1397,38 +1450,8 @@ uint8_t MSS_SYS_initiate_iap
     }
     
     if(mode != MSS_SYS_PROG_AUTHENTICATE)
-    { 
-        /*
-         * Keep a copy of the initial eNVM configuration used before IAP was
-         * initiated. The eNVM configuration will be restored, as part of the IAP
-         * completion handler, when IAP completes.
-         */
-        g_initial_envm_cr = SYSREG->ENVM_CR;
-     
-        /* Store the MSS DDR FACC 2 register value so that its can be restored back 
-         * when the IAP operation is completed.asynchronous_event_handler. */
-        g_initial_mssddr_facc2_cr = SYSREG->MSSDDR_FACC2_CR;
-        
-        /*
-         * Set the eNVM's frequency range to its maximum. This is required to ensure
-         * successful eNVM programming on all devices.
-         */
-        SYSREG->ENVM_CR = (g_initial_envm_cr & ~NVM_FREQRNG_MASK) | NVM_FREQRNG_MAX;                
-
-        /* Select output of MUX 0, MUX 1 and MUX 2 during standby */
-        SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR & ((uint32_t)(FACC_STANDBY_SEL << FACC_STANDBY_SHIFT) | ~FACC_STANDBY_SEL_MASK);
-        
-        /* Enable the signal for the 50 MHz RC oscillator */
-        SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR | ((uint32_t)(MSS_25_50MHZ_EN << MSS_25_50MHZ_EN_SHIFT) & MSS_25_50MHZ_EN_MASK);
-        
-        /* Enable the signal for the 1 MHz RC oscillator */
-        SYSREG->MSSDDR_FACC2_CR = SYSREG->MSSDDR_FACC2_CR | ((uint32_t)(MSS_1MHZ_EN << MSS_1MHZ_EN_SHIFT) & MSS_1MHZ_EN_MASK);
-        
-        /* SAR 80563
-         * Cortex-M3 firmware dynamically divides down fclk, pclk0, pclk1 and
-         * clk_fic64 to the divided by 32 versions based on device version.
-         */
-        clk_switch_status = clk_switching_fix();
+    {
+        clk_switch_status = iap_prepare_clocks();
     }
     
     if(clk_switch_status == CLOCK_SWITCHING_SUCCESS)
@@ -1473,8 +1496,7 @@ uint8_t MSS_SYS_initiate_iap
         if(mode != MSS_SYS_PROG_AUTHENTICATE)
         {
             /* Restore back to original value. */
-            SYSREG->ENVM_CR = g_initial_envm_cr;
-            SYSREG->MSSDDR_FACC2_CR = g_initial_mssddr_facc2_cr;
+            iap_restore_clocks();
         }
     }
     else
@@ -1490,6 +1512,105 @@ uint8_t MSS_SYS_initiate_iap
     return status;
 }
 
+/*==============================================================================
+ * See mss_sys_services.h for details.
+ */
+static comblk_request_t g_iap_request;
+static uint8_t g_iap_request_cmd[6];
+static uint8_t g_iap_response[IAP_PROG_SERV_RESP_LENGTH];
+static uint8_t g_iap_mode = 0;
+static sys_serv_isp_complete_handler_t g_iap_completion_handler = 0;
+
+static void iap_request_completion_handler
+(
+    comblk_request_t * p_req
+)
+{
+    uint32_t status;
+    
+    if(g_iap_mode != MSS_SYS_PROG_AUTHENTICATE)
+    {
+        iap_restore_clocks();
+    }
+    
+    if((IAP_PROG_SERV_RESP_LENGTH == p_req->response_length) &&
+       (IAP_PROGRAMMING_REQUEST_CMD == g_iap_response[0]))
+    {
+        status = g_iap_response[1];
+    }
+    else
+    {
+        status = MSS_SYS_UNEXPECTED_ERROR;
+    }
+    
+    /*
+     * Allow further requests, see signal_request_start() in MSS_SYS_start_iap()
+     */
+    g_request_in_progress = 0u;
+    
+    if(g_iap_completion_handler != 0)
+    {
+        g_iap_completion_handler(status);
+    }
+}
+
+uint8_t MSS_SYS_start_iap
+(
+    uint8_t mode,
+    uint32_t bitstream_spi_addr,
+    sys_serv_isp_complete_handler_t iap_completion_handler
+)
+{
+    uint8_t clk_switch_status = CLOCK_SWITCHING_SUCCESS;
+    
+    if(mode == MSS_SYS_PROG_VERIFY)
+    {
+        /*
+         * Check fabric digest before performing IAP verify
+         */
+        MSS_SYS_check_digest(MSS_SYS_DIGEST_CHECK_FABRIC);
+    }
+    
+    signal_request_start();
+    
+    if(mode != MSS_SYS_PROG_AUTHENTICATE)
+    {
+        clk_switch_status = iap_prepare_clocks();
+    }
+    
+    if(clk_switch_status != CLOCK_SWITCHING_SUCCESS)
+    {
+        g_request_in_progress = 0u;
+        
+        /* SAR 80563, see MSS_SYS_initiate_iap() */
+        return MSS_SYS_CLK_DIVISOR_ERROR;
+    }
+    
+    g_iap_request_cmd[0] = IAP_PROGRAMMING_REQUEST_CMD;
+    g_iap_request_cmd[1] = mode;
+    g_iap_request_cmd[2] = (uint8_t)(bitstream_spi_addr);
+    g_iap_request_cmd[3] = (uint8_t)(bitstream_spi_addr >> 8u);
+    g_iap_request_cmd[4] = (uint8_t)(bitstream_spi_addr >> 16u);
+    g_iap_request_cmd[5] = (uint8_t)(bitstream_spi_addr >> 24u);
+    
+    g_iap_mode = mode;
+    g_iap_completion_handler = iap_completion_handler;
+    
+    g_iap_request.p_cmd = g_iap_request_cmd;
+    g_iap_request.cmd_size = sizeof(g_iap_request_cmd);
+    g_iap_request.p_data = 0;
+    g_iap_request.data_size = 0u;
+    g_iap_request.p_response = g_iap_response;
+    g_iap_request.response_size = IAP_PROG_SERV_RESP_LENGTH;
+    g_iap_request.page_handler = 0;
+    g_iap_request.completion_handler = iap_request_completion_handler;
+    g_iap_request.context = 0;
+    
+    MSS_COMBLK_submit(&g_iap_request);
+    
+    return MSS_SYS_SUCCESS;
+}
+
 /*==============================================================================
  * See mss_sys_services.h for details.
  */
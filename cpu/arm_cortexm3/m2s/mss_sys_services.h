@@ -1712,6 +1712,35 @@ uint8_t MSS_SYS_initiate_iap
     uint32_t bitstream_spi_addr
 );
 
+/*-------------------------------------------------------------------------*//**
+  The MSS_SYS_start_iap() function is a non-blocking version of
+  MSS_SYS_initiate_iap(). The IAP request is queued with the COMBLK driver and
+  the function returns straight away, leaving the caller free to service the
+  console or watchdog while the System Controller reads and programs the
+  bitstream. Interrupts must be enabled until the completion handler has been
+  called.
+
+  @param mode
+    As for MSS_SYS_initiate_iap().
+
+  @param bitstream_spi_addr
+    As for MSS_SYS_initiate_iap().
+
+  @param iap_completion_handler
+    The iap_completion_handler parameter is called from the COMBLK interrupt
+    with one of the status codes returned by MSS_SYS_initiate_iap(). It is
+    never called for MSS_SYS_PROG_PROGRAM success, as the Cortex-M3 is reset.
+
+  @return
+    MSS_SYS_SUCCESS if the request was queued, or MSS_SYS_CLK_DIVISOR_ERROR.
+*/
+uint8_t MSS_SYS_start_iap
+(
+    uint8_t mode,
+    uint32_t bitstream_spi_addr,
+    sys_serv_isp_complete_handler_t iap_completion_handler
+);
+
 /*-------------------------------------------------------------------------*//**
   The MSS_SYS_check_digest() function is used to recalculate and compare 
   cryptographic digests of selected NVM component(s) � FPGA fabric, eNVM0, and 
@@ -66,6 +66,26 @@ extern void lpc18xx_norflash_bootstrap_iomux_init(void);
 extern void ComBlk_IRQHandler(void);
 #endif
 
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+extern void NS16550_rx_isr(void);
+#endif
+
+#ifdef CONFIG_ARMCORTEXM3_HOTCODE
+/*
+ * memcpy() is itself one of the functions run from RAM,
+ * so it cannot be used to get the code there
+ */
+static void start_copy(char *dst, const char *src, unsigned int len)
+{
+	volatile char *d = dst;
+
+	while (len--)
+		*d++ = *src++;
+}
+#else
+#define start_copy(dst, src, len)	memcpy(dst, src, len)
+#endif
+
 /*
  * Control IRQs
  */
@@ -104,7 +124,14 @@ unsigned int vectors[] __attribute__((section(".vectors"))) = {
 	/*
 	 * COMBLK IRQ19
 	 */
-	[16 + ComBlk_IRQn] = (unsigned int)&ComBlk_IRQHandler
+	[16 + ComBlk_IRQn] = (unsigned int)&ComBlk_IRQHandler,
+#endif
+
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	/*
+	 * Console UART receive
+	 */
+	[16 + CONFIG_SYS_NS16550_RX_IRQ] = (unsigned int)&NS16550_rx_isr,
 #endif
 };
 
@@ -159,14 +186,14 @@ void
 	 * Stack grows downwards; the stack base is set-up by the first
 	 * value in the first word in the vectors.
 	 */
-	memcpy(&_data_start, &_data_lma_start, &_data_end - &_data_start);
+	start_copy(&_data_start, &_data_lma_start, &_data_end - &_data_start);
 	memset(&_bss_start, 0, &_bss_end - &_bss_start);
 
 	/*
 	 * Copy RAMCODE separately, if it is separated
 	 */
 #if defined(CONFIG_MEM_RAMCODE_BASE) && defined(CONFIG_MEM_RAMCODE_LEN)
-	memcpy(&_ramcode_start, &_ramcode_lma_start,
+	start_copy(&_ramcode_start, &_ramcode_lma_start,
 		&_ramcode_end - &_ramcode_start);
 #endif
 
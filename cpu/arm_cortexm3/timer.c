@@ -17,13 +17,40 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
  */
 #include <common.h>
+#include <div64.h>
 
+/*
+ * The clock the DWT cycle counter runs at, i.e. the core clock.
+ * On M2S, CLOCK_SYSTICK is the M3 clock.
+ */
+#ifndef CONFIG_ARMCORTEXM3_DWT_CLOCK
+#define CONFIG_ARMCORTEXM3_DWT_CLOCK	CLOCK_SYSTICK
+#endif
+
+/* Core cycle count, extended to 64 bits */
+static unsigned long long cycles;
+static ulong              lastcyc;	/* Last DWT CYCCNT snapshot */
+
+#ifndef CONFIG_ARMCORTEXM3_DWT_TIMER
 /* Internal tick units */
 static unsigned long long timestamp;	/* Monotonic incrementing timer */
 static ulong              lastdec;	/* Last decrementer snapshot */
+#else
+/*
+ * Reciprocal scaling, precomputed for the current core clock:
+ * us = (cycles * mult_us) >> 32, ticks = (cycles * mult_tick) >> 40,
+ * cycles = (us * mult_cyc) >> 16
+ */
+static ulong              rate;		/* Core clock the mults are for */
+static ulong              mult_us;
+static ulong              mult_tick;
+static ulong              mult_cyc;
+static unsigned long long cyc_base;	/* Cycle count at reset_timer() */
+#endif
 
 int timer_init()
 {
+#ifndef CONFIG_ARMCORTEXM3_DWT_TIMER
 	volatile struct cm3_systick *systick =
 		(volatile struct cm3_systick *)CM3_SYSTICK_BASE;
 
@@ -39,10 +66,56 @@ int timer_init()
 #endif
 
 	timestamp = 0;
+#endif
+
+	/*
+	 * Start the DWT cycle counter; it runs at the core clock
+	 */
+	CM3_DEMCR |= CM3_DEMCR_TRCENA;
+	CM3_DWT_REGS->cyccnt = 0;
+	CM3_DWT_REGS->ctrl |= CM3_DWT_CTRL_CYCCNTENA;
+
+	cycles = 0;
+	lastcyc = 0;
 
 	return 0;
 }
 
+/*
+ * Return the number of core clock cycles since timer_init().
+ * The 32-bit DWT counter is extended in software, so this must be
+ * called at least once per counter wrap-around. IRQs are masked while
+ * the extension is updated: an ISR that reads the time in between would
+ * otherwise have its cycles counted twice.
+ */
+unsigned long long cortex_m3_cycles(void)
+{
+	unsigned long long c;
+	unsigned int primask;
+	ulong now;
+
+	asm volatile ("mrs %0, primask\n"
+		      "cpsid i"
+		      : "=r" (primask) : : "memory");
+	now = CM3_DWT_REGS->cyccnt;
+	cycles += (ulong)(now - lastcyc);
+	lastcyc = now;
+	c = cycles;
+	asm volatile ("msr primask, %0" : : "r" (primask) : "memory");
+
+	return c;
+}
+
+/*
+ * Return the rate of cortex_m3_cycles(), in Hz
+ */
+ulong cortex_m3_cycles_rate(void)
+{
+	return clock_get(CONFIG_ARMCORTEXM3_DWT_CLOCK);
+}
+
+#ifndef CONFIG_ARMCORTEXM3_DWT_TIMER
+
 ulong get_timer(ulong base)
 {
 	volatile struct cm3_systick *systick =
@@ -67,6 +140,18 @@ void reset_timer(void)
 	timestamp = 0;
 }
 
+/*
+ * Microseconds since timer_init(), from the DWT cycle counter, which
+ * runs along with the SysTick
+ */
+unsigned long timer_get_us(void)
+{
+	unsigned long long c = cortex_m3_cycles();
+
+	do_div(c, cortex_m3_cycles_rate() / 1000000);
+	return (ulong)c;
+}
+
 /* delay x useconds */
 void __udelay(ulong usec)
 {
@@ -96,6 +181,95 @@ void __udelay(ulong usec)
 	}
 }
 
+#else /* CONFIG_ARMCORTEXM3_DWT_TIMER */
+
+/*
+ * Recompute the scaling factors whenever the core clock changes.
+ * This is a few 64-bit divisions, done once after clock_init(), so
+ * the hot paths below only multiply and shift.
+ *
+ * The factors are truncated, so the results run slightly slow: by at
+ * most 1/mult_us (about 0.04 ppm at 166 MHz) for timer_get_us(), and by
+ * under 1 ppm for get_timer() and udelay().
+ *
+ * Unlike the 24-bit SysTick, which wraps in ~0.1s at 166MHz, the
+ * 32-bit DWT counter only has to be polled once every ~25 seconds.
+ */
+static inline int dwt_timer_scale(void)
+{
+	ulong r = cortex_m3_cycles_rate();
+
+	if (r != rate) {
+		if (!r)
+			return -1;
+		rate = r;
+		mult_us = (ulong)((1000000ULL << 32) / r);
+		mult_tick = (ulong)(((unsigned long long)CONFIG_SYS_HZ << 40) / r);
+		mult_cyc = (ulong)(((unsigned long long)r << 16) / 1000000);
+	}
+
+	return 0;
+}
+
+/*
+ * Compute (c * mult) >> shift, shift >= 32, from two 32x32 bit
+ * multiplications. This is the exact floor of the product, so the
+ * result never goes backwards as c grows.
+ */
+static inline unsigned long long dwt_timer_mul(unsigned long long c,
+					       ulong mult, int shift)
+{
+	unsigned long long hi = (unsigned long long)(ulong)(c >> 32) * mult;
+	unsigned long long lo = (unsigned long long)(ulong)c * mult;
+
+	return (hi + (lo >> 32)) >> (shift - 32);
+}
+
+/*
+ * Microseconds since timer_init()
+ */
+unsigned long timer_get_us(void)
+{
+	unsigned long long c = cortex_m3_cycles();
+
+	if (dwt_timer_scale())
+		return 0;
+
+	return (ulong)dwt_timer_mul(c, mult_us, 32);
+}
+
+ulong get_timer(ulong base)
+{
+	unsigned long long c = cortex_m3_cycles() - cyc_base;
+
+	if (dwt_timer_scale())
+		return 0;
+
+	return (ulong)dwt_timer_mul(c, mult_tick, 40) - base;
+}
+
+void reset_timer(void)
+{
+	cyc_base = cortex_m3_cycles();
+}
+
+/* delay x useconds */
+void __udelay(ulong usec)
+{
+	unsigned long long end;
+
+	if (dwt_timer_scale())
+		return;
+
+	end = cortex_m3_cycles() +
+		(((unsigned long long)usec * mult_cyc) >> 16) + 1;
+
+	while (cortex_m3_cycles() < end)
+		;	/* nop */
+}
+
+#endif /* CONFIG_ARMCORTEXM3_DWT_TIMER */
+
 /*
  * This function is derived from PowerPC code (timebase clock frequency).
  * On ARM it returns the number of timer ticks per second.
@@ -113,4 +287,3 @@ unsigned long long get_ticks(void)
 {
 	return get_timer(0);
 }
-
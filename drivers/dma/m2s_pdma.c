@@ -0,0 +1,94 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * SmartFusion2 MSS Peripheral DMA (PDMA) channel allocator.
+ *
+ * Peripheral drivers (SPI) request their channels here, instead of
+ * owning fixed ones. The PDMA is held in reset while no channel is in
+ * use.
+ */
+
+#include <common.h>
+#include <asm/arch/m2s.h>
+#include <asm/arch/pdma.h>
+
+/*
+ * Allocated channels, bit per channel
+ */
+static u32 pdma_alloc;
+
+int m2s_pdma_request(int chan)
+{
+	int i;
+
+	for (i = 0; i < M2S_PDMA_CHANNELS; i++) {
+		if (chan >= 0 && i != chan)
+			continue;
+		if (!(pdma_alloc & (1 << i)))
+			break;
+	}
+	if (i == M2S_PDMA_CHANNELS)
+		return -1;
+
+	if (!pdma_alloc)
+		M2S_SYSREG->soft_reset_cr &= ~M2S_SYS_SOFT_RST_CR_PDMA;
+	pdma_alloc |= 1 << i;
+
+	return i;
+}
+
+void m2s_pdma_free(int chan)
+{
+	if (chan < 0 || chan >= M2S_PDMA_CHANNELS ||
+	    !(pdma_alloc & (1 << chan)))
+		return;
+
+	MSS_PDMA->chan[chan].control = PDMA_CONTROL_RESET;
+
+	pdma_alloc &= ~(1 << chan);
+	if (!pdma_alloc)
+		M2S_SYSREG->soft_reset_cr |= M2S_SYS_SOFT_RST_CR_PDMA;
+}
+
+void m2s_pdma_setup(int chan, u32 control)
+{
+	volatile struct mss_pdma_chan *ch = &MSS_PDMA->chan[chan];
+
+	/*
+	 * Reset the channel, then take it out of reset.
+	 */
+	ch->control = PDMA_CONTROL_RESET | PDMA_CONTROL_CLR_B |
+		      PDMA_CONTROL_CLR_A;
+	ch->control = 0;
+
+	/*
+	 * Set the control register fields.
+	 * DO NOT use back-to-back read-modify-writes to the control register.
+	 * With certain M3:APB clock ratios, there appears to be a delay
+	 * between when write data is committed, and when that data is
+	 * readable on a following read.  Perhaps this delay only applies
+	 * immediately after a channel reset, but this is not clear.
+	 */
+	ch->control = control;
+}
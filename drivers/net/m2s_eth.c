@@ -62,10 +62,16 @@
 #define M2S_FRM_MAX_LEN		0x600	/* 1536, same as PKTSIZE_ALIGN	      */
 
 /*
- * Just more compact names
+ * Just more compact names. Frames are passed to NetReceive() right from
+ * our rx buffers, NetRxPackets[] are not used; so the rx ring may be
+ * sized apart from them with CONFIG_M2S_ETH_RX_BD_NUM
  */
 #define M2S_TX_BD_NUM		1
+#ifdef CONFIG_M2S_ETH_RX_BD_NUM
+#define M2S_RX_BD_NUM		CONFIG_M2S_ETH_RX_BD_NUM
+#else
 #define M2S_RX_BD_NUM		CONFIG_SYS_RX_ETH_BUFFER
+#endif
 
 /*
  * Different timeouts, in msec
@@ -288,6 +294,9 @@ static  int m2s_eth_init(struct eth_device *dev, bd_t *bd);
 static  int m2s_eth_send(struct eth_device *dev, volatile void *pkt, int len);
 static  int m2s_eth_recv(struct eth_device *dev);
 static void m2s_eth_halt(struct eth_device *dev);
+#ifdef CONFIG_MCAST_TFTP
+static  int m2s_eth_mcast(struct eth_device *dev, u8 *enetaddr, u8 set);
+#endif
 
 static  int m2s_mii_read(char *devname, u8 addr, u8 reg, u16 *val);
 static  int m2s_mii_write(char *devname, u8 addr, u8 reg, u16 val);
@@ -310,6 +319,9 @@ static struct eth_device	m2s_eth_dev = {
 	.halt	= m2s_eth_halt,
 	.send	= m2s_eth_send,
 	.recv	= m2s_eth_recv,
+#ifdef CONFIG_MCAST_TFTP
+	.mcast	= m2s_eth_mcast,
+#endif
 };
 
 /*
@@ -325,6 +337,16 @@ static u8			m2s_mii_speed = M2S_SYS_MAC_CR_LS_100;
  */
 static int			m2s_bd_cur_tx, m2s_bd_cur_rx;
 
+#ifdef CONFIG_MCAST_TFTP
+/*
+ * Multicast filter: 64-bin hash of the joined group addresses, and the
+ * number of groups in each bin (so leaving one of two colliding groups
+ * doesn't drop the other)
+ */
+static u32			m2s_mcast_hash[2];
+static u8			m2s_mcast_refs[64];
+#endif
+
 /*
  * Buffer descriptors (updated by DMA too, so specify them as volatile)
  */
@@ -827,6 +849,75 @@ out:
 	return rv;
 }
 
+#ifdef CONFIG_MCAST_TFTP
+/*
+ * Hash bin of a multicast address: the 6 MSBs of its Ethernet CRC
+ */
+static int m2s_eth_mcast_bin(volatile u8 *enetaddr)
+{
+	return ether_crc(6, (unsigned char const *)enetaddr) >> 26;
+}
+
+/*
+ * Join (set != 0) or leave a multicast group.
+ * The M2S MAC has no destination address hash table of its own: its
+ * A-MCXFIFO passes every multicast frame to the rx ring. So the hash
+ * is kept here, and checked by m2s_eth_recv() before a frame is handed
+ * to the stack; this keeps foreign group traffic (other streams on the
+ * same segment) from costing a NetReceive() each.
+ */
+static int m2s_eth_mcast(struct eth_device *dev, u8 *enetaddr, u8 set)
+{
+	int	bin = m2s_eth_mcast_bin(enetaddr);
+
+	if (set) {
+		if (m2s_mcast_refs[bin] == 0xFF)
+			return -ENOSPC;
+		m2s_mcast_refs[bin]++;
+	} else {
+		if (m2s_mcast_refs[bin] == 0)
+			return -ENOENT;
+		m2s_mcast_refs[bin]--;
+	}
+
+	if (m2s_mcast_refs[bin])
+		m2s_mcast_hash[bin >> 5] |= 1 << (bin & 31);
+	else
+		m2s_mcast_hash[bin >> 5] &= ~(1 << (bin & 31));
+
+	debug("%s: %02x:%02x:%02x:%02x:%02x:%02x bin %d ref %d\n", __func__,
+	      enetaddr[0], enetaddr[1], enetaddr[2],
+	      enetaddr[3], enetaddr[4], enetaddr[5],
+	      bin, m2s_mcast_refs[bin]);
+
+	return 0;
+}
+
+/*
+ * Check if the frame's destination passes the multicast filter.
+ * Unicast and broadcast frames always pass.
+ */
+static int m2s_eth_mcast_match(volatile u8 *frame)
+{
+	int	bin;
+
+	if (!(frame[0] & 0x01))
+		return 1;
+	if ((frame[0] & frame[1] & frame[2] &
+	     frame[3] & frame[4] & frame[5]) == 0xFF)
+		return 1;
+
+	bin = m2s_eth_mcast_bin(frame);
+
+	return (m2s_mcast_hash[bin >> 5] >> (bin & 31)) & 1;
+}
+#else
+static inline int m2s_eth_mcast_match(volatile u8 *frame)
+{
+	return 1;
+}
+#endif /* CONFIG_MCAST_TFTP */
+
 /*
  * Process received frames (if any)
  */
@@ -846,7 +937,8 @@ static int m2s_eth_recv(struct eth_device *dev)
 		 */
 		debug("%s: rx[%d] %x\n", __func__, m2s_bd_cur_rx,
 		      m2s_bd_rx[m2s_bd_cur_rx].cfg_size);
-		NetReceive(bd->frame, bd->cfg_size & M2S_BD_SIZE_MSK);
+		if (m2s_eth_mcast_match(bd->frame))
+			NetReceive(bd->frame, bd->cfg_size & M2S_BD_SIZE_MSK);
 
 		/*
 		 * Update BD, and re-enable RX (for the case of overflow)
@@ -25,6 +25,7 @@
 #include <command.h>
 #include <stdio_dev.h>
 #include <net.h>
+#include <malloc.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -40,6 +41,26 @@ static short nc_port;			/* source/target port */
 static const char *output_packet;	/* used by first send udp */
 static int output_packet_len = 0;
 
+#ifdef CONFIG_NETCONSOLE_BUFFER_SIZE
+/*
+ * Output is collected here and sent when the buffer is full, on a
+ * newline after CONFIG_NETCONSOLE_FLUSH_MS without a flush, or once
+ * the oldest char has waited that long; also whenever input is waited
+ * for. A "md" dump thus goes out in full sized packets instead of one
+ * packet per putc(), and interactive output is not delayed.
+ */
+#ifndef CONFIG_NETCONSOLE_FLUSH_MS
+# define CONFIG_NETCONSOLE_FLUSH_MS	20
+#endif
+static char *output_buffer;		/* malloc()ed, to spare eSRAM */
+static int output_size;
+static ulong output_start;		/* when the oldest char was buffered */
+static ulong output_flushed;		/* when the buffer was last sent */
+#endif
+#ifdef CONFIG_NETCONSOLE_POLL_MS
+static ulong input_polled;		/* when nc_tstc() last polled the net */
+#endif
+
 static void nc_wait_arp_handler (uchar * pkt, unsigned dest, unsigned src,
 				 unsigned len)
 {
@@ -166,32 +187,127 @@ static int nc_start(void)
 	else
 		memset (nc_ether, 0, sizeof nc_ether);	/* force arp request */
 
+#ifdef CONFIG_NETCONSOLE_BUFFER_SIZE
+	/* Without a buffer, output goes out unbuffered */
+	if (!output_buffer)
+		output_buffer = malloc (CONFIG_NETCONSOLE_BUFFER_SIZE);
+#endif
+
 	return 0;
 }
 
+#ifdef CONFIG_NETCONSOLE_BUFFER_SIZE
+static void nc_flush_output(void)
+{
+	if (!output_size)
+		return;
+
+	nc_send_packet (output_buffer, output_size);
+	output_size = 0;
+	output_flushed = get_timer (0);
+}
+
+static void nc_buffer(const char *s, int len)
+{
+	int n;
+
+	if (!output_buffer) {
+		nc_send_packet (s, len);
+		return;
+	}
+
+	while (len) {
+		if (!output_size)
+			output_start = get_timer (0);
+
+		n = min(len, CONFIG_NETCONSOLE_BUFFER_SIZE - output_size);
+		memcpy (output_buffer + output_size, s, n);
+		output_size += n;
+		s += n;
+		len -= n;
+
+		if (output_size == CONFIG_NETCONSOLE_BUFFER_SIZE)
+			nc_flush_output ();
+	}
+
+	if (output_size &&
+	    (get_timer (output_start) >= CONFIG_NETCONSOLE_FLUSH_MS ||
+	     (output_buffer[output_size - 1] == '\n' &&
+	      get_timer (output_flushed) >= CONFIG_NETCONSOLE_FLUSH_MS)))
+		nc_flush_output ();
+}
+
+/*
+ * Send what is buffered, e.g. before handing over to an OS, a reset
+ * or a hang()
+ */
+void nc_flush(void)
+{
+	if (output_recursion)
+		return;
+	output_recursion = 1;
+
+	nc_flush_output ();
+
+	output_recursion = 0;
+}
+
+/*
+ * Called from the net loop, and from tstc(): send output that has
+ * waited CONFIG_NETCONSOLE_FLUSH_MS, even if nothing is printed after
+ * it (e.g. a line of TFTP hashes)
+ */
+void nc_poll(void)
+{
+	struct eth_device *eth;
+
+	if (!output_size ||
+	    get_timer (output_start) < CONFIG_NETCONSOLE_FLUSH_MS)
+		return;
+
+	/* The server can't be ARPed for from inside a net loop: wait */
+	eth = eth_get_dev ();
+	if (eth && eth->state == ETH_STATE_ACTIVE &&
+	    !memcmp (nc_ether, NetEtherNullAddr, 6))
+		return;
+
+	nc_flush ();
+}
+#endif
+
 static void nc_putc(char c)
 {
 	if (output_recursion)
 		return;
 	output_recursion = 1;
 
+#ifdef CONFIG_NETCONSOLE_BUFFER_SIZE
+	nc_buffer (&c, 1);
+#else
 	nc_send_packet (&c, 1);
+#endif
 
 	output_recursion = 0;
 }
 
 static void nc_puts(const char *s)
 {
+#ifndef CONFIG_NETCONSOLE_BUFFER_SIZE
 	int len;
+#endif
 
 	if (output_recursion)
 		return;
 	output_recursion = 1;
 
+#ifdef CONFIG_NETCONSOLE_BUFFER_SIZE
+	nc_buffer (s, strlen (s));
+#else
 	if ((len = strlen (s)) > 512)
 		len = 512;
 
 	nc_send_packet (s, len);
+#endif
 
 	output_recursion = 0;
 }
@@ -200,6 +316,7 @@ static int nc_getc(void)
 {
 	uchar c;
 
+	nc_flush ();
 	input_recursion = 1;
 
 	net_timeout = 0;	/* no timeout */
@@ -231,6 +348,14 @@ static int nc_tstc(void)
 	if (eth && eth->state == ETH_STATE_ACTIVE)
 		return 0;	/* inside net loop */
 
+	nc_poll ();
+#ifdef CONFIG_NETCONSOLE_POLL_MS
+	/* Every poll is a full NetLoop(), so don't let ctrlc() spin on it */
+	if (get_timer (input_polled) < CONFIG_NETCONSOLE_POLL_MS)
+		return 0;
+	input_polled = get_timer (0);
+#endif
+
 	input_recursion = 1;
 
 	net_timeout = 1;
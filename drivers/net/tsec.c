@@ -66,7 +66,7 @@ static int tsec_miiphy_read(char *devname, unsigned char addr,
 			    unsigned char reg, unsigned short *value);
 #endif
 #ifdef CONFIG_MCAST_TFTP
-static int tsec_mcast_addr (struct eth_device *dev, u8 mcast_mac, u8 set);
+static int tsec_mcast_addr (struct eth_device *dev, u8 *mcast_mac, u8 set);
 #endif
 
 /* Default initializations for TSEC controllers. */
@@ -1942,7 +1942,7 @@ static int tsec_miiphy_write(char *devname, unsigned char addr,
  * for PowerPC (tm) is usually the case) in the tregister holds
  * the entry. */
 static int
-tsec_mcast_addr (struct eth_device *dev, u8 mcast_mac, u8 set)
+tsec_mcast_addr (struct eth_device *dev, u8 *mcast_mac, u8 set)
 {
 	struct tsec_private *priv = privlist[1];
 	volatile tsec_t *regs = priv->regs;
@@ -7,6 +7,9 @@
 #include <config.h>
 #include <ns16550.h>
 #include <watchdog.h>
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+#include <common.h>
+#endif
 
 #define UART_LCRVAL UART_LCR_8N1		/* 8 data, 1 stop, no parity */
 #define UART_MCRVAL (UART_MCR_DTR | \
@@ -15,6 +18,59 @@
 		     UART_FCR_RXSR |	\
 		     UART_FCR_TXSR)		/* Clear & enable FIFOs */
 
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+/*
+ * Interrupt-driven receive for the console port.
+ * The ISR empties the RX FIFO into a ring buffer, so that input is not
+ * lost while U-Boot is busy elsewhere. getc/tstc also drain the FIFO
+ * themselves, with IRQs masked, so that input still works from code
+ * that runs with IRQs disabled.
+ */
+#ifndef CONFIG_SYS_NS16550_RX_BUFSIZE
+#define CONFIG_SYS_NS16550_RX_BUFSIZE	1024
+#endif
+#if CONFIG_SYS_NS16550_RX_BUFSIZE & (CONFIG_SYS_NS16550_RX_BUFSIZE - 1)
+# error "CONFIG_SYS_NS16550_RX_BUFSIZE must be a power of 2"
+#endif
+
+/* Raise the RX IRQ once this many characters are in the FIFO */
+#ifndef CONFIG_SYS_NS16550_RX_TRIGGER
+#define CONFIG_SYS_NS16550_RX_TRIGGER	UART_FCR_TRIGGER_8
+#endif
+
+static struct {
+	NS16550_t		port;
+	volatile unsigned int	head;	/* Advanced by the ISR only	*/
+	volatile unsigned int	tail;	/* Advanced by getc only	*/
+	unsigned char		buf[CONFIG_SYS_NS16550_RX_BUFSIZE];
+} rx;
+
+#define RX_RING_MASK	(CONFIG_SYS_NS16550_RX_BUFSIZE - 1)
+
+#undef UART_FCRVAL
+#define UART_FCRVAL (UART_FCR_FIFO_EN |	\
+		     UART_FCR_RXSR |	\
+		     UART_FCR_TXSR |	\
+		     CONFIG_SYS_NS16550_RX_TRIGGER)
+#endif
+
+#ifdef CONFIG_SYS_M2S
+/*
+ * Bits 16-21 of the divisor are the fractional part, in 1/64ths
+ */
+static void NS16550_set_frac (NS16550_t com_port, int baud_divisor)
+{
+	int frac = (baud_divisor >> 16) & 0x3f;
+
+	if (frac) {
+		com_port->dfr = frac;
+		com_port->mm0 |= UART_MM0_EFBR;
+	} else {
+		com_port->mm0 &= ~UART_MM0_EFBR;
+	}
+}
+#endif
+
 void NS16550_init (NS16550_t com_port, int baud_divisor)
 {
 
@@ -31,8 +87,12 @@ void NS16550_init (NS16550_t com_port, int baud_divisor)
 	com_port->lcr = UART_LCR_BKSE | UART_LCRVAL;
 	com_port->dll = baud_divisor & 0xff;
 	com_port->dlm = (baud_divisor >> 8) & 0xff;
+#ifdef CONFIG_SYS_M2S
+	NS16550_set_frac(com_port, baud_divisor);
+#else
 	if ((baud_divisor >> 16) & 0xff)
 		com_port->regA = (baud_divisor >> 16) & 0xff;
+#endif
 	com_port->lcr = UART_LCRVAL;
 #if defined(CONFIG_OMAP) && !defined(CONFIG_OMAP3_ZOOM2)
 #if defined(CONFIG_APTIX)
@@ -56,10 +116,67 @@ void NS16550_reinit (NS16550_t com_port, int baud_divisor)
 	com_port->lcr = UART_LCR_BKSE;
 	com_port->dll = baud_divisor & 0xff;
 	com_port->dlm = (baud_divisor >> 8) & 0xff;
+#ifdef CONFIG_SYS_M2S
+	NS16550_set_frac(com_port, baud_divisor);
+#endif
 	com_port->lcr = UART_LCRVAL;
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	if (com_port == rx.port)
+		com_port->ier = UART_IER_RDI;
+#endif
 }
 #endif /* CONFIG_NS16550_MIN_FUNCTIONS */
 
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+/*
+ * Switch com_port to interrupt-driven receive.
+ * The caller enables the port IRQ in the interrupt controller.
+ */
+void NS16550_rx_irq_init (NS16550_t com_port)
+{
+	rx.head = rx.tail = 0;
+	rx.port = com_port;
+	com_port->fcr = UART_FCRVAL;
+	com_port->ier = UART_IER_RDI;
+}
+
+/*
+ * Called for both the trigger level and the character timeout IRQ
+ */
+void NS16550_rx_isr (void)
+{
+	NS16550_t com_port = rx.port;
+	unsigned int head = rx.head;
+
+	if (!com_port)
+		return;
+
+	while (com_port->lsr & UART_LSR_DR) {
+		unsigned char c = com_port->rbr;
+
+		/* Drop the character if the ring is full */
+		if (head - rx.tail < CONFIG_SYS_NS16550_RX_BUFSIZE)
+			rx.buf[head++ & RX_RING_MASK] = c;
+	}
+	rx.head = head;
+}
+
+static int NS16550_rx_ready (void)
+{
+	int flag;
+
+	if (rx.head != rx.tail)
+		return 1;
+
+	flag = disable_interrupts();
+	NS16550_rx_isr();
+	if (flag)
+		enable_interrupts();
+
+	return rx.head != rx.tail;
+}
+#endif /* CONFIG_SYS_NS16550_RX_IRQ */
+
 void NS16550_putc (NS16550_t com_port, char c)
 {
 	while ((com_port->lsr & UART_LSR_THRE) == 0);
@@ -69,6 +186,17 @@ void NS16550_putc (NS16550_t com_port, char c)
 #ifndef CONFIG_NS16550_MIN_FUNCTIONS
 char NS16550_getc (NS16550_t com_port)
 {
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	if (com_port == rx.port) {
+		char c;
+
+		while (!NS16550_rx_ready())
+			WATCHDOG_RESET();
+		c = rx.buf[rx.tail & RX_RING_MASK];
+		rx.tail++;
+		return c;
+	}
+#endif
 	while ((com_port->lsr & UART_LSR_DR) == 0) {
 #ifdef CONFIG_USB_TTY
 		extern void usbtty_poll(void);
@@ -81,6 +209,10 @@ char NS16550_getc (NS16550_t com_port)
 
 int NS16550_tstc (NS16550_t com_port)
 {
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	if (com_port == rx.port)
+		return NS16550_rx_ready();
+#endif
 	return ((com_port->lsr & UART_LSR_DR) != 0);
 }
 
@@ -151,6 +151,23 @@ static int calc_divisor (NS16550_t port)
 		return CONFIG_SERIAL0_SPECIAL_BAUDRATE;
 #endif
 
+#ifdef CONFIG_SYS_M2S
+	{
+		/*
+		 * The MMUART divisor has a 1/64 fraction (bits 16-21 here),
+		 * without which 460800 and 921600 baud are well off
+		 * at the usual PCLK0 rates.
+		 */
+		ulong clk = CONFIG_SYS_NS16550_CLK;
+		ulong div64 = (clk * (64 / MODE_X_DIV) + gd->baudrate / 2) /
+			gd->baudrate;
+
+		if (div64 < 64)
+			div64 = 64;
+		return (div64 >> 6) | ((div64 & 0x3f) << 16);
+	}
+#endif
+
 	/* Compute divisor value. Normally, we should simply return:
 	 *   CONFIG_SYS_NS16550_CLK) / MODE_X_DIV / gd->baudrate
 	 * but we need to round that value by adding 0.5.
@@ -186,6 +203,15 @@ int serial_init (void)
 	NS16550_init(serial_ports[3], clock_divisor);
 #endif
 
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+	/*
+	 * CONFIG_SYS_NS16550_RX_IRQ is the console IRQ number in the
+	 * Cortex-M3 NVIC; IRQs get unmasked by enable_interrupts()
+	 */
+	NS16550_rx_irq_init(CONSOLE);
+	cortex_m3_irq_enable(CONFIG_SYS_NS16550_RX_IRQ, 1);
+#endif
+
 	return (0);
 }
 #endif
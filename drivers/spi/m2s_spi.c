@@ -24,6 +24,7 @@
 #include <spi.h>
 #include <malloc.h>
 #include <clock.h>
+#include <asm/arch/pdma.h>
 
 #undef NO_PDMA
 
@@ -42,17 +43,11 @@
 #define MSS_SPI0_REGS			0x40001000
 #define MSS_SPI1_REGS			0x40011000
 
-/*
- * Base address of PDMA controller
- */
-#define MSS_PDMA_REGS			0x40003000
-
 /*
  * Some bits in various regs
  */
 #define M2S_SYS_SOFT_RST_CR_SPI1	(1 << 10)
 #define M2S_SYS_SOFT_RST_CR_SPI0	(1 << 9)
-#define M2S_SYS_SOFT_RST_CR_PDMA	(1 << 5)
 
 #define SPI_CONTROL_ENABLE		(1 << 0)
 #define SPI_CONTROL_MASTER		(1 << 1)
@@ -69,41 +64,11 @@
 
 #define SPI_STATUS_RXFIFOEMP		(1 << 6)
 
-/*
- * PDMA register bits
- */
-#define PDMA_CONTROL_PER_SEL_SPI0_RX	(0x4 << 23)
-#define PDMA_CONTROL_PER_SEL_SPI0_TX	(0x5 << 23)
-#define PDMA_CONTROL_PER_SEL_SPI1_RX	(0x6 << 23)
-#define PDMA_CONTROL_PER_SEL_SPI1_TX	(0x7 << 23)
-/*
- * TBD: calculte ADJ value dynamically, basing on SPI clk value?
- * With smaller values we just hang-up
- */
-#define PDMA_CONTROL_WRITE_ADJ		(0xF << 14)
-
-#define PDMA_CONTROL_DST_ADDR_INC_MSK	(0x3 << 12)
-#define PDMA_CONTROL_DST_ADDR_INC_0	(0x0 << 12)
-#define PDMA_CONTROL_DST_ADDR_INC_1	(0x1 << 12)
-#define PDMA_CONTROL_SRC_ADDR_INC_MSK	(0x3 << 10)
-#define PDMA_CONTROL_SRC_ADDR_INC_0	(0x0 << 10)
-#define PDMA_CONTROL_SRC_ADDR_INC_1	(0x1 << 10)
-#define PDMA_CONTROL_CLR_B		(1 << 8)
-#define PDMA_CONTROL_CLR_A		(1 << 7)
-#define PDMA_CONTROL_RESET		(1 << 5)
-#define PDMA_CONTROL_PAUSE		(1 << 4)
-#define PDMA_CONTROL_XFER_SIZE_1B	(0x0 << 2)
-#define PDMA_CONTROL_DIR		(1 << 1)
-#define PDMA_CONTROL_PERIPH		(1 << 0)
-
-#define PDMA_STATUS_BUF_SEL		(1 << 2)
-
 /*
  * Access handle for the control registers
  */
 #define MSS_SPI_REGS(regs)	((volatile struct mss_spi *)(regs))
 #define MSS_SPI(s)		(MSS_SPI_REGS(s->regs))
-#define MSS_PDMA		((volatile struct mss_pdma *)MSS_PDMA_REGS)
 
 /*
  * Service to print debug messages
@@ -154,25 +119,6 @@ struct mss_spi {
 	u32	ris;
 };
 
- /*
-  * Peripheral DMA registers
-  */
-struct mss_pdma {
-	u32	ratio;
-	u32	status;
-	u32	reserved[(0x20 - 0x08) >> 2];
-	struct mss_pdma_chan {
-		u32	control;
-		u32	status;
-		struct {
-			u32	src;
-			u32	dst;
-			u32	cnt;
-		} buf[2];			/* Buffers A-B */
-	} chan[8];				/* Channels 0-7 */
-};
-
-
 #if defined(SPI_M2S_DEBUG)
 /*
  * Driver verbosity level: 0->silent; >0->verbose (1 to 4, growing verbosity)
@@ -180,11 +126,6 @@ struct mss_pdma {
 static int spi_m2s_debug = 4;
 #endif
 
-/*
- * PDMA usage counter
- */
-static int pdma_used;
-
 /*
  * Handler to get access to the driver specific slave data structure
  * @param c		generic slave
@@ -432,8 +373,6 @@ struct spi_slave *spi_setup_slave(unsigned int b, unsigned int cs,
 		s->regs = (void *)MSS_SPI0_REGS;
 		s->hb = clock_get(CLOCK_PCLK0);
 
-		s->drx = 0;
-		s->dtx = 1;
 		s->drx_sel = PDMA_CONTROL_PER_SEL_SPI0_RX;
 		s->dtx_sel = PDMA_CONTROL_PER_SEL_SPI0_TX;
 
@@ -442,8 +381,6 @@ struct spi_slave *spi_setup_slave(unsigned int b, unsigned int cs,
 		s->regs = (void *)MSS_SPI1_REGS;
 		s->hb = clock_get(CLOCK_PCLK1);
 
-		s->drx = 2;
-		s->dtx = 3;
 		s->drx_sel = PDMA_CONTROL_PER_SEL_SPI1_RX;
 		s->dtx_sel = PDMA_CONTROL_PER_SEL_SPI1_TX;
 
@@ -483,6 +420,7 @@ int spi_claim_bus(struct spi_slave *slv)
 {
 	unsigned int ret = 0;
 	struct m2s_spi_slave *s = to_m2s_spi(slv);
+	int drx, dtx;
 
 	/*
 	 * Reset the MSS SPI controller and then bring it out of reset
@@ -519,46 +457,33 @@ int spi_claim_bus(struct spi_slave *slv)
 	MSS_SPI(s)->control |= SPI_CONTROL_ENABLE;
 
 	/*
-	 * Configure DMA (preliminary)
-	 */
-	if (!pdma_used++)
-		M2S_SYSREG->soft_reset_cr &= ~M2S_SYS_SOFT_RST_CR_PDMA;
-
-	/*
-	 * Reset the PDMA channels for RX and TX.
+	 * Get PDMA channels for RX and TX, and set them up
 	 */
-	MSS_PDMA->chan[s->drx].control = PDMA_CONTROL_RESET |
-					 PDMA_CONTROL_CLR_B |
-					 PDMA_CONTROL_CLR_A;
-	MSS_PDMA->chan[s->dtx].control = PDMA_CONTROL_RESET |
-					 PDMA_CONTROL_CLR_B |
-					 PDMA_CONTROL_CLR_A;
-
-	/*
-	 * Take the PDMA channels out of reset.
-	*/
-	MSS_PDMA->chan[s->drx].control = 0;
-	MSS_PDMA->chan[s->dtx].control = 0;
-
-	/*
-	 * Set the PDMA channel control register fields.
-	 * DO NOT use back-to-back read-modify-writes to the control register.
-	 * With certain M3:APB clock ratios, there appears to be a delay
-	 * between when write data is committed, and when that data is
-	 * readable on a following read.  Perhaps this delay only applies
-	 * immediately after a channel reset, but this is not clear.
-	 */
-	MSS_PDMA->chan[s->drx].control = s->drx_sel |
-					 PDMA_CONTROL_WRITE_ADJ |
-					 PDMA_CONTROL_SRC_ADDR_INC_0 |
-					 PDMA_CONTROL_XFER_SIZE_1B |
-					 PDMA_CONTROL_PERIPH;
-	MSS_PDMA->chan[s->dtx].control = s->dtx_sel |
-					 PDMA_CONTROL_WRITE_ADJ |
-					 PDMA_CONTROL_DST_ADDR_INC_0 |
-					 PDMA_CONTROL_XFER_SIZE_1B |
-					 PDMA_CONTROL_DIR |
-					 PDMA_CONTROL_PERIPH;
+	drx = m2s_pdma_request(-1);
+	dtx = m2s_pdma_request(-1);
+	if (drx < 0 || dtx < 0) {
+		printf("%s: no free PDMA channels\n", __func__);
+		m2s_pdma_free(drx);
+		m2s_pdma_free(dtx);
+		MSS_SPI(s)->control &= ~SPI_CONTROL_ENABLE;
+		M2S_SYSREG->soft_reset_cr |= s->rst_clr;
+		ret = -1;
+		goto done;
+	}
+	s->drx = drx;
+	s->dtx = dtx;
+
+	m2s_pdma_setup(s->drx, s->drx_sel |
+			       PDMA_CONTROL_WRITE_ADJ |
+			       PDMA_CONTROL_SRC_ADDR_INC_0 |
+			       PDMA_CONTROL_XFER_SIZE_1B |
+			       PDMA_CONTROL_PERIPH);
+	m2s_pdma_setup(s->dtx, s->dtx_sel |
+			       PDMA_CONTROL_WRITE_ADJ |
+			       PDMA_CONTROL_DST_ADDR_INC_0 |
+			       PDMA_CONTROL_XFER_SIZE_1B |
+			       PDMA_CONTROL_DIR |
+			       PDMA_CONTROL_PERIPH);
 
 	d_printk(2, "bus=%d,soft_reset_cr=0x%x,control=0x%x\n",
 		slv->bus, M2S_SYSREG->soft_reset_cr, MSS_SPI(s)->control);
@@ -567,6 +492,7 @@ int spi_claim_bus(struct spi_slave *slv)
 		s->drx, MSS_PDMA->chan[s->drx].control,
 		s->dtx, MSS_PDMA->chan[s->dtx].control);
 
+done:
 	d_printk(2, "slv=%p\n", slv);
 	return ret;
 }
@@ -582,10 +508,8 @@ void spi_release_bus(struct spi_slave *slv)
 	/*
 	 * Reset DMAs
 	 */
-	MSS_PDMA->chan[s->drx].control = PDMA_CONTROL_RESET;
-	MSS_PDMA->chan[s->dtx].control = PDMA_CONTROL_RESET;
-	if (!--pdma_used)
-		M2S_SYSREG->soft_reset_cr |= M2S_SYS_SOFT_RST_CR_PDMA;
+	m2s_pdma_free(s->drx);
+	m2s_pdma_free(s->dtx);
 
 	/*
 	 * Disable the SPI contoller
@@ -48,6 +48,23 @@ struct cm3_scb {
 #define CM3_ICSR_VECTACT_MSK		0xFF
 
 
+/* NVIC Base Address */
+#define CM3_NVIC_BASE			0xE000E100
+struct cm3_nvic {
+	uint32_t iser[8];		/* Interrupt Set-Enable Registers */
+	uint32_t rsv0[24];
+	uint32_t icer[8];		/* Interrupt Clear-Enable Registers */
+	uint32_t rsv1[24];
+	uint32_t ispr[8];		/* Interrupt Set-Pending Registers */
+	uint32_t rsv2[24];
+	uint32_t icpr[8];		/* Interrupt Clear-Pending Registers */
+	uint32_t rsv3[24];
+	uint32_t iabr[8];		/* Interrupt Active Bit Registers */
+	uint32_t rsv4[56];
+	uint8_t ip[240];		/* Interrupt Priority Registers */
+};
+#define CM3_NVIC_REGS		((volatile struct cm3_nvic *)CM3_NVIC_BASE)
+
 /* MPU Base Address */
 #define CM3_MPU_BASE			0xE000ED90
 struct cm3_mpu {
@@ -103,7 +120,26 @@ struct cm3_systick {
 /* System Tick clock source selection: 1=CPU, 0=STCLK (external clock pin) */
 #define CM3_SYSTICK_CTRL_SYSTICK_CPU	(1 << 2)
 
+/* Debug Exception and Monitor Control Register */
+#define CM3_DEMCR			(*(volatile uint32_t *)0xE000EDFC)
+/* Enable the DWT and ITM units */
+#define CM3_DEMCR_TRCENA		(1 << 24)
+
+/* DWT Base Address */
+#define CM3_DWT_BASE			0xE0001000
+struct cm3_dwt {
+	uint32_t ctrl;			/* Control Register */
+	uint32_t cyccnt;		/* Cycle Count Register */
+};
+#define CM3_DWT_REGS		((volatile struct cm3_dwt *)CM3_DWT_BASE)
+
+/* Cycle counter enable */
+#define CM3_DWT_CTRL_CYCCNTENA		(1 << 0)
+
 u8 cortex_m3_irq_vec_get(void);
+void cortex_m3_irq_enable(int irq, int enable);
+unsigned long long cortex_m3_cycles(void);
+ulong cortex_m3_cycles_rate(void);
 
 void cortex_m3_mpu_set_region(u32 region, u32 address, u32 attr);
 void cortex_m3_mpu_enable(int enable);
@@ -76,6 +76,11 @@ struct m2s_sysreg {
 	unsigned int	mssddr_pll_status;
 };
 
+/*
+ * NVIC IRQ number of the COMBLK (System Controller mailbox)
+ */
+#define M2S_COMBLK_IRQ			19
+
 /*
  * SYSREG access handle
  */
@@ -0,0 +1,109 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * SmartFusion2 MSS Peripheral DMA (PDMA) controller.
+ */
+#ifndef _MACH_M2S_PDMA_H_
+#define _MACH_M2S_PDMA_H_
+
+#include <linux/types.h>
+
+/*
+ * Base address of PDMA controller
+ */
+#define MSS_PDMA_REGS			0x40003000
+
+#define M2S_SYS_SOFT_RST_CR_PDMA	(1 << 5)
+
+#define M2S_PDMA_CHANNELS		8
+
+/*
+ * PDMA register bits
+ */
+#define PDMA_CONTROL_PER_SEL_SPI0_RX	(0x4 << 23)
+#define PDMA_CONTROL_PER_SEL_SPI0_TX	(0x5 << 23)
+#define PDMA_CONTROL_PER_SEL_SPI1_RX	(0x6 << 23)
+#define PDMA_CONTROL_PER_SEL_SPI1_TX	(0x7 << 23)
+/*
+ * TBD: calculte ADJ value dynamically, basing on SPI clk value?
+ * With smaller values we just hang-up
+ */
+#define PDMA_CONTROL_WRITE_ADJ		(0xF << 14)
+
+#define PDMA_CONTROL_DST_ADDR_INC_MSK	(0x3 << 12)
+#define PDMA_CONTROL_DST_ADDR_INC_0	(0x0 << 12)
+#define PDMA_CONTROL_DST_ADDR_INC_1	(0x1 << 12)
+#define PDMA_CONTROL_DST_ADDR_INC_4	(0x3 << 12)
+#define PDMA_CONTROL_SRC_ADDR_INC_MSK	(0x3 << 10)
+#define PDMA_CONTROL_SRC_ADDR_INC_0	(0x0 << 10)
+#define PDMA_CONTROL_SRC_ADDR_INC_1	(0x1 << 10)
+#define PDMA_CONTROL_SRC_ADDR_INC_4	(0x3 << 10)
+#define PDMA_CONTROL_CLR_B		(1 << 8)
+#define PDMA_CONTROL_CLR_A		(1 << 7)
+#define PDMA_CONTROL_RESET		(1 << 5)
+#define PDMA_CONTROL_PAUSE		(1 << 4)
+#define PDMA_CONTROL_XFER_SIZE_1B	(0x0 << 2)
+#define PDMA_CONTROL_XFER_SIZE_4B	(0x2 << 2)
+#define PDMA_CONTROL_DIR		(1 << 1)
+#define PDMA_CONTROL_PERIPH		(1 << 0)
+
+#define PDMA_STATUS_BUF_SEL		(1 << 2)
+
+ /*
+  * Peripheral DMA registers
+  */
+struct mss_pdma {
+	u32	ratio;
+	u32	status;
+	u32	reserved[(0x20 - 0x08) >> 2];
+	struct mss_pdma_chan {
+		u32	control;
+		u32	status;
+		struct {
+			u32	src;
+			u32	dst;
+			u32	cnt;
+		} buf[2];			/* Buffers A-B */
+	} chan[M2S_PDMA_CHANNELS];		/* Channels 0-7 */
+};
+
+#define MSS_PDMA		((volatile struct mss_pdma *)MSS_PDMA_REGS)
+
+/*
+ * Allocate a channel: "chan" itself, or any free one if "chan" is -1.
+ * Returns the channel number, or -1 if none is free.
+ */
+int m2s_pdma_request(int chan);
+
+/*
+ * Reset a channel and return it to the allocator
+ */
+void m2s_pdma_free(int chan);
+
+/*
+ * Reset a channel and load its control register with "control"
+ */
+void m2s_pdma_setup(int chan, u32 control);
+
+#endif /* _MACH_M2S_PDMA_H_ */
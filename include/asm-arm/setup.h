@@ -197,6 +197,21 @@ struct tag_dmamem {
 	unsigned long	sz_fb;	/* size of fb at start of dmamem */
 };
 
+/* boot stage timestamps, in microseconds since timer start */
+#define ATAG_BOOTSTAGE	0x42535447	/* "BSTG" */
+
+#define BOOTSTAGE_NAME_LEN	20
+
+struct tag_bootstage_rec {
+	u32	time_us;
+	char	name[BOOTSTAGE_NAME_LEN];
+};
+
+struct tag_bootstage {
+	u32	count;
+	struct tag_bootstage_rec rec[1];	/* this is the minimum size */
+};
+
 /* acorn RiscPC specific information */
 #define ATAG_ACORN	0x41000101
 
@@ -227,6 +242,7 @@ struct tag {
 		struct tag_videolfb	videolfb;
 		struct tag_cmdline	cmdline;
 		struct tag_dmamem	dmamem;
+		struct tag_bootstage	bootstage;
 
 		/*
 		 * Acorn specific
@@ -0,0 +1,55 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Boot stage timestamps
+ */
+#ifndef __BOOTSTAGE_H__
+#define __BOOTSTAGE_H__
+
+#ifdef CONFIG_BOOTSTAGE
+
+/*
+ * Record the current time under "name". A non-zero "id" is reported
+ * alongside the name, e.g. the address of an init_sequence[] function.
+ * "name" must be a string constant; only the pointer is kept.
+ */
+void bootstage_mark_id(const char *name, ulong id);
+
+#define bootstage_mark(name)	bootstage_mark_id(name, 0)
+
+/*
+ * Get record "i" for hand-off to the OS. "name" is filled in with
+ * at most "len" bytes, including the terminating NUL.
+ * Returns 0 on success, -1 if there is no such record.
+ */
+int bootstage_get(int i, ulong *time_us, char *name, int len);
+
+#else
+
+#define bootstage_mark_id(name, id)	do { } while (0)
+#define bootstage_mark(name)		do { } while (0)
+
+#endif /* CONFIG_BOOTSTAGE */
+
+#endif /* __BOOTSTAGE_H__ */
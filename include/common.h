@@ -300,6 +300,10 @@ void	forceenv     (char *, char *);
 int env_complete(char *var, int maxv, char *cmdv[], int maxsz, char *buf);
 #endif
 int get_env_id (void);
+#ifdef CONFIG_ENV_HASH
+extern int env_hash_enabled;
+void env_hash_invalidate (void);
+#endif
 
 void	pci_init      (void);
 void	pci_init_board(void);
@@ -664,6 +668,9 @@ int	init_timebase (void);
 int gunzip(void *, int, unsigned char *, unsigned long *);
 int zunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
 						int stoponerr, int offset);
+int gunzip_stream_start(void *dst, int dstlen);
+int gunzip_stream_feed(unsigned char *src, unsigned long len);
+long gunzip_stream_end(void);
 
 /* lib_generic/net_utils.c */
 #include <net.h>
@@ -674,6 +681,7 @@ static inline IPaddr_t getenv_IPaddr (char *var)
 
 /* lib_generic/time.c */
 void	udelay        (unsigned long);
+unsigned long timer_get_us (void);	/* CPUs may override it */
 
 /* lib_generic/vsprintf.c */
 ulong	simple_strtoul(const char *cp,char **endp,unsigned int base);
@@ -128,4 +128,17 @@ typedef unsigned int            uintptr_t;
 #define likely(x)	__builtin_expect(!!(x), 1)
 #define unlikely(x)	__builtin_expect(!!(x), 0)
 
+/*
+ * Hot library code and its lookup tables may be run from on-chip RAM
+ * rather than executed in place from (slower) internal Flash.
+ * Calls from Flash reach these functions through linker veneers.
+ */
+#if !defined(USE_HOSTCC) && defined(CONFIG_ARMCORTEXM3_HOTCODE)
+#define __hotcode	__attribute__((section(".ramcode"), long_call))
+#define __hotdata	__attribute__((section(".ramdata")))
+#else
+#define __hotcode
+#define __hotdata
+#endif
+
 #endif
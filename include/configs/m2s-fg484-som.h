@@ -166,6 +166,11 @@
  */
 #define CONFIG_SYS_NO_FLASH
 
+/*
+ * Configure the PDMA controller driver
+ */
+#define CONFIG_M2S_PDMA
+
 /*
  * Configure the SPI controller device driver
  * FIFO Size is 64K, but leave 5 bytes for cmd[] + addr[]
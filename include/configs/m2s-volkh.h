@@ -79,6 +79,8 @@
 #define CONFIG_SYS_PROMPT		"M2S-VOLKH> "
 #define CONFIG_SYS_PROMPT_HUSH_PS2	"> "
 #define CONFIG_SYS_HUSH_PARSER
+#define CONFIG_SYS_HUSH_CACHE
+#define CONFIG_SYS_CMD_INDEX
 
 /*
  * We want to call the CPU specific initialization
@@ -95,6 +97,19 @@
  */
 #define CONFIG_SYS_HZ			1000
 
+/*
+ * Use the 32-bit DWT cycle counter rather than the 24-bit SysTick
+ * as the time base for get_timer(), udelay() and timer_get_us()
+ */
+#define CONFIG_ARMCORTEXM3_DWT_TIMER
+
+/*
+ * Record boot stage timestamps (timer_get_us(), from the DWT counter),
+ * report them with "bootstage" and pass them to Linux in an ATAG
+ */
+#define CONFIG_BOOTSTAGE
+#define CONFIG_BOOTSTAGE_MAX		32
+
 /*
  * Enable/disable h/w watchdog
  */
@@ -134,6 +149,29 @@
 #define CONFIG_MEM_MALLOC_LEN		( 0 * 1024)
 #define CONFIG_MEM_STACK_LEN		( 4 * 1024)
 
+/*
+ * eSRAM budget (64 KB):
+ * - 0x20000000 .. 0x20007FFF: .data and .bss. About 30 KB is used:
+ *   Ethernet buffer descriptors 6.2 KB, network packet buffers 5 KB,
+ *   UART RX ring 4 KB, NFS 2.2 KB, environment and its hash 3 KB,
+ *   xyzModem 1.1 KB, malloc state 1.1 KB, hush 1 KB, eNVM page
+ *   buffer 0.6 KB.
+ * - 0x20008000 .. 0x20008FFF: stack.
+ * - 0x20009000 .. 0x2000CFFF: .ramcode and .ramdata (eNVM write and
+ *   reset code, plus the hot code below, about 4 KB in all).
+ * - 0x2000FFF4: FPGA update flag, see CONFIG_FPGAUPDATE_ADDR.
+ * The link fails if a region overflows.
+ */
+#define CONFIG_MEM_RAMCODE_BASE		0x20009000
+#define CONFIG_MEM_RAMCODE_LEN		(16 * 1024)
+
+/*
+ * Run crc32, inflate, LZO, memcpy and the IP checksum from eSRAM
+ * rather than in place from eNVM. The link prints how much of the
+ * eSRAM this takes; compare "hotbench" results with and without it.
+ */
+#define CONFIG_ARMCORTEXM3_HOTCODE
+
 /*
  * malloc() pool size
  */
@@ -147,6 +185,15 @@
 #define CONFIG_SYS_MALLOC_EXT_LEN	(1024 * 1024)
 #define CONFIG_SYS_MALLOC_EXT_BASE \
 	(CONFIG_SYS_RAM_BASE + CONFIG_SYS_RAM_SIZE - CONFIG_SYS_MALLOC_EXT_LEN)
+
+#if 0
+/*
+ * Define the constant below to have "mallinfo" report the peak use of
+ * the pool above, fragmentation and allocations per caller. This takes
+ * about 3 KB of eSRAM and slows malloc()/free() down somewhat.
+ */
+#define CONFIG_SYS_MALLOC_STATS
+#endif
 /*
  * Configuration of the external memory
  */
@@ -160,6 +207,11 @@
  */
 #define CONFIG_SYS_NO_FLASH
 
+/*
+ * Configure the PDMA controller driver
+ */
+#define CONFIG_M2S_PDMA
+
 /*
  * Configure the SPI controller device driver
  * FIFO Size is 64K, but leave 5 bytes for cmd[] + addr[]
@@ -188,6 +240,10 @@
 #define CONFIG_ENV_SECT_SIZE		0x10000
 #define CONFIG_ENV_SIZE			CONFIG_ENV_SECT_SIZE
 #define CONFIG_ENV_OFFSET		0x10000
+/* Append saves to the sector, only erasing it when full */
+#define CONFIG_ENV_SF_LOG		1
+/* Hash index for getenv() */
+#define CONFIG_ENV_HASH
 #define CONFIG_ENV_SPI_BUS		CONFIG_SPI_FLASH_BUS
 #define CONFIG_ENV_SPI_CS		CONFIG_SPI_FLASH_CS
 #define CONFIG_ENV_SPI_MAX_HZ		CONFIG_SPI_FLASH_SPEED
@@ -202,12 +258,62 @@
  * with 64K alignment
  */
 #define CONFIG_ENV_LINUX_BACKUP_OFFSET	0x0020000
+#define CONFIG_ENV_SLOT_OFFSET		0x07F0000
 #define CONFIG_ENV_LINUX_NORMAL_OFFSET	0x0800000
 #define CONFIG_ENV_FPGA_GOLDEN_OFFSET	0x1000000
 #define CONFIG_ENV_FPGA_UPDATE_OFFSET	0x1400000
 
-#define CONFIG_ENV_LINUX_BACKUP_SIZE	0x07E0000
+#define CONFIG_ENV_LINUX_BACKUP_SIZE	0x07D0000
 #define CONFIG_ENV_LINUX_NORMAL_SIZE	0x0800000
+#define CONFIG_ENV_FPGA_GOLDEN_SIZE	0x0400000
+#define CONFIG_ENV_FPGA_UPDATE_SIZE	0x0400000
+
+/*
+ * The same layout for Linux (needs CONFIG_MTD_CMDLINE_PARTS). This
+ * replaces the kernel's own SPI flash partitions, so their /dev/mtdN
+ * numbers change; look partitions up by name in /proc/mtd.
+ */
+#define CONFIG_SPI_MTDPARTS		"spi0.0:64k(spi-dir)ro,"	\
+	"64k(env),8000k(backup),64k(fw_slot),8m(normal),"		\
+	"4m(fpga-golden),4m(fpga-update)"
+
+/*
+ * Partitions of the UDP flashing service ("fastboot" command)
+ */
+#define CONFIG_CMD_FASTBOOT
+#define CONFIG_SYS_FASTBOOT_PARTS	{				\
+	{ "normal", CONFIG_ENV_LINUX_NORMAL_OFFSET,			\
+		CONFIG_ENV_LINUX_NORMAL_SIZE },				\
+	{ "backup", CONFIG_ENV_LINUX_BACKUP_OFFSET,			\
+		CONFIG_ENV_LINUX_BACKUP_SIZE },				\
+	{ "fpga-golden", CONFIG_ENV_FPGA_GOLDEN_OFFSET,			\
+		CONFIG_ENV_FPGA_GOLDEN_SIZE },				\
+	{ "fpga-update", CONFIG_ENV_FPGA_UPDATE_OFFSET,			\
+		CONFIG_ENV_FPGA_UPDATE_SIZE } }
+
+/*
+ * Verified-image cache: let bootm skip the data CRC of an image that
+ * has not been touched in SPI flash since it last passed verification.
+ * The cache record lives in the last eNVM page, which u-boot.lds
+ * leaves out of the U-Boot image.
+ */
+#define CONFIG_IMGCACHE
+#define CONFIG_SYS_IMGCACHE_ENVM_OFFSET	(CONFIG_MEM_NVM_LEN - 0x80)
+
+/*
+ * A/B image slots: "a" is the normal image, "b" the backup one.
+ * The slot record has a sector of its own, between the two images
+ * ("fw_slot" in mtdparts). Sector 0 is left alone: the System
+ * Controller looks for its SPI directory there.
+ */
+#define CONFIG_CMD_SLOT
+#define CONFIG_SYS_SLOT_REC_OFFSET	CONFIG_ENV_SLOT_OFFSET
+#define CONFIG_SYS_SLOT_REC_SIZE	CONFIG_ENV_SECT_SIZE
+#define CONFIG_SYS_SLOT_TRIES		3
+#define CONFIG_SYS_SLOT_PARTS		{				\
+	{ CONFIG_ENV_LINUX_NORMAL_OFFSET, CONFIG_ENV_LINUX_NORMAL_SIZE },\
+	{ CONFIG_ENV_LINUX_BACKUP_OFFSET, CONFIG_ENV_LINUX_BACKUP_SIZE } }
+#define CONFIG_SYS_SLOT_BOOTCMD		"run bootmcmd"
 
 /*
  * Serial console configuration: MSS UART1
@@ -220,7 +326,16 @@
 #define CONFIG_CONS_INDEX		1
 #define CONFIG_SYS_NS16550_COM1		0x40000000
 #define CONFIG_BAUDRATE			115200
-#define CONFIG_SYS_BAUDRATE_TABLE	{ 9600, 19200, 38400, 57600, 115200 }
+#define CONFIG_SYS_BAUDRATE_TABLE	{ 9600, 19200, 38400, 57600, 115200, \
+					  230400, 460800, 921600 }
+
+/*
+ * Interrupt-driven console receive: MMUART_0 is IRQ 10 in the NVIC.
+ * U-Boot runs with IRQs unmasked for this.
+ */
+#define CONFIG_ARMCORTEXM3_IRQ
+#define CONFIG_SYS_NS16550_RX_IRQ	10
+#define CONFIG_SYS_NS16550_RX_BUFSIZE	4096
 
 /*
  * Console I/O buffer size
@@ -238,9 +353,25 @@
  */
 #define CONFIG_NET_MULTI
 #define CONFIG_M2S_ETH
-#define CONFIG_SYS_RX_ETH_BUFFER	2
 #define CONFIG_ETHADDR			C0:B1:3C:83:83:83
 
+/*
+ * m2s_eth receives into its own ring rather than NetRxPackets[], so
+ * PktBuf needs a single rx buffer. The ring holds 4 frames (1.5 KB more
+ * eSRAM than the former 2 + 2 buffers), and the TCP window matches it:
+ * on a 1 Gbit/s link a window beyond the ring overflows it and the
+ * transfer collapses into retransmission timeouts (see tools/tcpsim).
+ */
+#define CONFIG_SYS_RX_ETH_BUFFER	1
+#define CONFIG_M2S_ETH_RX_BD_NUM	4
+#define CONFIG_SYS_TCP_RCV_WND		(CONFIG_M2S_ETH_RX_BD_NUM * TCP_MSS)
+
+/*
+ * Multicast TFTP (atftpd "multicast" option): one server stream
+ * updates a whole rack of boards
+ */
+#define CONFIG_MCAST_TFTP
+
 /*
  * Use standard MII PHY API
  */
@@ -256,6 +387,23 @@
 #define CONFIG_NETMASK			255.255.255.0
 #define CONFIG_HOSTNAME			m2s-volkh
 
+/*
+ * DHCP, for when the static address is not wanted. Rapid Commit makes
+ * it a single round trip, as does asking for the cached lease first.
+ */
+#define CONFIG_BOOTP_SUBNETMASK
+#define CONFIG_BOOTP_GATEWAY
+#define CONFIG_BOOTP_RAPID_COMMIT
+#define CONFIG_DHCP_LEASE_CACHE
+
+/*
+ * Netconsole, with output coalesced into full sized packets and input
+ * polled at most every 20 ms
+ */
+#define CONFIG_NETCONSOLE
+#define CONFIG_NETCONSOLE_BUFFER_SIZE	1472	/* 1500 byte MTU less IP/UDP */
+#define CONFIG_NETCONSOLE_POLL_MS	20
+
 /*
  * Memtest configuration
  */
@@ -302,6 +450,8 @@
 #define CONFIG_CMD_NET
 #define CONFIG_CMD_PING
 #define CONFIG_CMD_NFS
+#define CONFIG_CMD_DHCP
+#define CONFIG_CMD_WGET
 #define CONFIG_CMD_SOURCE
 #define CONFIG_CMD_XIMG
 
@@ -316,6 +466,13 @@
 
 #define CONFIG_CMD_M2S_MSS
 
+#define CONFIG_CMD_HOTBENCH
+#define CONFIG_CMD_MEMBENCH
+#define CONFIG_CMD_MARCHTEST
+#define CONFIG_CMD_M2S_DDRB
+#define CONFIG_CMD_ENVBENCH
+#define CONFIG_CMD_NETBENCH
+
 /*
  * To save memory disable long help
  */
@@ -335,21 +492,13 @@
  */
 #define CONFIG_BOOTDELAY		3
 #define CONFIG_ZERO_BOOTDELAY_CHECK
-#define CONFIG_BOOTCOMMAND		"run normalboot; run backupboot"
+#define CONFIG_BOOTCOMMAND		"run fpgaupdate; slot boot; "	\
+	"echo \"No bootable slot! Resetting...\"; reset"
 #define CONFIG_AUTOBOOT_KEYED
 #define CONFIG_AUTOBOOT_PROMPT		\
 	"Type S-T-O-P (lowercase, no dashes) to terminate autoboot in %d seconds...\n",bootdelay
 #define CONFIG_AUTOBOOT_STOP_STR	"stop"
 
-/*
- * Boot-count limit configuration.
- * CONFIG_SYS_BOOTCOUNT_ADDR is calculated as:
- * CONFIG_MEM_RAM_BASE + (2 * CONFIG_MEM_RAM_LEN) - CONFIG_SYS_BOOTCOUNT_SIZE
- */
-#define CONFIG_BOOTCOUNT_LIMIT		3
-#define CONFIG_SYS_BOOTCOUNT_SIZE	8
-#define CONFIG_SYS_BOOTCOUNT_ADDR	0x300003F8
-
 /*
  * Macro for the "loadaddr". The most optimal load address
  * for the non-compressed uImage is the kernel link address
@@ -374,54 +523,48 @@
 #define CONFIG_EXTRA_ENV_SETTINGS					\
 	"addip=setenv bootargs ${bootargs} ip=${ipaddr}:${serverip}:"	\
 		"${gatewayip}:${netmask}:${hostname}:eth0:off\0"	\
-	"altbootcmd=run backupboot\0"					\
-	"backupboot=setenv spioffset ${backupoffset}; "			\
-		"setenv spisize ${backupsize}; run flashboot; "		\
-		"echo \"Failed backup boot! Resetting...\"; reset\0"	\
+	"autoload=no\0"							\
 	"backupoffset=" MK_STR(CONFIG_ENV_LINUX_BACKUP_OFFSET) "\0"	\
 	"backupsize=" MK_STR(CONFIG_ENV_LINUX_BACKUP_SIZE) "\0"		\
 	"backupimage=" MK_STR(CONFIG_IMAGE_NAME_BACKUP) "\0"		\
-	"bootcountaddr=" MK_STR(CONFIG_SYS_BOOTCOUNT_ADDR) "\0"		\
-	"bootlimit=" MK_STR(CONFIG_BOOTCOUNT_LIMIT) "\0"		\
 	"bootmcmd=run getfpgainfo setargs addip; bootm\0"		\
 	"flashboot=echo \"Booting from SPI flash @ ${spioffset}\"; "	\
 		"run spiprobe; sf read ${loadaddr} ${spioffset} "	\
 		"${spisize}; run bootmcmd\0"				\
 	"fpgaupdate=if itest *${fpgaupdateaddr} == ${fpgaupdatevalu}; " \
 		"then mw.l ${fpgaupdateaddr} 0; if mss iapauth; "	\
-		"then run rstbootcnt; mss iapprog; else boot; fi; fi\0"	\
+		"then mss iapprog; else boot; fi; fi\0"			\
 	"fpgaupdateaddr=" MK_STR(CONFIG_FPGAUPDATE_ADDR) "\0"		\
 	"fpgaupdatevalu=" MK_STR(CONFIG_FPGAUPDATE_VALU) "\0"		\
-	"getbootcnt=md.l ${bootcountaddr} 1\0"				\
 	"getfpgainfo=mss getusr fpgausrcode; mss getver fpgaversion\0"	\
 	"iapaddr=" MK_STR(CONFIG_ENV_FPGA_UPDATE_OFFSET) "\0"		\
 	"imagename=" MK_STR(CONFIG_IMAGE_NAME_NORMAL) "\0"		\
 	"imageupdate=run netload; if test ${spisize} -le ${partsize}; "	\
-		"then run spiupdate; "					\
+		"then run spiupdate && slot update ${slotname}; "	\
 		"else echo \"File too large!\"; fi\0"			\
 	"netboot=run netload; run bootmcmd\0"				\
 	"netload=tftp ${loadaddr} ${imagename}; setenv spisize "	\
 		"0x${filesize}\0"					\
 	"netupdate=run updatenormal\0"					\
-	"normalboot=run fpgaupdate; setenv spioffset ${normaloffset}; "	\
-		"setenv spisize ${normalsize}; run flashboot; "		\
-		"echo \"Failed normal boot!\"\0"			\
 	"normaloffset=" MK_STR(CONFIG_ENV_LINUX_NORMAL_OFFSET) "\0"	\
 	"normalsize=" MK_STR(CONFIG_ENV_LINUX_NORMAL_SIZE) "\0"		\
 	"normalimage=" MK_STR(CONFIG_IMAGE_NAME_NORMAL) "\0"		\
+	"mtdparts=" CONFIG_SPI_MTDPARTS "\0"				\
 	"platform=" MK_STR(CONFIG_PLATFORM) "\0"			\
-	"rstbootcnt=mw.l ${bootcountaddr} 0\0"				\
 	"setargs=setenv bootargs m2s_platform=${platform}:${sysref} "	\
 		"m2s_fpgainfo=${fpgausrcode}:${fpgaversion} "		\
+		"mtdparts=${mtdparts} "					\
 		"console=ttyS0,${baudrate} panic=10\0"			\
 	"spiprobe=sf probe " MK_STR(CONFIG_SPI_FLASH_BUS) "\0"		\
 	"spiupdate=run spiprobe; sf erase ${spioffset} ${spisize}; "	\
 		"sf write ${loadaddr} ${spioffset} ${spisize}\0"	\
 	"sysref=" MK_STR(CONFIG_SYS_M2S_SYSREF) "\0"			\
 	"updatebackup=setenv spioffset ${backupoffset}; "		\
+		"setenv slotname b; "					\
 		"setenv partsize ${backupsize}; "			\
 		"setenv imagename ${backupimage}; run imageupdate\0"	\
 	"updatenormal=setenv spioffset ${normaloffset}; "		\
+		"setenv slotname a; "					\
 		"setenv partsize ${normalsize}; "			\
 		"setenv imagename ${normalimage}; run imageupdate\0"	\
 
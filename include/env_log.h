@@ -0,0 +1,62 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Log-structured environment in SPI flash (CONFIG_ENV_SF_LOG).
+ *
+ * Each record is a header followed by the used part of the environment
+ * data, up to and including the terminating double NUL, padded to
+ * ENV_LOG_ALIGN. Records are appended to the erased space of the log
+ * area, CONFIG_ENV_SF_LOG_SIZE bytes at CONFIG_ENV_OFFSET, which is
+ * erased a sector at a time. The valid record with the highest sequence
+ * number is the current environment.
+ *
+ * This layout is shared with Linux (tools/env/fw_env).
+ */
+#ifndef __ENV_LOG_H__
+#define __ENV_LOG_H__
+
+#ifndef CONFIG_ENV_SF_LOG_SIZE
+# define CONFIG_ENV_SF_LOG_SIZE	CONFIG_ENV_SECT_SIZE
+#endif
+
+#define ENV_LOG_MAGIC		0x454e564c	/* "ENVL" */
+#define ENV_LOG_ALIGN		16
+#define ENV_LOG_SECTORS		(CONFIG_ENV_SF_LOG_SIZE / CONFIG_ENV_SECT_SIZE)
+
+struct env_log_hdr {
+	uint32_t	magic;
+	uint32_t	seq;		/* Incremented by each save	*/
+	uint32_t	len;		/* Data length			*/
+	uint32_t	dcrc;		/* Data CRC			*/
+	uint32_t	hcrc;		/* CRC of the above		*/
+};
+
+#define ENV_LOG_HCRC(h)		crc32(0, (uint8_t *)(h), \
+					offsetof(struct env_log_hdr, hcrc))
+
+/* Space taken by a record with "len" bytes of data */
+#define ENV_LOG_REC_LEN(len)	(((len) + sizeof(struct env_log_hdr) + \
+				  ENV_LOG_ALIGN - 1) & ~(ENV_LOG_ALIGN - 1))
+
+#endif /* __ENV_LOG_H__ */
@@ -0,0 +1,103 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Fastboot-style UDP flashing protocol.
+ *
+ * Packets start with the 4-byte header of the fastboot UDP protocol
+ * (id, flags, sequence number). QUERY, INIT and FASTBOOT packets work
+ * as in fastboot: the host sends one packet with the next sequence
+ * number and the device answers it with the same number, so either end
+ * can retransmit. FASTBOOT packets carry text commands, answered with
+ * "OKAY", "FAIL" or "DATA" and up to 60 more characters:
+ *
+ *   getvar:version | product | partitions | partition-size:<part>
+ *   erase:<part>
+ *   flash:<part>:<size>	size in hex; answered with DATA<size>
+ *   crc32:<part>:<size>	CRC32 of the first size bytes in flash
+ *   reboot
+ *   continue		leave the flashing service
+ *
+ * Unlike fastboot, the image is not downloaded to RAM first. After
+ * "DATA" the host streams DATA packets, each holding a u32 image offset
+ * and up to FB_DATA_MAX bytes. The device writes them to flash one
+ * erase block at a time and answers with ACK packets, giving the offset
+ * up to which the image has been received and the offset the host may
+ * send up to. Data past a hole is dropped, and the device answers the
+ * first such packet with an ACK flagged FB_ACK_RESEND; the host then
+ * goes back to the acknowledged offset. The
+ * transfer is complete when the acknowledged offset reaches the size.
+ * An ERROR packet carrying a message ends the transfer early.
+ *
+ * All fields are in network byte order. This layout is shared with the
+ * host side (tools/fastboot).
+ */
+#ifndef __FASTBOOT_H__
+#define __FASTBOOT_H__
+
+#define FASTBOOT_PORT		5554
+#define FASTBOOT_VERSION	1
+
+/* Packet ids */
+#define FB_ERROR		0x00
+#define FB_QUERY		0x01
+#define FB_INIT			0x02
+#define FB_FASTBOOT		0x03
+#define FB_DATA			0x80	/* Image data, host to device	*/
+#define FB_ACK			0x81	/* Data ACK, device to host	*/
+
+/* ACK flags */
+#define FB_ACK_RESEND		0x01	/* Data was lost, go back	*/
+
+/* Largest UDP payload that fits an untagged 1500-byte MTU frame */
+#define FB_PACKET_MAX		(1500 - 20 - 8)
+#define FB_DATA_MAX		(FB_PACKET_MAX - sizeof(struct fb_data))
+#define FB_RESPONSE_MAX		64
+
+struct fb_hdr {
+	uint8_t		id;
+	uint8_t		flags;
+	uint16_t	seq;
+};
+
+/* QUERY answer: fb_hdr, then the sequence number expected next */
+
+/* INIT, both ways: fb_hdr, then these */
+struct fb_init {
+	struct fb_hdr	h;
+	uint16_t	version;
+	uint16_t	packet_max;	/* Largest UDP payload taken	*/
+};
+
+struct fb_data {
+	struct fb_hdr	h;		/* Sequence number unused	*/
+	uint32_t	offset;		/* Image offset of the data	*/
+};
+
+struct fb_ack {
+	struct fb_hdr	h;		/* Sequence number unused	*/
+	uint32_t	acked;		/* Image bytes received		*/
+	uint32_t	limit;		/* Host may send up to here	*/
+};
+
+#endif /* __FASTBOOT_H__ */
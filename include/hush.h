@@ -31,6 +31,10 @@
 extern int u_boot_hush_start(void);
 extern int parse_string_outer(char *, int);
 extern int parse_file_outer(void);
+#ifdef CONFIG_SYS_HUSH_CACHE
+extern int parse_string_cached(const char *name, char *s, int flag);
+extern void hush_cache_forget(const char *name);
+#endif
 
 int set_local_var(const char *s, int flg_export);
 void unset_local_var(const char *name);
@@ -0,0 +1,71 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Verified-image cache.
+ *
+ * Remembers, per SPI flash image slot, the header and data CRCs of the
+ * last legacy image that passed full data CRC verification, together
+ * with a flash write generation counter. While the counter has not been
+ * bumped by an "sf erase" or "sf write" over that slot, bootm may skip
+ * the data CRC pass for an image just read from the same slot.
+ */
+#ifndef __IMGCACHE_H__
+#define __IMGCACHE_H__
+
+#include <image.h>
+
+/*
+ * Note that "len" bytes at flash "offset" were copied to RAM at "addr".
+ */
+void imgcache_flash_read(ulong addr, ulong offset, ulong len);
+
+/*
+ * Note that flash bytes [offset, offset + len) are about to change.
+ */
+void imgcache_flash_write(ulong offset, ulong len);
+
+#ifdef CONFIG_IMGCACHE
+/*
+ * Note that RAM [addr, addr + len) was written by something other than
+ * "sf read": a download, "cp", "mw" etc.
+ */
+void imgcache_ram_write(ulong addr, ulong len);
+#else
+#define imgcache_ram_write(addr, len)	do { } while (0)
+#endif
+
+/*
+ * Returns 1 if the image at "addr" is known to be verified,
+ * i.e. the data CRC check may be skipped. This uses up the last
+ * imgcache_flash_read(): the next check needs a new one.
+ */
+int imgcache_check(ulong addr, const image_header_t *hdr);
+
+/*
+ * Record the image at "addr", just checked with imgcache_check(), as
+ * having passed data verification.
+ */
+void imgcache_update(ulong addr, const image_header_t *hdr);
+
+#endif /* __IMGCACHE_H__ */
@@ -880,6 +880,14 @@ extern Void_t*     sbrk();
 
 #else
 
+/*
+ * With the instrumentation, dlmalloc only provides the dl* routines,
+ * and common/cmd_mallinfo.c the public ones.
+ */
+#if defined(CONFIG_SYS_MALLOC_STATS) && !defined(USE_DL_PREFIX)
+#define USE_DL_PREFIX
+#endif
+
 #ifdef USE_DL_PREFIX
 #define cALLOc		dlcalloc
 #define fREe		dlfree
@@ -946,6 +954,28 @@ extern ulong mem_malloc_brk;
 
 void mem_malloc_init(ulong start, ulong size);
 
+#ifdef CONFIG_SYS_MALLOC_STATS
+void *malloc(size_t bytes);
+void free(void *mem);
+void *realloc(void *oldmem, size_t bytes);
+void *memalign(size_t alignment, size_t bytes);
+void *calloc(size_t n, size_t elem_size);
+
+/*
+ * Arena usage, in bytes
+ */
+struct malloc_arena_info {
+	ulong	arena;		/* Obtained from sbrk() now		*/
+	ulong	max_arena;	/* Highest it ever was			*/
+	ulong	topsize;	/* Free space at the top of the arena	*/
+	ulong	free;		/* Free space, including the top	*/
+	ulong	free_chunks;	/* Free chunks, not counting the top	*/
+	ulong	largest;	/* Largest free chunk, or the top	*/
+};
+
+void malloc_arena_info(struct malloc_arena_info *ai);
+#endif
+
 #ifdef __cplusplus
 };  /* end of extern "C" */
 #endif
@@ -103,7 +103,7 @@ struct eth_device {
 	int  (*recv) (struct eth_device*);
 	void (*halt) (struct eth_device*);
 #ifdef CONFIG_MCAST_TFTP
-	int (*mcast) (struct eth_device*, u32 ip, u8 set);
+	int (*mcast) (struct eth_device*, u8 *enetaddr, u8 set);
 #endif
 	struct eth_device *next;
 	void *priv;
@@ -182,6 +182,7 @@ typedef struct {
 #define PROT_VLAN	0x8100		/* IEEE 802.1q protocol		*/
 
 #define IPPROTO_ICMP	 1	/* Internet Control Message Protocol	*/
+#define IPPROTO_TCP	 6	/* Transmission Control Protocol	*/
 #define IPPROTO_UDP	17	/* User Datagram Protocol		*/
 
 /*
@@ -325,6 +326,9 @@ extern char		NetOurRootPath[64];	/* Our root path		*/
 extern ushort		NetBootFileSize;	/* Our boot file size in blocks	*/
 /** END OF BOOTP EXTENTIONS **/
 extern ulong		NetBootFileXferSize;	/* size of bootfile in bytes	*/
+extern void		(*TftpStoreHook)(ulong offset, ulong len); /* see tftp.c */
+#define WGET_TO_RAM		(~0UL)
+extern ulong		WgetFlashOffset;	/* see wget.c			*/
 extern uchar		NetOurEther[6];		/* Our ethernet address		*/
 extern uchar		NetServerEther[6];	/* Boot server enet address	*/
 extern IPaddr_t		NetOurIP;		/* Our    IP addr (0 = unknown)	*/
@@ -356,7 +360,8 @@ extern int		NetState;		/* Network loop state		*/
 extern int		NetRestartWrap;		/* Tried all network devices	*/
 #endif
 
-typedef enum { BOOTP, RARP, ARP, TFTP, DHCP, PING, DNS, NFS, CDP, NETCONS, SNTP } proto_t;
+typedef enum { BOOTP, RARP, ARP, TFTP, DHCP, PING, DNS, NFS, CDP, NETCONS, SNTP,
+	       WGET, NETBENCH, FASTBOOT } proto_t;
 
 /* from net/net.c */
 extern char	BootFile[128];			/* Boot File name		*/
@@ -366,6 +371,21 @@ extern char *NetDNSResolve;		/* The host to resolve  */
 extern char *NetDNSenvvar;		/* the env var to put the ip into */
 #endif
 
+#if defined(CONFIG_CMD_FASTBOOT)
+extern ulong	FastbootWait;			/* see fastboot.c	*/
+extern void	FastbootStart(void);
+#endif
+
+#if defined(CONFIG_CMD_NETBENCH)
+extern int	NetbenchSink;			/* see netbench.c	*/
+extern IPaddr_t	NetbenchIP;
+extern int	NetbenchPort;
+extern ulong	NetbenchSeconds;
+extern int	NetbenchLen;
+extern void	NetbenchStart(void);
+extern void	NetbenchReport(void);
+#endif
+
 #if defined(CONFIG_CMD_PING)
 extern IPaddr_t	NetPingIP;			/* the ip address to ping		*/
 #endif
@@ -413,6 +433,9 @@ extern void	NetSendPacket(volatile uchar *, int);
 /* Transmit UDP packet, performing ARP request if needed */
 extern int	NetSendUDPPacket(uchar *ether, IPaddr_t dest, int dport, int sport, int len);
 
+/* Transmit an IP packet built at NetTxPacket + NetEthHdrSize() */
+extern int	NetSendIPPacket(uchar *ether, IPaddr_t dest, int len);
+
 /* Processes a received packet */
 extern void	NetReceive(volatile uchar *, int);
 
@@ -0,0 +1,54 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * UDP throughput benchmark frames.
+ *
+ * Every frame starts with this header, all fields in network byte
+ * order; the rest of the payload is filler. The sender numbers its
+ * frames from 0 and stamps each with its own microsecond clock, so the
+ * sink can count losses and reordering and estimate the inter-arrival
+ * jitter (RFC 3550, A.8) without synchronized clocks. A run ends with
+ * a few NETBENCH_F_END frames carrying the number of frames sent.
+ *
+ * This layout is shared with the host side (tools/netbench).
+ */
+#ifndef __NETBENCH_H__
+#define __NETBENCH_H__
+
+#define NETBENCH_MAGIC		0x4e42454e	/* "NBEN" */
+#define NETBENCH_PORT		5001
+#define NETBENCH_F_END		0x1		/* Last frame(s) of a run */
+#define NETBENCH_END_COUNT	3		/* END frames sent	*/
+
+/* Largest payload that fits an untagged 1500-byte MTU frame */
+#define NETBENCH_MAX_LEN	(1500 - 20 - 8)
+
+struct netbench_hdr {
+	uint32_t	magic;
+	uint32_t	seq;		/* Frame number, or count if END */
+	uint32_t	usec;		/* Sender clock, in microseconds */
+	uint32_t	flags;
+};
+
+#endif /* __NETBENCH_H__ */
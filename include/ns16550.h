@@ -151,6 +151,16 @@ typedef volatile struct NS16550 *NS16550_t;
 #define UART_IER_RDI	0x01	/* Enable receiver data interrupt */
 
 
+#ifdef CONFIG_SYS_M2S
+/*
+ * M2S MMUART fractional baud rate: with EFBR set in MM0 (regC),
+ * DFR (uasr) adds 1/64ths to the divisor latch value
+ */
+#define mm0		regC
+#define dfr		uasr
+#define UART_MM0_EFBR	0x80	/* Enable fractional baud rate */
+#endif
+
 #ifdef CONFIG_OMAP1510
 #define OSC_12M_SEL	0x01	/* selects 6.5 * current clk div */
 #endif
@@ -163,3 +173,7 @@ void	NS16550_putc   (NS16550_t com_port, char c);
 char	NS16550_getc   (NS16550_t com_port);
 int	NS16550_tstc   (NS16550_t com_port);
 void	NS16550_reinit (NS16550_t com_port, int baud_divisor);
+#ifdef CONFIG_SYS_NS16550_RX_IRQ
+void	NS16550_rx_irq_init (NS16550_t com_port);
+void	NS16550_rx_isr (void);
+#endif
@@ -0,0 +1,80 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * A/B image slot manager.
+ *
+ * The slot record is a log of fixed-size entries in a dedicated SPI flash
+ * sector. Each update appends a complete entry with the next sequence
+ * number to the erased space; the sector is erased only when it is full.
+ * The valid entry with the highest sequence number is the current one.
+ *
+ * This layout is shared with Linux (tools/slot/fw_slot), which appends
+ * an entry marking the slot it was booted from as good. The first such
+ * entry also sets "counting": until then, boots use up no attempts.
+ */
+#ifndef __SLOT_H__
+#define __SLOT_H__
+
+#define SLOT_MAGIC		0x534c4f54	/* "SLOT" */
+#define SLOT_MAX		2
+#define SLOT_REC_LEN		64
+#define SLOT_NONE		0xff
+
+struct slot_info {
+	uint32_t	size;		/* Image size, 0 if none	*/
+	uint32_t	dcrc;		/* Image data CRC		*/
+	uint32_t	version;	/* Image timestamp		*/
+	uint8_t		tries;		/* Boot attempts left		*/
+	uint8_t		good;		/* Booted up to Linux		*/
+	uint8_t		reserved[2];
+};
+
+struct slot_rec {
+	uint32_t	magic;
+	uint32_t	seq;		/* Incremented by each update	*/
+	struct slot_info slot[SLOT_MAX];
+	uint8_t		active;		/* Slot to try first		*/
+	uint8_t		booting;	/* Slot last tried, or SLOT_NONE */
+	uint8_t		limit;		/* Attempts of a new image	*/
+	uint8_t		counting;	/* Tries count, see cmd_slot.c	*/
+	uint8_t		reserved[16];
+	uint32_t	crc;		/* CRC32 of the above		*/
+};
+
+#define SLOT_REC_CRC(r)		crc32(0, (uint8_t *)(r), \
+					offsetof(struct slot_rec, crc))
+
+#ifndef USE_HOSTCC
+#ifdef CONFIG_CMD_SLOT
+/*
+ * Record the image written to the slot partition at "offset" by
+ * something else than "slot update", e.g. the fastboot service.
+ */
+void slot_written(ulong offset);
+#else
+#define slot_written(offset)	do { } while (0)
+#endif
+#endif
+
+#endif /* __SLOT_H__ */
@@ -120,6 +120,13 @@ int	drv_usbtty_init (void);
 #ifdef CONFIG_NETCONSOLE
 int	drv_nc_init (void);
 #endif
+#if defined(CONFIG_NETCONSOLE) && defined(CONFIG_NETCONSOLE_BUFFER_SIZE)
+void	nc_flush (void);	/* Send buffered output now		*/
+void	nc_poll (void);		/* ... if it has waited long enough	*/
+#else
+static inline void nc_flush (void) {}
+static inline void nc_poll (void) {}
+#endif
 #ifdef CONFIG_JTAG_CONSOLE
 int drv_jtag_console_init (void);
 #endif
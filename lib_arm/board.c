@@ -49,6 +49,7 @@
 #include <nand.h>
 #include <onenand_uboot.h>
 #include <mmc.h>
+#include <bootstage.h>
 
 #ifdef CONFIG_BITBANGMII
 #include <miiphy.h>
@@ -301,10 +302,15 @@ void start_armboot (void)
 
 	monitor_flash_len = _bss_start - _armboot_start;
 
+	/*
+	 * The boot stage time base is started by arch_cpu_init()/timer_init(),
+	 * so the first mark is taken once that init step has run
+	 */
 	for (init_fnc_ptr = init_sequence; *init_fnc_ptr; ++init_fnc_ptr) {
 		if ((*init_fnc_ptr)() != 0) {
 			hang ();
 		}
+		bootstage_mark_id ("init", (ulong)*init_fnc_ptr);
 	}
 
 #ifdef CONFIG_SYS_MALLOC_EXT_BASE
@@ -371,6 +377,7 @@ void start_armboot (void)
 
 	/* initialize environment */
 	env_relocate ();
+	bootstage_mark ("env_relocate");
 
 #ifdef CONFIG_VFD
 	/* must do this after the framebuffer is allocated */
@@ -458,7 +465,9 @@ extern void davinci_eth_set_mac_addr (const u_int8_t *addr);
 	debug ("Reset Ethernet PHY\n");
 	reset_phy();
 #endif
+	bootstage_mark ("eth_initialize");
 #endif
+	bootstage_mark ("main_loop");
 	/* main_loop() can return to retry autoboot, if so just run it again. */
 	for (;;) {
 		main_loop ();
@@ -470,5 +479,6 @@ extern void davinci_eth_set_mac_addr (const u_int8_t *addr);
 void hang (void)
 {
 	puts ("### ERROR ### Please RESET the board ###\n");
+	nc_flush ();
 	for (;;);
 }
@@ -29,6 +29,8 @@
 #include <fdt.h>
 #include <libfdt.h>
 #include <fdt_support.h>
+#include <bootstage.h>
+#include <stdio_dev.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -39,7 +41,8 @@ DECLARE_GLOBAL_DATA_PTR;
     defined (CONFIG_REVISION_TAG) || \
     defined (CONFIG_VFD) || \
     defined (CONFIG_LCD) || \
-    defined (CONFIG_DMAMEM_TAG)
+    defined (CONFIG_DMAMEM_TAG) || \
+    defined (CONFIG_BOOTSTAGE)
 static void setup_start_tag (bd_t *bd);
 
 # ifdef CONFIG_SETUP_MEMORY_TAGS
@@ -61,6 +64,10 @@ static void setup_videolfb_tag (gd_t *gd);
 static void setup_dmamem_tag (void);
 # endif
 
+# ifdef CONFIG_BOOTSTAGE
+static void setup_bootstage_tag (void);
+# endif
+
 static struct tag *params;
 #endif /* CONFIG_SETUP_MEMORY_TAGS || CONFIG_CMDLINE_TAG || CONFIG_INITRD_TAG */
 
@@ -102,6 +109,8 @@ static void announce_and_cleanup(void)
 {
 	printf("\nStarting kernel ...\n\n");
 
+	nc_flush();
+
 #ifdef CONFIG_USB_DEVICE
 	{
 		extern void udc_disconnect(void);
@@ -150,7 +159,8 @@ int do_bootm_linux(int flag, int argc, char *argv[], bootm_headers_t *images)
     defined (CONFIG_REVISION_TAG) || \
     defined (CONFIG_LCD) || \
     defined (CONFIG_VFD) || \
-    defined (CONFIG_DMAMEM_TAG)
+    defined (CONFIG_DMAMEM_TAG) || \
+    defined (CONFIG_BOOTSTAGE)
 	setup_start_tag (bd);
 #ifdef CONFIG_SERIAL_TAG
 	setup_serial_tag (&params);
@@ -173,6 +183,10 @@ int do_bootm_linux(int flag, int argc, char *argv[], bootm_headers_t *images)
 #endif
 #ifdef CONFIG_DMAMEM_TAG
 	setup_dmamem_tag();
+#endif
+#ifdef CONFIG_BOOTSTAGE
+	bootstage_mark ("start_kernel");
+	setup_bootstage_tag();
 #endif
 	setup_end_tag(bd);
 #endif
@@ -250,7 +264,8 @@ static int bootm_linux_fdt(int machid, bootm_headers_t *images)
     defined (CONFIG_SERIAL_TAG) || \
     defined (CONFIG_REVISION_TAG) || \
     defined (CONFIG_LCD) || \
-    defined (CONFIG_VFD)
+    defined (CONFIG_VFD) || \
+    defined (CONFIG_BOOTSTAGE)
 static void setup_start_tag (bd_t *bd)
 {
 	params = (struct tag *) bd->bi_boot_params;
@@ -409,6 +424,29 @@ void setup_dmamem_tag (void)
 }
 #endif
 
+#ifdef CONFIG_BOOTSTAGE
+static void setup_bootstage_tag (void)
+{
+	struct tag_bootstage *bs = &params->u.bootstage;
+	ulong time_us;
+	int i;
+
+	for (i = 0; !bootstage_get(i, &time_us, bs->rec[i].name,
+				    BOOTSTAGE_NAME_LEN); i++)
+		bs->rec[i].time_us = time_us;
+
+	if (!i)
+		return;
+
+	params->hdr.tag = ATAG_BOOTSTAGE;
+	params->hdr.size = (sizeof (struct tag_header) + sizeof (u32) +
+			    i * sizeof (struct tag_bootstage_rec)) >> 2;
+	bs->count = i;
+
+	params = tag_next (params);
+}
+#endif
+
 
 static void setup_end_tag (bd_t *bd)
 {
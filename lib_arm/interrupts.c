@@ -80,6 +80,29 @@ int disable_interrupts (void)
 			     : "memory");
 	return (old & 0x80) == 0;
 }
+#elif defined(CONFIG_ARMCORTEXM3_IRQ)
+/*
+ * Cortex-M3: the NVIC vectors IRQs directly, so only PRIMASK
+ * needs to be cleared. Sources are enabled one by one in the NVIC.
+ */
+void enable_interrupts (void)
+{
+	__asm__ __volatile__("cpsie i" : : : "memory");
+}
+
+/*
+ * returns true if interrupts had been enabled before we disabled them
+ */
+int disable_interrupts (void)
+{
+	unsigned long old;
+	__asm__ __volatile__("mrs %0, primask\n"
+			     "cpsid i"
+			     : "=r" (old)
+			     :
+			     : "memory");
+	return (old & 1) == 0;
+}
 #else
 void enable_interrupts (void)
 {
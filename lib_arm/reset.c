@@ -38,10 +38,12 @@
  */
 
 #include <common.h>
+#include <stdio_dev.h>
 
 int do_reset(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
 {
 	puts ("resetting ...\n");
+	nc_flush ();
 
 	udelay (50000);				/* wait 50 ms */
 
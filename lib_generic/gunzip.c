@@ -56,7 +56,10 @@ void zfree(void *x, void *addr, unsigned nb)
 	free (addr);
 }
 
-int gunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp)
+/*
+ * Returns the length of the gzip header at src, or -1 if it is bad
+ */
+static int gunzip_header(unsigned char *src, unsigned long len)
 {
 	int i, flags;
 
@@ -77,11 +80,21 @@ int gunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp)
 			;
 	if ((flags & HEAD_CRC) != 0)
 		i += 2;
-	if (i >= *lenp) {
+	if (i >= len) {
 		puts ("Error: gunzip out of data in header\n");
 		return (-1);
 	}
 
+	return i;
+}
+
+int gunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp)
+{
+	int i = gunzip_header(src, *lenp);
+
+	if (i < 0)
+		return (-1);
+
 	return zunzip(dst, dstlen, src, lenp, 1, i);
 }
 
@@ -122,3 +135,129 @@ int zunzip(void *dst, int dstlen, unsigned char *src, unsigned long *lenp,
 
 	return 0;
 }
+
+/*
+ * Incremental gunzip, for data that arrives piece by piece (e.g. a
+ * serial download): each piece is inflated straight to the destination
+ * as it comes in. The gzip header must be whole in the first piece.
+ */
+static struct {
+	z_stream	s;
+	unsigned char	*dst;
+	int		started;	/* Header skipped			*/
+	int		done;		/* End of deflate data seen		*/
+	int		failed;		/* Error already reported		*/
+	int		trailer_len;
+	unsigned char	trailer[8];	/* CRC32 and ISIZE, little endian	*/
+} gzs;
+
+int gunzip_stream_start(void *dst, int dstlen)
+{
+	int r;
+
+	memset(&gzs, 0, sizeof(gzs));
+	gzs.dst = dst;
+	gzs.s.zalloc = zalloc;
+	gzs.s.zfree = zfree;
+#if defined(CONFIG_HW_WATCHDOG) || defined(CONFIG_WATCHDOG)
+	gzs.s.outcb = (cb_func)WATCHDOG_RESET;
+#else
+	gzs.s.outcb = Z_NULL;
+#endif	/* CONFIG_HW_WATCHDOG */
+
+	r = inflateInit2(&gzs.s, -MAX_WBITS);
+	if (r != Z_OK) {
+		printf ("Error: inflateInit2() returned %d\n", r);
+		return -1;
+	}
+	gzs.s.next_out = dst;
+	gzs.s.avail_out = dstlen;
+
+	return 0;
+}
+
+/*
+ * Returns 0 while more data is needed, 1 once the whole gzip stream
+ * is in, or -1 on error
+ */
+int gunzip_stream_feed(unsigned char *src, unsigned long len)
+{
+	int r;
+
+	if (gzs.failed)
+		return -1;
+
+	/* Any error below is final */
+	gzs.failed = 1;
+
+	if (!gzs.started) {
+		if (len < 2 || src[0] != 0x1f || src[1] != 0x8b) {
+			puts ("Error: Not gzipped data\n");
+			return -1;
+		}
+		r = gunzip_header(src, len);
+		if (r < 0)
+			return -1;
+		src += r;
+		len -= r;
+		gzs.started = 1;
+	}
+
+	if (!gzs.done && len) {
+		gzs.s.next_in = src;
+		gzs.s.avail_in = len;
+		r = inflate(&gzs.s, Z_NO_FLUSH);
+		if (r == Z_STREAM_END) {
+			gzs.done = 1;
+		} else if (r == Z_BUF_ERROR && gzs.s.avail_out == 0) {
+			puts ("Error: gunzip destination full\n");
+			return -1;
+		} else if (r != Z_OK && r != Z_BUF_ERROR) {
+			printf ("Error: inflate() returned %d\n", r);
+			return -1;
+		}
+		src = gzs.s.next_in;
+		len = gzs.s.avail_in;
+	}
+	gzs.failed = 0;
+
+	while (gzs.done && len && gzs.trailer_len < sizeof(gzs.trailer)) {
+		gzs.trailer[gzs.trailer_len++] = *src++;
+		len--;
+	}
+
+	return gzs.trailer_len == sizeof(gzs.trailer);
+}
+
+/*
+ * Check the gzip trailer and free the inflate state.
+ * Returns the uncompressed length, or -1 on error
+ * (reported here unless gunzip_stream_feed() already did).
+ */
+long gunzip_stream_end(void)
+{
+	unsigned long len = gzs.s.next_out - gzs.dst;
+	u32 crc, isize;
+
+	inflateEnd(&gzs.s);
+
+	if (gzs.failed)
+		return -1;
+
+	if (gzs.trailer_len < sizeof(gzs.trailer)) {
+		puts ("Error: gzipped data is truncated\n");
+		return -1;
+	}
+
+	crc = gzs.trailer[0] | (gzs.trailer[1] << 8) |
+		(gzs.trailer[2] << 16) | (gzs.trailer[3] << 24);
+	isize = gzs.trailer[4] | (gzs.trailer[5] << 8) |
+		(gzs.trailer[6] << 16) | (gzs.trailer[7] << 24);
+	if (isize != (u32)len ||
+	    crc32_wd(0, gzs.dst, len, CHUNKSZ_CRC32) != crc) {
+		puts ("Error: gunzip CRC mismatch\n");
+		return -1;
+	}
+
+	return len;
+}
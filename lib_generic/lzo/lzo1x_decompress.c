@@ -111,7 +111,7 @@ int lzop_decompress(const unsigned char *src, size_t src_len,
 	return LZO_E_INPUT_OVERRUN;
 }
 
-int lzo1x_decompress_safe(const unsigned char *in, size_t in_len,
+int __hotcode lzo1x_decompress_safe(const unsigned char *in, size_t in_len,
 			unsigned char *out, size_t *out_len)
 {
 	const unsigned char * const ip_end = in + in_len;
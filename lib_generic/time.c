@@ -41,3 +41,14 @@ void udelay(unsigned long usec)
 		usec -= kv;
 	} while(usec);
 }
+
+/*
+ * Microseconds, for timing intervals; wraps around after ~71 minutes.
+ * Architectures with a time base finer than get_timer() override this.
+ */
+unsigned long __timer_get_us(void)
+{
+	return get_timer(0) * (1000000 / CONFIG_SYS_HZ);
+}
+unsigned long timer_get_us(void)
+	__attribute__((weak, alias("__timer_get_us")));
@@ -288,7 +288,7 @@ struct inflate_state {
    subject to change. Applications should only use zlib.h.
  */
 
-void inflate_fast OF((z_streamp strm, unsigned start));
+void inflate_fast OF((z_streamp strm, unsigned start)) __hotcode;
 /*+++++*/
     /* inffixed.h -- table for decoding fixed codes
      * Generated automatically by makefixed().
@@ -46,6 +46,24 @@ unsigned long dhcp_leasetime = 0;
 IPaddr_t NetDHCPServerIP = 0;
 static void DhcpHandler(uchar * pkt, unsigned dest, unsigned src, unsigned len);
 
+#if defined(CONFIG_DHCP_LEASE_CACHE)
+#ifndef CONFIG_DHCP_REBOOT_TIMEOUT
+# define CONFIG_DHCP_REBOOT_TIMEOUT	1000UL	/* ms to wait for a reboot ACK */
+#endif
+/*
+ * Last lease bound, asked for again first (RFC 2131 INIT-REBOOT).
+ * It is kept in RAM with its expiry, and as "dhcplease=<ip> <server>"
+ * in the environment, which has no expiry since there is no clock
+ * across resets; the server NAKs a lease that is no longer valid.
+ */
+static struct {
+	IPaddr_t	ip;
+	IPaddr_t	server;
+	ulong		start;		/* get_timer() when bound	*/
+	ulong		time;		/* Lease time in ms		*/
+} DhcpLease;
+#endif
+
 /* For Debug */
 #if 0
 static char *dhcpmsg2str(int type)
@@ -380,6 +398,13 @@ static int DhcpExtended (u8 * e, int message_type, IPaddr_t ServerID, IPaddr_t R
 	*e++ = (576 - 312 + OPT_SIZE) >> 8;
 	*e++ = (576 - 312 + OPT_SIZE) & 0xff;
 
+#if defined(CONFIG_BOOTP_RAPID_COMMIT)
+	if (message_type == DHCP_DISCOVER) {
+		*e++ = 80;	/* Rapid Commit (RFC 4039) */
+		*e++ = 0;
+	}
+#endif
+
 	if (ServerID) {
 		int tmp = ntohl (ServerID);
 
@@ -539,6 +564,21 @@ static int BootpExtended (u8 * e)
 }
 #endif
 
+/*
+ *	Bootp ID is the lower 4 bytes of our ethernet address
+ *	plus the current time in ms.
+ */
+static void BootpNewID(Bootp_t *bp)
+{
+	BootpID = ((ulong)NetOurEther[2] << 24)
+		| ((ulong)NetOurEther[3] << 16)
+		| ((ulong)NetOurEther[4] << 8)
+		| (ulong)NetOurEther[5];
+	BootpID += get_timer(0);
+	BootpID	 = htonl(BootpID);
+	NetCopyLong(&bp->bp_id, &BootpID);
+}
+
 void
 BootpRequest (void)
 {
@@ -646,17 +686,7 @@ BootpRequest (void)
 	ext_len = BootpExtended((u8 *)bp->bp_vend);
 #endif
 
-	/*
-	 *	Bootp ID is the lower 4 bytes of our ethernet address
-	 *	plus the current time in ms.
-	 */
-	BootpID = ((ulong)NetOurEther[2] << 24)
-		| ((ulong)NetOurEther[3] << 16)
-		| ((ulong)NetOurEther[4] << 8)
-		| (ulong)NetOurEther[5];
-	BootpID += get_timer(0);
-	BootpID	 = htonl(BootpID);
-	NetCopyLong(&bp->bp_id, &BootpID);
+	BootpNewID(bp);
 
 	/*
 	 * Calculate proper packet lengths taking into account the
@@ -740,6 +770,8 @@ static void DhcpOptionsProcess (uchar * popt, Bootp_t *bp)
 			break;
 		case 66:	/* Ignore TFTP server name */
 			break;
+		case 80:	/* Ignore Rapid Commit Option */
+			break;
 		case 67:	/* vendor opt bootfile */
 			/*
 			 * I can't use dhcp_vendorex_proc here because I need
@@ -850,6 +882,141 @@ static void DhcpSendRequestPkt(Bootp_t *bp_offer)
 	NetSendPacket(NetTxPacket, pktlen);
 }
 
+#if defined(CONFIG_DHCP_LEASE_CACHE)
+static void DhcpForgetLease(void)
+{
+	DhcpLease.ip = 0;
+	setenv("dhcplease", NULL);
+}
+
+static void DhcpSaveLease(void)
+{
+	char buf[32];
+	char *s;
+	ulong lease = ntohl(dhcp_leasetime);
+
+	DhcpLease.ip = NetOurIP;
+	DhcpLease.server = NetDHCPServerIP;
+	DhcpLease.start = get_timer(0);
+	/* Keep it in range of the ms timer, "infinite" leases included */
+	DhcpLease.time = min(lease, 0x7fffffffUL / CONFIG_SYS_HZ) * CONFIG_SYS_HZ;
+
+	/* Only touch the environment when the lease changed */
+	sprintf(buf, "%pI4 %pI4", &DhcpLease.ip, &DhcpLease.server);
+	s = getenv("dhcplease");
+	if (!s || strcmp(s, buf) != 0)
+		setenv("dhcplease", buf);
+}
+
+/*
+ * Find the last lease: from RAM if still valid, else from the environment
+ */
+static int DhcpLoadLease(void)
+{
+	char *s;
+
+	if (DhcpLease.ip && get_timer(DhcpLease.start) < DhcpLease.time)
+		return 1;
+
+	DhcpLease.ip = 0;
+	s = getenv("dhcplease");
+	if (!s)
+		return 0;
+
+	DhcpLease.ip = string_to_ip(s);
+	s = strchr(s, ' ');
+	DhcpLease.server = s ? string_to_ip(s + 1) : 0;
+
+	return DhcpLease.ip != 0;
+}
+
+static void DhcpRebootTimeout(void)
+{
+	puts ("DHCP: no reply for cached lease\n");
+	BootpRequest ();
+}
+
+/*
+ * Ask for the cached lease directly: a DHCPREQUEST with the requested
+ * IP, but no server identifier and no ciaddr (RFC 2131, 4.3.2).
+ */
+static void DhcpSendRebootPkt(void)
+{
+	volatile uchar *pkt, *iphdr;
+	Bootp_t *bp;
+	int pktlen, iplen, extlen;
+
+	printf("DHCP request for cached lease %pI4\n", &DhcpLease.ip);
+	NetDHCPServerIP = DhcpLease.server;
+	pkt = NetTxPacket;
+	memset ((void*)pkt, 0, PKTSIZE);
+
+	pkt += NetSetEther(pkt, NetBcastAddr, PROT_IP);
+
+	iphdr = pkt;
+	pkt += IP_HDR_SIZE;
+
+	bp = (Bootp_t *)pkt;
+	bp->bp_op = OP_BOOTREQUEST;
+	bp->bp_htype = HWT_ETHER;
+	bp->bp_hlen = HWL_ETHER;
+	bp->bp_hops = 0;
+	bp->bp_secs = htons(get_timer(0) / 1000);
+	memcpy (bp->bp_chaddr, NetOurEther, 6);
+
+	BootpNewID(bp);
+
+	extlen = DhcpExtended((u8 *)bp->bp_vend, DHCP_REQUEST, 0, DhcpLease.ip);
+
+	pktlen = ((int)(pkt-NetTxPacket)) + BOOTP_HDR_SIZE - sizeof(bp->bp_vend) + extlen;
+	iplen = BOOTP_HDR_SIZE - sizeof(bp->bp_vend) + extlen;
+	NetSetIP(iphdr, 0xFFFFFFFFL, PORT_BOOTPS, PORT_BOOTPC, iplen);
+	NetSetTimeout(CONFIG_DHCP_REBOOT_TIMEOUT, DhcpRebootTimeout);
+
+	dhcp_state = REBOOTING;
+	NetSetHandler(DhcpHandler);
+	NetSendPacket(NetTxPacket, pktlen);
+}
+#endif	/* CONFIG_DHCP_LEASE_CACHE */
+
+/*
+ * Got our DHCPACK: take the parameters and go on with the boot file
+ */
+static void DhcpBound(Bootp_t *bp)
+{
+	char *s;
+
+	if (NetReadLong((ulong*)&bp->bp_vend[0]) == htonl(BOOTP_VENDOR_MAGIC))
+		DhcpOptionsProcess((u8 *)&bp->bp_vend[4], bp);
+	BootpCopyNetParams(bp); /* Store net params from reply */
+	dhcp_state = BOUND;
+	printf ("DHCP client bound to address %pI4\n", &NetOurIP);
+#if defined(CONFIG_DHCP_LEASE_CACHE)
+	DhcpSaveLease();
+#endif
+
+	/* Obey the 'autoload' setting */
+	if ((s = getenv("autoload")) != NULL) {
+		if (*s == 'n') {
+			/*
+			 * Just use BOOTP to configure system;
+			 * Do not use TFTP to load the bootfile.
+			 */
+			NetState = NETLOOP_SUCCESS;
+			return;
+#if defined(CONFIG_CMD_NFS)
+		} else if (strcmp(s, "NFS") == 0) {
+			/*
+			 * Use NFS to load the bootfile.
+			 */
+			NfsStart();
+			return;
+#endif
+		}
+	}
+	TftpStart();
+}
+
 /*
  *	Handle DHCP received packets.
  */
@@ -876,6 +1043,13 @@ DhcpHandler(uchar * pkt, unsigned dest, unsigned src, unsigned len)
 		 * OFFER from a server we want.
 		 */
 		debug("DHCP: state=SELECTING bp_file: \"%s\"\n", bp->bp_file);
+#if defined(CONFIG_BOOTP_RAPID_COMMIT)
+		/* An ACK right away if the server does Rapid Commit */
+		if (DhcpMessageType((u8 *)bp->bp_vend) == DHCP_ACK) {
+			DhcpBound(bp);
+			return;
+		}
+#endif
 #ifdef CONFIG_SYS_BOOTFILE_PREFIX
 		if (strncmp(bp->bp_file,
 			    CONFIG_SYS_BOOTFILE_PREFIX,
@@ -900,37 +1074,26 @@ DhcpHandler(uchar * pkt, unsigned dest, unsigned src, unsigned len)
 		debug("DHCP State: REQUESTING\n");
 
 		if ( DhcpMessageType((u8 *)bp->bp_vend) == DHCP_ACK ) {
-			char *s;
+			DhcpBound(bp);
+			return;
+		}
+		break;
+#if defined(CONFIG_DHCP_LEASE_CACHE)
+	case REBOOTING:
+		debug("DHCP State: REBOOTING\n");
 
-			if (NetReadLong((ulong*)&bp->bp_vend[0]) == htonl(BOOTP_VENDOR_MAGIC))
-				DhcpOptionsProcess((u8 *)&bp->bp_vend[4], bp);
-			BootpCopyNetParams(bp); /* Store net params from reply */
-			dhcp_state = BOUND;
-			printf ("DHCP client bound to address %pI4\n", &NetOurIP);
-
-			/* Obey the 'autoload' setting */
-			if ((s = getenv("autoload")) != NULL) {
-				if (*s == 'n') {
-					/*
-					 * Just use BOOTP to configure system;
-					 * Do not use TFTP to load the bootfile.
-					 */
-					NetState = NETLOOP_SUCCESS;
-					return;
-#if defined(CONFIG_CMD_NFS)
-				} else if (strcmp(s, "NFS") == 0) {
-					/*
-					 * Use NFS to load the bootfile.
-					 */
-					NfsStart();
-					return;
-#endif
-				}
-			}
-			TftpStart();
+		switch (DhcpMessageType((u8 *)bp->bp_vend)) {
+		case DHCP_ACK:
+			DhcpBound(bp);
+			return;
+		case DHCP_NAK:
+			puts ("DHCP: cached lease refused\n");
+			DhcpForgetLease();
+			BootpRequest();
 			return;
 		}
 		break;
+#endif
 	case BOUND:
 		/* DHCP client bound to address */
 		break;
@@ -943,6 +1106,12 @@ DhcpHandler(uchar * pkt, unsigned dest, unsigned src, unsigned len)
 
 void DhcpRequest(void)
 {
+#if defined(CONFIG_DHCP_LEASE_CACHE)
+	if (DhcpLoadLease()) {
+		DhcpSendRebootPkt();
+		return;
+	}
+#endif
 	BootpRequest();
 }
 #endif	/* CONFIG_CMD_DHCP */
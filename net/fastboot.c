@@ -0,0 +1,543 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Fastboot-style UDP flashing service, see <fastboot.h>.
+ *
+ * The partitions are the SPI flash areas of CONFIG_SYS_FASTBOOT_PARTS.
+ * An image is streamed into its partition one erase block at a time:
+ * the block is collected in RAM, then erased and written while the
+ * host waits for the ACK that opens the next block. The host never has
+ * more than CONFIG_SYS_FASTBOOT_WINDOW bytes in flight, so the short RX
+ * ring is not overrun, and nothing arrives while the flash is busy.
+ *
+ * Only one host is served at a time; another one takes over by sending
+ * INIT, which aborts any transfer in progress.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <net.h>
+#include <malloc.h>
+#include <spi_flash.h>
+#include <fastboot.h>
+#include <slot.h>
+#if defined(CONFIG_IMGCACHE)
+#include <imgcache.h>
+#endif
+
+#ifndef CONFIG_SYS_FASTBOOT_PARTS
+# error "CONFIG_SYS_FASTBOOT_PARTS must be defined"
+#endif
+#ifndef CONFIG_SYS_FASTBOOT_ERASE_SIZE
+# define CONFIG_SYS_FASTBOOT_ERASE_SIZE	0x10000
+#endif
+#ifndef CONFIG_SYS_FASTBOOT_WINDOW
+# define CONFIG_SYS_FASTBOOT_WINDOW	(16 << 10)
+#endif
+#ifndef CONFIG_SF_DEFAULT_SPEED
+# define CONFIG_SF_DEFAULT_SPEED	1000000
+#endif
+#ifndef CONFIG_SF_DEFAULT_MODE
+# define CONFIG_SF_DEFAULT_MODE		SPI_MODE_3
+#endif
+
+#define FB_BLOCK	CONFIG_SYS_FASTBOOT_ERASE_SIZE
+#define FB_ACK_EVERY	8		/* DATA packets per ACK		*/
+#define FB_TICK_MS	100
+#define FB_DATA_TIMEOUT	10000		/* Stalled transfer, ms		*/
+
+extern int do_reset(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[]);
+
+struct fb_part {
+	const char	*name;
+	ulong		offset;		/* Erase block aligned		*/
+	ulong		size;
+};
+
+static const struct fb_part fb_part[] = CONFIG_SYS_FASTBOOT_PARTS;
+
+/*
+ * Seconds to wait for a host to show up, 0 for ever
+ */
+ulong FastbootWait;
+
+static int FbLocked;			/* A host sent INIT		*/
+static IPaddr_t FbHostIP;
+static uchar FbHostEther[6];
+static int FbHostPort;
+static ushort FbSeq;			/* Sequence number expected next */
+static uchar FbReply[sizeof(struct fb_hdr) + FB_RESPONSE_MAX];
+static int FbReplyLen;			/* Last answer, 0 if none	*/
+static ulong FbStart;
+static int FbReboot;
+
+static struct spi_flash *FbFlash;
+static uchar *FbBuf;			/* One erase block of the image	*/
+
+/*
+ * The transfer in progress
+ */
+static const struct fb_part *FbPart;	/* NULL if none			*/
+static ulong FbSize;			/* Image size			*/
+static ulong FbAcked;			/* Image bytes received		*/
+static ulong FbBase;			/* Image offset of FbBuf	*/
+static ulong FbLimit;			/* Limit in the last ACK	*/
+static int FbUnacked;			/* DATA packets since the ACK	*/
+static int FbHoleAcked;			/* ACKed the current hole	*/
+static ulong FbTime;			/* get_timer() of last progress	*/
+
+static void FbSend(uchar *ether, IPaddr_t ip, int port, void *data, int len)
+{
+	memcpy((uchar *)NetTxPacket + NetEthHdrSize() + IP_HDR_SIZE,
+		data, len);
+	NetSendUDPPacket(ether, ip, port, FASTBOOT_PORT, len);
+}
+
+static void FbSendAck(int flags)
+{
+	struct fb_ack a;
+	ulong limit = FbAcked;
+
+	if (FbPart) {
+		limit = FbBase + FB_BLOCK;
+		if (limit > FbAcked + CONFIG_SYS_FASTBOOT_WINDOW)
+			limit = FbAcked + CONFIG_SYS_FASTBOOT_WINDOW;
+		if (limit > FbSize)
+			limit = FbSize;
+	}
+
+	a.h.id = FB_ACK;
+	a.h.flags = flags;
+	a.h.seq = 0;
+	a.acked = htonl(FbAcked);
+	a.limit = htonl(limit);
+	FbSend(FbHostEther, FbHostIP, FbHostPort, &a, sizeof(a));
+
+	FbLimit = limit;
+	FbUnacked = 0;
+}
+
+/*
+ * Give up the transfer in progress
+ */
+static void FbError(const char *msg)
+{
+	uchar buf[sizeof(struct fb_hdr) + FB_RESPONSE_MAX];
+	struct fb_hdr *h = (struct fb_hdr *)buf;
+	int len = strlen(msg);
+
+	printf("\nfastboot: %s\n", msg);
+
+	if (len > FB_RESPONSE_MAX)
+		len = FB_RESPONSE_MAX;
+	h->id = FB_ERROR;
+	h->flags = 0;
+	h->seq = 0;
+	memcpy(buf + sizeof(*h), msg, len);
+	FbSend(FbHostEther, FbHostIP, FbHostPort, buf, sizeof(*h) + len);
+
+	FbPart = NULL;
+}
+
+static int FbProbe(void)
+{
+	if (!FbFlash)
+		FbFlash = spi_flash_probe(CONFIG_SPI_FLASH_BUS,
+				CONFIG_SPI_FLASH_CS, CONFIG_SF_DEFAULT_SPEED,
+				CONFIG_SF_DEFAULT_MODE);
+	return FbFlash ? 0 : -1;
+}
+
+/*
+ * Look up the partition named at the start of "s", up to a ':'.
+ * "arg", if not NULL, is set to what follows the ':', or NULL.
+ */
+static const struct fb_part *FbFindPart(const char *s, char **arg)
+{
+	char *p = strchr(s, ':');
+	int len = p ? p - s : strlen(s);
+	int i;
+
+	if (arg)
+		*arg = p ? p + 1 : NULL;
+
+	for (i = 0; i < ARRAY_SIZE(fb_part); i++)
+		if (strlen(fb_part[i].name) == len &&
+		    strncmp(fb_part[i].name, s, len) == 0)
+			return &fb_part[i];
+
+	return NULL;
+}
+
+/*
+ * Parse "<part>:<size>" for flash and crc32
+ */
+static const struct fb_part *FbPartSize(const char *s, ulong *size, char *resp)
+{
+	const struct fb_part *part;
+	char *arg;
+
+	part = FbFindPart(s, &arg);
+	if (!part) {
+		strcpy(resp, "FAILno such partition");
+		return NULL;
+	}
+
+	*size = arg ? simple_strtoul(arg, NULL, 16) : 0;
+	if (*size == 0 || *size > part->size) {
+		strcpy(resp, "FAILbad size");
+		return NULL;
+	}
+
+	if (FbProbe()) {
+		strcpy(resp, "FAILSPI flash probe failed");
+		return NULL;
+	}
+
+	return part;
+}
+
+static void FbGetvar(const char *var, char *resp)
+{
+	const struct fb_part *part;
+	char *s;
+	int i;
+
+	if (strcmp(var, "version") == 0) {
+		strcpy(resp, "OKAY0.4");
+	} else if (strcmp(var, "serialno") == 0) {
+		s = getenv("serial#");
+		strcpy(resp, "OKAY");
+		if (s)
+			strncat(resp, s, FB_RESPONSE_MAX - 4);
+	} else if (strcmp(var, "partitions") == 0) {
+		strcpy(resp, "OKAY");
+		for (i = 0; i < ARRAY_SIZE(fb_part); i++) {
+			if (strlen(resp) + strlen(fb_part[i].name) + 1 >
+			    FB_RESPONSE_MAX)
+				break;
+			if (i)
+				strcat(resp, ",");
+			strcat(resp, fb_part[i].name);
+		}
+	} else if (strncmp(var, "partition-size:", 15) == 0 &&
+		   (part = FbFindPart(var + 15, NULL)) != NULL) {
+		sprintf(resp, "OKAY0x%08lx", part->size);
+	} else {
+		strcpy(resp, "FAILunknown variable");
+	}
+}
+
+static void FbErase(const char *s, char *resp)
+{
+	const struct fb_part *part = FbFindPart(s, NULL);
+
+	if (!part) {
+		strcpy(resp, "FAILno such partition");
+		return;
+	}
+	if (FbProbe()) {
+		strcpy(resp, "FAILSPI flash probe failed");
+		return;
+	}
+
+	printf("fastboot: erasing %s\n", part->name);
+#if defined(CONFIG_IMGCACHE)
+	imgcache_flash_write(part->offset, part->size);
+#endif
+	if (spi_flash_erase(FbFlash, part->offset, part->size)) {
+		strcpy(resp, "FAILflash erase failed");
+		return;
+	}
+	slot_written(part->offset);
+	strcpy(resp, "OKAY");
+}
+
+static void FbFlashStart(const char *s, char *resp)
+{
+	const struct fb_part *part;
+	ulong size;
+
+	part = FbPartSize(s, &size, resp);
+	if (!part)
+		return;
+
+	printf("fastboot: flashing %s, %lu bytes\n", part->name, size);
+
+	FbPart = part;
+	FbSize = size;
+	FbAcked = 0;
+	FbBase = 0;
+	FbHoleAcked = 0;
+	FbTime = get_timer(0);
+	sprintf(resp, "DATA%08lx", size);
+}
+
+static void FbCrc32(const char *s, char *resp)
+{
+	const struct fb_part *part;
+	ulong size, off, len;
+	u32 crc = 0;
+
+	part = FbPartSize(s, &size, resp);
+	if (!part)
+		return;
+
+	for (off = 0; off < size; off += len) {
+		len = min(size - off, (ulong)FB_BLOCK);
+		if (spi_flash_read(FbFlash, part->offset + off, len, FbBuf)) {
+			strcpy(resp, "FAILflash read failed");
+			return;
+		}
+		crc = crc32(crc, FbBuf, len);
+	}
+
+	sprintf(resp, "OKAY%08x", crc);
+}
+
+static void FbCommand(char *cmd)
+{
+	char resp[FB_RESPONSE_MAX + 1];
+	struct fb_hdr *h = (struct fb_hdr *)FbReply;
+
+	if (FbPart)
+		FbError("transfer aborted");
+
+	if (strncmp(cmd, "getvar:", 7) == 0) {
+		FbGetvar(cmd + 7, resp);
+	} else if (strncmp(cmd, "erase:", 6) == 0) {
+		FbErase(cmd + 6, resp);
+	} else if (strncmp(cmd, "flash:", 6) == 0) {
+		FbFlashStart(cmd + 6, resp);
+	} else if (strncmp(cmd, "crc32:", 6) == 0) {
+		FbCrc32(cmd + 6, resp);
+	} else if (strcmp(cmd, "reboot") == 0) {
+		strcpy(resp, "OKAY");
+		FbReboot = 1;
+	} else if (strcmp(cmd, "continue") == 0) {
+		strcpy(resp, "OKAY");
+		NetState = NETLOOP_SUCCESS;
+	} else {
+		strcpy(resp, "FAILunknown command");
+	}
+
+	h->id = FB_FASTBOOT;
+	h->flags = 0;
+	h->seq = htons(FbSeq - 1);
+	FbReplyLen = sizeof(*h) + strlen(resp);
+	memcpy(FbReply + sizeof(*h), resp, FbReplyLen - sizeof(*h));
+	FbSend(FbHostEther, FbHostIP, FbHostPort, FbReply, FbReplyLen);
+
+	/* Tell the host how much it may send */
+	if (FbPart)
+		FbSendAck(0);
+}
+
+/*
+ * Erase and write the collected block
+ */
+static int FbWriteBlock(void)
+{
+	ulong addr = FbPart->offset + FbBase;
+
+#if defined(CONFIG_IMGCACHE)
+	imgcache_flash_write(addr, FB_BLOCK);
+#endif
+	if (spi_flash_erase(FbFlash, addr, FB_BLOCK) ||
+	    spi_flash_write(FbFlash, addr, FbAcked - FbBase, FbBuf)) {
+		FbError("flash write failed");
+		return -1;
+	}
+
+	putc('#');
+	return 0;
+}
+
+static void FbData(uchar *pkt, unsigned len)
+{
+	struct fb_data d;
+	ulong off;
+
+	if (len < sizeof(d))
+		return;
+	memcpy(&d, pkt, sizeof(d));
+	off = ntohl(d.offset);
+	len -= sizeof(d);
+
+	/*
+	 * Retransmissions and probes (empty packets) are always answered;
+	 * data past a hole only once per hole.
+	 */
+	if (!FbPart || off < FbAcked || len == 0) {
+		FbSendAck(0);
+		return;
+	}
+	if (off > FbAcked || off + len > FbLimit) {
+		if (!FbHoleAcked) {
+			FbHoleAcked = 1;
+			FbSendAck(FB_ACK_RESEND);
+		}
+		return;
+	}
+
+	memcpy(FbBuf + off - FbBase, pkt + sizeof(d), len);
+	FbAcked += len;
+	FbHoleAcked = 0;
+	FbTime = get_timer(0);
+
+	if (FbAcked == FbBase + FB_BLOCK || FbAcked == FbSize) {
+		if (FbWriteBlock())
+			return;
+		FbBase = FbAcked;
+		if (FbAcked == FbSize) {
+			printf("\nfastboot: wrote %s\n", FbPart->name);
+			/* Fresh attempts for an A/B slot, see cmd_slot.c */
+			slot_written(FbPart->offset);
+			FbPart = NULL;
+		}
+		FbSendAck(0);
+	} else if (++FbUnacked >= FB_ACK_EVERY || FbAcked == FbLimit) {
+		FbSendAck(0);
+	}
+}
+
+static void
+FbHandler(uchar *pkt, unsigned dest, unsigned src, unsigned len)
+{
+	IP_t *ip = (IP_t *)(pkt - IP_HDR_SIZE);
+	IPaddr_t sip = NetReadIP(&ip->ip_src);
+	uchar ether[6];
+	struct fb_hdr h;
+	struct fb_init init;
+	char cmd[FB_RESPONSE_MAX + 1];
+	ushort seq;
+
+	if (dest != FASTBOOT_PORT || len < sizeof(h))
+		return;
+
+	memcpy(&h, pkt, sizeof(h));
+	memcpy(ether, ((Ethernet_t *)NetRxPacket)->et_src, 6);
+	seq = ntohs(h.seq);
+
+	if (h.id == FB_QUERY) {
+		uchar buf[sizeof(h) + 2];
+
+		memcpy(buf, &h, sizeof(h));
+		buf[sizeof(h)] = FbSeq >> 8;
+		buf[sizeof(h) + 1] = FbSeq & 0xff;
+		FbSend(ether, sip, src, buf, sizeof(buf));
+		return;
+	}
+
+	/* A new session, maybe from another host */
+	if (h.id == FB_INIT && seq == FbSeq && len >= sizeof(init)) {
+		if (FbPart)
+			FbError("transfer aborted");
+		FbLocked = 1;
+		FbHostIP = sip;
+		FbHostPort = src;
+		memcpy(FbHostEther, ether, 6);
+		printf("fastboot: host %pI4:%d\n", &FbHostIP, FbHostPort);
+
+		FbSeq++;
+		init.h = h;
+		init.version = htons(FASTBOOT_VERSION);
+		init.packet_max = htons(FB_PACKET_MAX);
+		FbReplyLen = sizeof(init);
+		memcpy(FbReply, &init, sizeof(init));
+		FbSend(FbHostEther, FbHostIP, FbHostPort, FbReply, FbReplyLen);
+		return;
+	}
+
+	if (!FbLocked || sip != FbHostIP || src != FbHostPort)
+		return;
+
+	switch (h.id) {
+	case FB_DATA:
+		FbData(pkt, len);
+		break;
+
+	case FB_INIT:
+	case FB_FASTBOOT:
+		/* The host did not get our answer */
+		if (seq == (ushort)(FbSeq - 1) && FbReplyLen) {
+			FbSend(FbHostEther, FbHostIP, FbHostPort,
+				FbReply, FbReplyLen);
+			break;
+		}
+		if (h.id != FB_FASTBOOT || seq != FbSeq)
+			break;
+
+		FbSeq++;
+		len -= sizeof(h);
+		if (len > FB_RESPONSE_MAX)
+			len = FB_RESPONSE_MAX;
+		memcpy(cmd, pkt + sizeof(h), len);
+		cmd[len] = '\0';
+		FbCommand(cmd);
+		break;
+	}
+}
+
+static void FbTick(void)
+{
+	if (FbReboot)
+		do_reset(NULL, 0, 0, NULL);
+
+	if (!FbLocked && FastbootWait &&
+	    get_timer(FbStart) >= FastbootWait * 1000) {
+		puts("fastboot: no host\n");
+		NetState = NETLOOP_FAIL;
+		return;
+	}
+
+	if (FbPart && get_timer(FbTime) > FB_DATA_TIMEOUT)
+		FbError("data timeout");
+
+	NetSetTimeout(FB_TICK_MS, FbTick);
+}
+
+void FastbootStart(void)
+{
+	if (!FbBuf) {
+		FbBuf = malloc(FB_BLOCK);
+		if (!FbBuf) {
+			puts("*** ERROR: out of memory\n");
+			NetState = NETLOOP_FAIL;
+			return;
+		}
+	}
+
+	FbLocked = 0;
+	FbReplyLen = 0;
+	FbReboot = 0;
+	FbPart = NULL;
+	FbStart = get_timer(0);
+
+	printf("fastboot: listening on UDP port %d, our IP address is %pI4\n",
+		FASTBOOT_PORT, &NetOurIP);
+
+	NetSetTimeout(FB_TICK_MS, FbTick);
+	NetSetHandler(FbHandler);
+}
@@ -77,7 +77,9 @@
 #include <common.h>
 #include <watchdog.h>
 #include <command.h>
+#include <stdio_dev.h>
 #include <net.h>
+#include <imgcache.h>
 #include "bootp.h"
 #include "tftp.h"
 #include "rarp.h"
@@ -95,6 +97,10 @@
 #if defined(CONFIG_CMD_DNS)
 #include "dns.h"
 #endif
+#if defined(CONFIG_CMD_WGET)
+#include "tcp.h"
+#include "wget.h"
+#endif
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -435,6 +441,21 @@ restart:
 		case DNS:
 			DnsStart();
 			break;
+#endif
+#if defined(CONFIG_CMD_WGET)
+		case WGET:
+			WgetStart();
+			break;
+#endif
+#if defined(CONFIG_CMD_NETBENCH)
+		case NETBENCH:
+			NetbenchStart();
+			break;
+#endif
+#if defined(CONFIG_CMD_FASTBOOT)
+		case FASTBOOT:
+			FastbootStart();
+			break;
 #endif
 		default:
 			break;
@@ -475,11 +496,18 @@ restart:
 		 */
 		eth_rx();
 
+		/*
+		 *	Send netconsole output that has been buffered long
+		 *	enough; tstc() does not while the net loop runs.
+		 */
+		nc_poll();
+
 		/*
 		 *	Abort if ctrl-c was pressed.
 		 */
 		if (ctrlc()) {
 			eth_halt();
+			imgcache_ram_write(load_addr, NetBootFileXferSize);
 			puts ("\nAbort\n");
 			return (-1);
 		}
@@ -522,6 +550,7 @@ restart:
 			goto restart;
 
 		case NETLOOP_SUCCESS:
+			imgcache_ram_write(load_addr, NetBootFileXferSize);
 			if (NetBootFileXferSize > 0) {
 				char buf[20];
 				printf("Bytes transferred = %ld (%lx hex)\n",
@@ -537,6 +566,7 @@ restart:
 			return NetBootFileXferSize;
 
 		case NETLOOP_FAIL:
+			imgcache_ram_write(load_addr, NetBootFileXferSize);
 			return (-1);
 		}
 	}
@@ -684,6 +714,40 @@ NetSendUDPPacket(uchar *ether, IPaddr_t dest, int dport, int sport, int len)
 	return 0;	/* transmitted */
 }
 
+#if defined(CONFIG_CMD_WGET)
+int
+NetSendIPPacket(uchar *ether, IPaddr_t dest, int len)
+{
+	int hlen = NetEthHdrSize();
+
+	/* if MAC address was not discovered yet, save the packet and do an ARP request */
+	if (memcmp(ether, NetEtherNullAddr, 6) == 0) {
+
+		debug("sending ARP for %08lx\n", dest);
+
+		NetArpWaitPacketIP = dest;
+		NetArpWaitPacketMAC = ether;
+
+		NetSetEther (NetArpWaitTxPacket, NetArpWaitPacketMAC, PROT_IP);
+		memcpy(NetArpWaitTxPacket + hlen, (uchar *)NetTxPacket + hlen, len);
+
+		/* size of the waiting packet */
+		NetArpWaitTxPacketSize = hlen + len;
+
+		/* and do the ARP request */
+		NetArpWaitTry = 1;
+		NetArpWaitTimerStart = get_timer(0);
+		ArpRequest();
+		return 1;	/* waiting */
+	}
+
+	NetSetEther (NetTxPacket, ether, PROT_IP);
+	(void) eth_send(NetTxPacket, hlen + len);
+
+	return 0;	/* transmitted */
+}
+#endif
+
 #if defined(CONFIG_CMD_PING)
 static ushort PingSeqNo;
 
@@ -1615,6 +1679,11 @@ NetReceive(volatile uchar * inpkt, int len)
 			default:
 				return;
 			}
+#if defined(CONFIG_CMD_WGET)
+		} else if (ip->ip_p == IPPROTO_TCP) {
+			TcpReceive(ip, len);
+			return;
+#endif
 		} else if (ip->ip_p != IPPROTO_UDP) {	/* Only UDP packets */
 			return;
 		}
@@ -1709,6 +1778,19 @@ static int net_check_prereq (proto_t protocol)
 		}
 		goto common;
 #endif
+#if defined(CONFIG_CMD_WGET)
+	case WGET:
+		/* The server may be given with the file name */
+		goto common;
+#endif
+#if defined(CONFIG_CMD_NETBENCH)
+	case NETBENCH:
+		goto common;
+#endif
+#if defined(CONFIG_CMD_FASTBOOT)
+	case FASTBOOT:
+		goto common;
+#endif
 #if defined(CONFIG_CMD_NFS)
 	case NFS:
 #endif
@@ -1718,7 +1800,9 @@ static int net_check_prereq (proto_t protocol)
 			puts ("*** ERROR: `serverip' not set\n");
 			return (1);
 		}
-#if defined(CONFIG_CMD_PING) || defined(CONFIG_CMD_SNTP)
+#if defined(CONFIG_CMD_PING) || defined(CONFIG_CMD_SNTP) || \
+    defined(CONFIG_CMD_DNS) || defined(CONFIG_CMD_WGET) || \
+    defined(CONFIG_CMD_NETBENCH) || defined(CONFIG_CMD_FASTBOOT)
     common:
 #endif
 
@@ -1772,7 +1856,7 @@ NetCksumOk(uchar * ptr, int len)
 }
 
 
-unsigned
+unsigned __hotcode
 NetCksum(uchar * ptr, int len)
 {
 	ulong	xsum;
@@ -1870,7 +1954,9 @@ void copy_filename (char *dst, char *src, int size)
 	*dst = '\0';
 }
 
-#if defined(CONFIG_CMD_NFS) || defined(CONFIG_CMD_SNTP) || defined(CONFIG_CMD_DNS)
+#if defined(CONFIG_CMD_NFS) || defined(CONFIG_CMD_SNTP) || \
+    defined(CONFIG_CMD_DNS) || defined(CONFIG_CMD_WGET) || \
+    defined(CONFIG_CMD_NETBENCH)
 /*
  * make port a little random, but use something trivial to compute
  */
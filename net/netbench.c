@@ -0,0 +1,250 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * UDP throughput benchmark.
+ *
+ * In send mode, frames of NetbenchLen payload bytes are sent back to
+ * back to NetbenchIP for NetbenchSeconds, as fast as the driver takes
+ * them. In sink mode, frames to NetbenchPort are counted until the
+ * sender's END frames arrive, the sender goes quiet, NetbenchSeconds
+ * pass (if not 0) or ctrl-c is pressed. See <netbench.h> for the frame
+ * layout and tools/netbench for the host side.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <net.h>
+#include <netbench.h>
+#include <div64.h>
+
+#define NETBENCH_TICK_MS	100	/* Sink timeout check period	*/
+#define NETBENCH_IDLE_MS	2000	/* Sink stops after this silence */
+#define NETBENCH_POLL		32	/* Frames sent between RX polls	*/
+
+int		NetbenchSink;			/* Count frames, not send */
+IPaddr_t	NetbenchIP;			/* Where to send to	*/
+int		NetbenchPort = NETBENCH_PORT;	/* Port to send/listen to */
+ulong		NetbenchSeconds = 10;		/* Run length		*/
+int		NetbenchLen = NETBENCH_MAX_LEN;	/* UDP payload length	*/
+
+static uchar NetbenchEther[6];
+static int NetbenchOurPort;
+
+/*
+ * Statistics of the last run
+ */
+static struct {
+	ulong	frames;
+	ulong	bytes;
+	ulong	lost;		/* Sequence gaps not filled later */
+	ulong	reordered;	/* Late or duplicate frames	*/
+	ulong	first;		/* usec of the first frame	*/
+	ulong	last;		/* usec of the last frame	*/
+	ulong	next;		/* Sequence number expected next */
+	long	transit;	/* Transit time of the last frame */
+	ulong	jitter;		/* Jitter estimate, usec << 4	*/
+	ulong	start;		/* get_timer() at start		*/
+	ulong	seen;		/* get_timer() at the last frame */
+} nb;
+
+static void NetbenchSend(ulong seq, ulong flags)
+{
+	struct netbench_hdr h;
+
+	h.magic = htonl(NETBENCH_MAGIC);
+	h.seq = htonl(seq);
+	h.usec = htonl(timer_get_us());
+	h.flags = htonl(flags);
+
+	/* The payload is not word aligned */
+	memcpy((uchar *)NetTxPacket + NetEthHdrSize() + IP_HDR_SIZE,
+		&h, sizeof(h));
+	NetSendUDPPacket(NetbenchEther, NetbenchIP, NetbenchPort,
+			 NetbenchOurPort, NetbenchLen);
+}
+
+static void NetbenchSendRun(void)
+{
+	ulong start;
+	int i;
+
+	/* Frame 0 went out with the ARP reply */
+	if (memcmp(NetbenchEther, NetEtherNullAddr, 6) == 0) {
+		NetSetTimeout(1, NetbenchSendRun);
+		return;
+	}
+
+	start = get_timer(0);
+	while (get_timer(start) < NetbenchSeconds * 1000) {
+		NetbenchSend(nb.frames++, 0);
+		nb.bytes += NetbenchLen;
+		nb.last = timer_get_us();
+
+		/* Keep the RX ring drained, and answer ARP requests */
+		if (nb.frames % NETBENCH_POLL == 0) {
+			eth_rx();
+			if (ctrlc()) {
+				eth_halt();
+				puts("\nAbort\n");
+				NetState = NETLOOP_FAIL;
+				return;
+			}
+		}
+	}
+
+	for (i = 0; i < NETBENCH_END_COUNT; i++)
+		NetbenchSend(nb.frames, NETBENCH_F_END);
+
+	NetState = NETLOOP_SUCCESS;
+}
+
+static void
+NetbenchHandler(uchar *pkt, unsigned dest, unsigned src, unsigned len)
+{
+	struct netbench_hdr h;
+	ulong now = timer_get_us();
+	ulong seq;
+	long d;
+
+	if (!NetbenchSink || dest != NetbenchPort || len < sizeof(h))
+		return;
+
+	memcpy(&h, pkt, sizeof(h));
+	if (ntohl(h.magic) != NETBENCH_MAGIC)
+		return;
+
+	seq = ntohl(h.seq);
+	if (ntohl(h.flags) & NETBENCH_F_END) {
+		/* Account for losses at the tail of the run */
+		if (seq > nb.next)
+			nb.lost += seq - nb.next;
+		NetState = NETLOOP_SUCCESS;
+		return;
+	}
+
+	if (nb.frames == 0)
+		nb.first = now;
+	nb.last = now;
+	nb.seen = get_timer(0);
+	nb.frames++;
+	nb.bytes += len;
+
+	if (seq >= nb.next) {
+		nb.lost += seq - nb.next;
+		nb.next = seq + 1;
+	} else {
+		nb.reordered++;
+		if (nb.lost)
+			nb.lost--;
+	}
+
+	/*
+	 * Interarrival jitter, as in RFC 3550, A.8. The clock offset
+	 * between the two ends cancels out.
+	 */
+	d = (long)(now - ntohl(h.usec));
+	if (nb.frames > 1) {
+		long t = d;
+
+		d -= nb.transit;
+		if (d < 0)
+			d = -d;
+		nb.jitter += d - ((nb.jitter + 8) >> 4);
+		d = t;
+	}
+	nb.transit = d;
+}
+
+static void NetbenchSinkTick(void)
+{
+	if (nb.frames && get_timer(nb.seen) > NETBENCH_IDLE_MS) {
+		puts("Sender went quiet\n");
+		NetState = NETLOOP_SUCCESS;
+		return;
+	}
+
+	if (NetbenchSeconds &&
+	    get_timer(nb.start) >= NetbenchSeconds * 1000) {
+		NetState = NETLOOP_SUCCESS;
+		return;
+	}
+
+	NetSetTimeout(NETBENCH_TICK_MS, NetbenchSinkTick);
+}
+
+void NetbenchStart(void)
+{
+	memset(&nb, 0, sizeof(nb));
+	nb.start = get_timer(0);
+
+	NetSetHandler(NetbenchHandler);
+
+	if (NetbenchSink) {
+		printf("Counting UDP frames to port %d, ctrl-c to stop\n",
+			NetbenchPort);
+		NetSetTimeout(NETBENCH_TICK_MS, NetbenchSinkTick);
+		return;
+	}
+
+	printf("Sending %d byte UDP frames to %pI4:%d for %lu s\n",
+		NetbenchLen, &NetbenchIP, NetbenchPort, NetbenchSeconds);
+
+	NetbenchOurPort = random_port();
+	memset(NetbenchEther, 0, 6);
+	memset((uchar *)NetTxPacket + NetEthHdrSize() + IP_HDR_SIZE, 0,
+		NetbenchLen);
+
+	/* Resolve the target with frame 0 */
+	nb.first = timer_get_us();
+	NetbenchSend(nb.frames++, 0);
+	nb.bytes += NetbenchLen;
+	NetSetTimeout(1, NetbenchSendRun);
+}
+
+void NetbenchReport(void)
+{
+	ulong us = nb.last - nb.first;
+	unsigned long long fps, kbs;
+
+	if (us == 0)
+		us = 1;
+
+	fps = (unsigned long long)nb.frames * 1000000;
+	do_div(fps, us);
+	kbs = (unsigned long long)nb.bytes * 8000;
+	do_div(kbs, us);
+
+	printf("  %-10s %10lu\n", "frames", nb.frames);
+	printf("  %-10s %10lu\n", "bytes", nb.bytes);
+	printf("  %-10s %10lu ms\n", "time", us / 1000);
+	printf("  %-10s %10lu frames/s %8lu kbit/s\n", "rate",
+		(ulong)fps, (ulong)kbs);
+
+	if (!NetbenchSink)
+		return;
+
+	printf("  %-10s %10lu\n", "lost", nb.lost);
+	printf("  %-10s %10lu\n", "reordered", nb.reordered);
+	printf("  %-10s %10lu us\n", "jitter", nb.jitter >> 4);
+}
@@ -0,0 +1,472 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Minimal TCP client.
+ *
+ * There is a single, actively opened connection, made for pulling one
+ * large response (see wget.c) into memory:
+ *
+ * - Every in-order segment is consumed as soon as eth_rx() polls it,
+ *   so the receive window is what the ethernet RX ring can hold:
+ *   anything the peer sends beyond it is dropped by the MAC whenever a
+ *   burst arrives faster than we poll. Boards size the ring and set
+ *   CONFIG_SYS_TCP_RCV_WND to match; ${tcpwin} overrides it at run
+ *   time. tools/tcpsim measures the effect of both.
+ * - ACKs are delayed until every second segment, or TCP_DELACK_MS;
+ *   with a window of four segments or less, every segment is acked.
+ * - There is no reassembly and no SACK: a segment beyond a hole is
+ *   dropped and answered with a duplicate ACK, which triggers the
+ *   peer's fast retransmit.
+ * - We only ever have a SYN, one small request or a FIN in flight.
+ *   These are retransmitted with exponential backoff.
+ * - Closing waits at most TCP_CLOSE_MS for the FIN handshake, and
+ *   TIME_WAIT is skipped; the next connection uses a new local port.
+ */
+
+#include <common.h>
+#include <net.h>
+#include "tcp.h"
+
+#ifndef CONFIG_SYS_TCP_RCV_WND
+# define CONFIG_SYS_TCP_RCV_WND	(PKTBUFSRX * TCP_MSS)
+#endif
+
+#define TCP_TICK_MS	10	/* Timer resolution			*/
+#define TCP_DELACK_MS	40	/* Delayed ACK timeout			*/
+#define TCP_RTO_MS	500	/* Initial retransmission timeout	*/
+#define TCP_RTO_MAX_MS	8000
+#define TCP_RETRIES	8
+#define TCP_IDLE_MS	15000	/* Give up on a silent peer		*/
+#define TCP_CLOSE_MS	2000	/* Longest wait for a clean close	*/
+
+#define SEQ_LT(a, b)	((int)((a) - (b)) < 0)
+
+enum {
+	TCP_CLOSED,
+	TCP_SYN_SENT,
+	TCP_ESTABLISHED,
+	TCP_FIN_WAIT_1,		/* Our FIN sent, not acked yet		*/
+	TCP_FIN_WAIT_2,		/* Our FIN acked, peer still sending	*/
+	TCP_CLOSE_WAIT,		/* Peer FIN received			*/
+	TCP_LAST_ACK,		/* Both FINs sent, ours not acked yet	*/
+};
+
+static struct {
+	int		state;
+	IPaddr_t	ip;
+	uchar		ether[6];
+	ushort		lport;
+	ushort		rport;
+	u32		snd_una;	/* Oldest unacknowledged seq	*/
+	u32		snd_nxt;	/* Next seq to send		*/
+	u32		rcv_nxt;	/* Next seq expected		*/
+	ushort		rcv_wnd;	/* Window we announce		*/
+	const uchar	*tx;		/* Unacknowledged data		*/
+	unsigned	txlen;
+	int		txflags;	/* Unacknowledged SYN/FIN	*/
+	int		retries;
+	ulong		rto;
+	ulong		rtx_time;	/* Last (re)transmission	*/
+	ulong		ack_time;	/* First unacknowledged segment	*/
+	int		ack_segs;	/* Segments not acked yet	*/
+	ulong		rx_time;	/* Last segment from the peer	*/
+	ulong		close_time;	/* TcpClose() called		*/
+	tcp_recv_f	*recv;
+	tcp_event_f	*event;
+} tcb;
+
+static u32 tcp_get32(const uchar *p)
+{
+	return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static void tcp_put32(uchar *p, u32 v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+/*
+ * Sum of the pseudo header and len bytes of TCP segment; 0xffff if a
+ * received segment is intact
+ */
+static uint tcp_cksum(IP_t *ip, unsigned len)
+{
+	uchar *p = (uchar *)ip + IP_HDR_SIZE_NO_UDP;
+	ushort ph[6];
+	ushort last = 0;
+	uint sum;
+
+	memcpy(ph, (void *)&ip->ip_src, 8);
+	ph[4] = htons(IPPROTO_TCP);
+	ph[5] = htons(len);
+
+	sum = NetCksum((uchar *)ph, 6) + NetCksum(p, len / 2);
+	if (len & 1) {
+		*(uchar *)&last = p[len - 1];
+		sum += last;
+	}
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return sum;
+}
+
+static void tcp_output(int flags, u32 seq, const uchar *data, unsigned len)
+{
+	IP_t *ip = (IP_t *)(NetTxPacket + NetEthHdrSize());
+	TCP_t *th = (TCP_t *)((uchar *)ip + IP_HDR_SIZE_NO_UDP);
+	unsigned hlen = TCP_HDR_SIZE;
+	uchar *opt = (uchar *)(th + 1);
+
+	/* Announce our MSS with the SYN */
+	if (flags & TCP_SYN) {
+		opt[0] = 2;
+		opt[1] = 4;
+		opt[2] = TCP_MSS >> 8;
+		opt[3] = TCP_MSS & 0xff;
+		hlen += 4;
+	}
+	if (len)
+		memcpy((uchar *)th + hlen, data, len);
+
+	th->tcp_src = htons(tcb.lport);
+	th->tcp_dst = htons(tcb.rport);
+	tcp_put32(th->tcp_seq, seq);
+	tcp_put32(th->tcp_ack, (flags & TCP_ACK) ? tcb.rcv_nxt : 0);
+	th->tcp_off = (hlen / 4) << 4;
+	th->tcp_flags = flags;
+	th->tcp_wnd = htons(tcb.rcv_wnd);
+	th->tcp_sum = 0;
+	th->tcp_urp = 0;
+
+	ip->ip_hl_v  = 0x45;
+	ip->ip_tos   = 0;
+	ip->ip_len   = htons(IP_HDR_SIZE_NO_UDP + hlen + len);
+	ip->ip_id    = htons(NetIPID++);
+	ip->ip_off   = htons(IP_FLAGS_DFRAG);
+	ip->ip_ttl   = 255;
+	ip->ip_p     = IPPROTO_TCP;
+	ip->ip_sum   = 0;
+	NetCopyIP((void *)&ip->ip_src, &NetOurIP);
+	NetCopyIP((void *)&ip->ip_dst, &tcb.ip);
+	ip->ip_sum   = ~NetCksum((uchar *)ip, IP_HDR_SIZE_NO_UDP / 2);
+
+	th->tcp_sum = ~tcp_cksum(ip, hlen + len);
+
+	if (flags & TCP_ACK)
+		tcb.ack_segs = 0;
+
+	NetSendIPPacket(tcb.ether, tcb.ip, IP_HDR_SIZE_NO_UDP + hlen + len);
+}
+
+static void tcp_ack_now(void)
+{
+	tcp_output(TCP_ACK, tcb.snd_nxt, NULL, 0);
+}
+
+static void tcp_retransmit(void)
+{
+	int flags = tcb.txflags;
+
+	if (!(flags & TCP_SYN))
+		flags |= TCP_ACK | (tcb.txlen ? TCP_PSH : 0);
+
+	tcp_output(flags, tcb.snd_una, tcb.tx, tcb.txlen);
+}
+
+/* (Re)start the retransmission timer for new data */
+static void tcp_rtx_start(void)
+{
+	tcb.rtx_time = get_timer(0);
+	tcb.rto = TCP_RTO_MS;
+	tcb.retries = 0;
+}
+
+static void tcp_drop(int event)
+{
+	tcb.state = TCP_CLOSED;
+	NetSetTimeout(0, NULL);
+	tcb.event(event);
+}
+
+static void tcp_acked(u32 ack)
+{
+	u32 n;
+
+	if (!SEQ_LT(tcb.snd_una, ack) || SEQ_LT(tcb.snd_nxt, ack))
+		return;
+
+	n = ack - tcb.snd_una;
+	if (tcb.txflags & TCP_SYN) {
+		tcb.txflags &= ~TCP_SYN;
+		n--;
+	}
+	n = min(n, tcb.txlen);
+	tcb.tx += n;
+	tcb.txlen -= n;
+	if (ack == tcb.snd_nxt)
+		tcb.txflags = 0;
+
+	tcb.snd_una = ack;
+	tcp_rtx_start();
+}
+
+static void TcpTimer(void)
+{
+	ulong now = get_timer(0);
+
+	NetSetTimeout(TCP_TICK_MS, TcpTimer);
+
+	if ((tcb.state == TCP_FIN_WAIT_1 || tcb.state == TCP_FIN_WAIT_2 ||
+	     tcb.state == TCP_LAST_ACK) &&
+	    now - tcb.close_time >= TCP_CLOSE_MS) {
+		tcp_drop(TCP_EV_CLOSED);
+		return;
+	}
+
+	if (tcb.ack_segs && now - tcb.ack_time >= TCP_DELACK_MS)
+		tcp_ack_now();
+
+	if (tcb.snd_una != tcb.snd_nxt) {
+		if (now - tcb.rtx_time < tcb.rto)
+			return;
+		if (++tcb.retries > TCP_RETRIES) {
+			tcp_drop(TCP_EV_TIMEOUT);
+			return;
+		}
+		debug("TCP: retransmit %u, rto %lu\n", tcb.snd_una, tcb.rto);
+		tcb.rtx_time = now;
+		tcb.rto = min(tcb.rto * 2, TCP_RTO_MAX_MS);
+		tcp_retransmit();
+	} else if (now - tcb.rx_time >= TCP_IDLE_MS) {
+		tcp_drop(TCP_EV_TIMEOUT);
+	}
+}
+
+void TcpConnect(IPaddr_t ip, int port, tcp_recv_f *recv, tcp_event_f *event)
+{
+	ulong wnd = CONFIG_SYS_TCP_RCV_WND;
+	char *s;
+	u32 iss;
+
+	memset(&tcb, 0, sizeof(tcb));
+	tcb.ip = ip;
+	tcb.rport = port;
+	tcb.lport = random_port();
+	tcb.recv = recv;
+	tcb.event = event;
+
+	s = getenv("tcpwin");
+	if (s)
+		wnd = simple_strtoul(s, NULL, 0);
+	if (wnd < TCP_MSS)
+		wnd = TCP_MSS;
+	tcb.rcv_wnd = wnd > 0xffff ? 0xffff : wnd;
+
+	/* RFC 793 style ISN: a 4 us clock */
+	iss = get_timer(0) * 250;
+	tcb.snd_una = iss;
+	tcb.snd_nxt = iss + 1;
+	tcb.txflags = TCP_SYN;
+	tcb.state = TCP_SYN_SENT;
+	tcp_rtx_start();
+	tcb.rx_time = tcb.rtx_time;
+
+	tcp_output(TCP_SYN, iss, NULL, 0);
+	NetSetTimeout(TCP_TICK_MS, TcpTimer);
+}
+
+int TcpSend(const uchar *data, unsigned len)
+{
+	if ((tcb.state != TCP_ESTABLISHED && tcb.state != TCP_CLOSE_WAIT) ||
+	    tcb.snd_una != tcb.snd_nxt || len > TCP_MSS)
+		return -1;
+
+	tcb.tx = data;
+	tcb.txlen = len;
+	tcb.snd_nxt += len;
+	tcp_rtx_start();
+	tcp_output(TCP_ACK | TCP_PSH, tcb.snd_una, data, len);
+
+	return 0;
+}
+
+void TcpClose(void)
+{
+	if (tcb.state == TCP_ESTABLISHED)
+		tcb.state = TCP_FIN_WAIT_1;
+	else if (tcb.state == TCP_CLOSE_WAIT)
+		tcb.state = TCP_LAST_ACK;
+	else
+		return;
+
+	if (tcb.snd_una == tcb.snd_nxt)
+		tcp_rtx_start();
+	tcb.close_time = get_timer(0);
+	tcb.txflags |= TCP_FIN;
+	tcb.snd_nxt++;
+	tcp_output(TCP_FIN | TCP_ACK, tcb.snd_nxt - 1, NULL, 0);
+}
+
+void TcpAbort(void)
+{
+	if (tcb.state == TCP_CLOSED)
+		return;
+
+	if (tcb.state != TCP_SYN_SENT)
+		tcp_output(TCP_RST | TCP_ACK, tcb.snd_nxt, NULL, 0);
+	tcb.state = TCP_CLOSED;
+	NetSetTimeout(0, NULL);
+}
+
+void TcpReceive(IP_t *ip, unsigned len)
+{
+	TCP_t *th = (TCP_t *)((uchar *)ip + IP_HDR_SIZE_NO_UDP);
+	unsigned tlen, hlen, dlen;
+	uchar *data;
+	u32 seq, ack;
+	int flags;
+
+	if (tcb.state == TCP_CLOSED ||
+	    len < IP_HDR_SIZE_NO_UDP + TCP_HDR_SIZE ||
+	    NetReadIP(&ip->ip_src) != tcb.ip ||
+	    ntohs(th->tcp_src) != tcb.rport ||
+	    ntohs(th->tcp_dst) != tcb.lport)
+		return;
+
+	tlen = len - IP_HDR_SIZE_NO_UDP;
+	if (tcp_cksum(ip, tlen) != 0xffff) {
+		debug("TCP: bad checksum\n");
+		return;
+	}
+	hlen = (th->tcp_off >> 4) * 4;
+	if (hlen < TCP_HDR_SIZE || hlen > tlen)
+		return;
+
+	data = (uchar *)th + hlen;
+	dlen = tlen - hlen;
+	seq = tcp_get32(th->tcp_seq);
+	ack = tcp_get32(th->tcp_ack);
+	flags = th->tcp_flags;
+
+	tcb.rx_time = get_timer(0);
+
+	if (tcb.state == TCP_SYN_SENT) {
+		if (!(flags & TCP_ACK) || ack != tcb.snd_nxt)
+			return;
+		if (flags & TCP_RST) {
+			tcp_drop(TCP_EV_RESET);
+			return;
+		}
+		if (!(flags & TCP_SYN))
+			return;
+
+		tcb.rcv_nxt = seq + 1;
+		tcp_acked(ack);
+		tcb.state = TCP_ESTABLISHED;
+		tcp_ack_now();
+		tcb.event(TCP_EV_CONNECTED);
+		return;
+	}
+
+	if (flags & TCP_RST) {
+		if (seq == tcb.rcv_nxt)
+			tcp_drop(TCP_EV_RESET);
+		return;
+	}
+
+	if (flags & TCP_ACK) {
+		tcp_acked(ack);
+		if (tcb.snd_una == tcb.snd_nxt) {
+			if (tcb.state == TCP_FIN_WAIT_1) {
+				tcb.state = TCP_FIN_WAIT_2;
+			} else if (tcb.state == TCP_LAST_ACK) {
+				tcp_drop(TCP_EV_CLOSED);
+				return;
+			}
+		}
+	}
+
+	if (!dlen && !(flags & TCP_FIN))
+		return;
+
+	/* Trim what we already have, e.g. an overlapping retransmission */
+	if (SEQ_LT(seq, tcb.rcv_nxt)) {
+		u32 dup = tcb.rcv_nxt - seq;
+
+		if (dup > dlen || (dup == dlen && !(flags & TCP_FIN))) {
+			tcp_ack_now();
+			return;
+		}
+		data += dup;
+		dlen -= dup;
+		seq += dup;
+	}
+
+	/* Beyond a hole: drop, and tell the peer what we are missing */
+	if (seq != tcb.rcv_nxt) {
+		tcp_ack_now();
+		return;
+	}
+
+	if (dlen && tcb.state != TCP_CLOSE_WAIT && tcb.state != TCP_LAST_ACK) {
+		tcb.rcv_nxt += dlen;
+		if (!tcb.ack_segs)
+			tcb.ack_time = tcb.rx_time;
+		tcb.ack_segs++;
+		tcb.recv(data, dlen);
+		/* The receiver may have closed or aborted */
+		if (tcb.state == TCP_CLOSED)
+			return;
+	}
+
+	if (flags & TCP_FIN) {
+		tcb.rcv_nxt++;
+		tcp_ack_now();
+		switch (tcb.state) {
+		case TCP_ESTABLISHED:
+			tcb.state = TCP_CLOSE_WAIT;
+			tcb.event(TCP_EV_FIN);
+			break;
+		case TCP_FIN_WAIT_1:
+			/* Simultaneous close: wait for the ACK of our FIN */
+			tcb.state = TCP_LAST_ACK;
+			break;
+		case TCP_FIN_WAIT_2:
+			tcp_drop(TCP_EV_CLOSED);
+			break;
+		}
+		return;
+	}
+
+	/*
+	 * With a window of only a few segments the peer stalls until our
+	 * ACK; then every segment is acknowledged as it is consumed
+	 */
+	if (tcb.ack_segs >= 2 || tcb.ack_segs * TCP_MSS * 4 >= tcb.rcv_wnd)
+		tcp_ack_now();
+}
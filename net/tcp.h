@@ -0,0 +1,89 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Minimal TCP client, see tcp.c
+ */
+#ifndef __TCP_H__
+#define __TCP_H__
+
+#define TCP_HDR_SIZE	20	/* TCP header without options		*/
+#define TCP_MSS		1460	/* Our MSS on a 1500 byte MTU		*/
+
+/*
+ * TCP header. The sequence numbers are not 32-bit aligned in the frame
+ * (the IP header starts at offset 14), so they are kept as byte arrays.
+ */
+typedef struct {
+	ushort	tcp_src;	/* Source port				*/
+	ushort	tcp_dst;	/* Destination port			*/
+	uchar	tcp_seq[4];	/* Sequence number			*/
+	uchar	tcp_ack[4];	/* Acknowledgement number		*/
+	uchar	tcp_off;	/* Header length in words << 4		*/
+	uchar	tcp_flags;	/* Flags				*/
+	ushort	tcp_wnd;	/* Receive window			*/
+	ushort	tcp_sum;	/* Checksum				*/
+	ushort	tcp_urp;	/* Urgent pointer			*/
+} TCP_t;
+
+#define TCP_FIN		0x01
+#define TCP_SYN		0x02
+#define TCP_RST		0x04
+#define TCP_PSH		0x08
+#define TCP_ACK		0x10
+
+/*
+ * Events reported to the user of the connection
+ */
+enum {
+	TCP_EV_CONNECTED,	/* Handshake done, TcpSend() may be used	*/
+	TCP_EV_FIN,		/* Peer has no more data			*/
+	TCP_EV_CLOSED,		/* Both sides closed				*/
+	TCP_EV_RESET,		/* Connection reset by peer			*/
+	TCP_EV_TIMEOUT,		/* Retransmissions exhausted or peer silent	*/
+};
+
+typedef void tcp_recv_f(uchar *data, unsigned len);
+typedef void tcp_event_f(int event);
+
+/*
+ * Open the (only) connection to ip:port. The TCP timers use the net
+ * loop timeout, so callers must not call NetSetTimeout() themselves.
+ */
+extern void	TcpConnect(IPaddr_t ip, int port,
+			   tcp_recv_f *recv, tcp_event_f *event);
+
+/*
+ * Send len (<= TCP_MSS) bytes. Only one send may be outstanding, and the
+ * data must stay valid until it is acknowledged. Returns -1 if not
+ * connected or still waiting for an ACK.
+ */
+extern int	TcpSend(const uchar *data, unsigned len);
+
+extern void	TcpClose(void);		/* Send our FIN		*/
+extern void	TcpAbort(void);		/* Send RST and forget	*/
+
+/* Input from NetReceive() */
+extern void	TcpReceive(IP_t *ip, unsigned len);
+
+#endif /* __TCP_H__ */
@@ -45,6 +45,13 @@ static int TftpTimeoutCountMax = TIMEOUT_COUNT;
 ulong TftpRRQTimeoutMSecs = TIMEOUT;
 int TftpRRQTimeoutCountMax = TIMEOUT_COUNT;
 
+/*
+ * If set, TftpStoreHook is called with the offset (from load_addr) and
+ * length of each block as it is stored, so that a consumer can process
+ * the file while it is being received.
+ */
+void (*TftpStoreHook)(ulong offset, ulong len);
+
 enum {
 	TFTP_ERR_UNDEFINED           = 0,
 	TFTP_ERR_FILE_NOT_FOUND      = 1,
@@ -120,6 +127,35 @@ static ulong TftpEndingBlock; /* can get 'last' block before done..*/
 
 static void parse_multicast_oack(char *pkt,int len);
 
+/* 'block' is the block index from 0, as store_block() gets it (TFTP block
+ * number - 1). The default map covers 32768 blocks, i.e. 16MB at 512 byte
+ * blocks and ~48MB at blksize 1468.
+ */
+static void
+mcast_set_block(unsigned block)
+{
+	if (block < Mapsize * 8)
+		Bitmap[block / 32] |= 1U << (block % 32);
+}
+
+/* First block not yet received, starting at 'from'; Mapsize*8 if none */
+static int
+mcast_next_hole(int from)
+{
+	int i = from / 32, n = Mapsize / 4;
+	unsigned w;
+
+	if (from >= Mapsize * 8)
+		return Mapsize * 8;
+	w = Bitmap[i] | ((1U << (from % 32)) - 1);
+	while (w == ~0U) {
+		if (++i >= n)
+			return Mapsize * 8;
+		w = Bitmap[i];
+	}
+	return i * 32 + ffz(w);
+}
+
 static void
 mcast_cleanup(void)
 {
@@ -165,11 +201,14 @@ store_block (unsigned block, uchar * src, unsigned len)
 	}
 #ifdef CONFIG_MCAST_TFTP
 	if (Multicast)
-		ext2_set_bit(block, Bitmap);
+		mcast_set_block(block);
 #endif
 
 	if (NetBootFileXferSize < newsize)
 		NetBootFileXferSize = newsize;
+
+	if (TftpStoreHook)
+		TftpStoreHook(offset, len);
 }
 
 static void TftpSend (void);
@@ -238,7 +277,7 @@ TftpSend (void)
 #ifdef CONFIG_MCAST_TFTP
 		/* My turn!  Start at where I need blocks I missed.*/
 		if (Multicast)
-			TftpBlock=ext2_find_next_zero_bit(Bitmap,(Mapsize*8),0);
+			TftpBlock=mcast_next_hole(0);
 		/*..falling..*/
 #endif
 	case STATE_DATA:
@@ -427,15 +466,14 @@ TftpHandler (uchar * pkt, unsigned dest, unsigned src, unsigned len)
 		 * needed block is; else I'm passive; not ACKING
 		 */
 		if (Multicast) {
-			if (len < TftpBlkSize)  {
+			if (len < TftpBlkSize)
 				TftpEndingBlock = TftpBlock;
-			} else if (MasterClient) {
+			/* ..the last block doesn't mean there are no holes */
+			if (MasterClient) {
 				TftpBlock = PrevBitmapHole =
-					ext2_find_next_zero_bit(
-						Bitmap,
-						(Mapsize*8),
-						PrevBitmapHole);
-				if (TftpBlock > ((Mapsize*8) - 1)) {
+					mcast_next_hole(PrevBitmapHole);
+				if (TftpBlock > ((Mapsize*8) - 1)
+				 && TftpBlock < TftpEndingBlock) {
 					printf ("tftpfile too big\n");
 					/* try to double it and retry */
 					Mapsize<<=1;
@@ -0,0 +1,398 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * HTTP GET over tcp.c.
+ *
+ * The file name is "[host[:port]]/path"; the server defaults to
+ * ${serverip} and the port to ${httpport}, else 80. The response body
+ * goes to load_addr, or straight into SPI flash when WgetFlashOffset is
+ * set. In the latter case each erase block is erased when the data
+ * first reaches it; the peer simply retransmits what the RX ring drops
+ * meanwhile.
+ *
+ * Only plain (identity encoded) responses with status 200 are accepted.
+ */
+
+#include <common.h>
+#include <command.h>
+#include <net.h>
+#include <malloc.h>
+#include <linux/ctype.h>
+#if defined(CONFIG_CMD_SF)
+#include <spi_flash.h>
+#endif
+#if defined(CONFIG_IMGCACHE)
+#include <imgcache.h>
+#endif
+#include "tcp.h"
+#include "wget.h"
+
+#define WGET_HDR_MAX	1024		/* Longest response header	*/
+#define WGET_REQ_MAX	(sizeof(BootFile) + 128)
+#define HASH_BYTES	(32 << 10)	/* Bytes per "loading" hash	*/
+#define HASHES_PER_LINE	65
+
+#ifndef CONFIG_SYS_WGET_SF_ERASE_SIZE
+# define CONFIG_SYS_WGET_SF_ERASE_SIZE	0x10000
+#endif
+#ifndef CONFIG_SF_DEFAULT_SPEED
+# define CONFIG_SF_DEFAULT_SPEED	1000000
+#endif
+#ifndef CONFIG_SF_DEFAULT_MODE
+# define CONFIG_SF_DEFAULT_MODE		SPI_MODE_3
+#endif
+
+/*
+ * If not WGET_TO_RAM, the SPI flash offset to write the file to
+ */
+ulong WgetFlashOffset = WGET_TO_RAM;
+
+enum {
+	WGET_HEADER,		/* Reading the response header	*/
+	WGET_BODY,		/* Storing the body		*/
+	WGET_DONE,
+};
+
+static int WgetState;
+static IPaddr_t WgetServerIP;
+static int WgetServerPort;
+static char *WgetRequest;
+static char *WgetHeader;	/* In the malloc() pool, not eSRAM */
+static unsigned WgetHeaderLen;
+static ulong WgetLength;	/* Content-Length, ~0 if not given */
+static ulong WgetOffset;	/* Body bytes stored		*/
+static ulong WgetHashes;
+static ulong WgetTime;
+#if defined(CONFIG_CMD_SF)
+static struct spi_flash *WgetFlash;
+static ulong WgetErased;	/* End of the erased flash	*/
+#endif
+
+static void WgetFail(const char *msg)
+{
+	printf("\nHTTP error: %s\n", msg);
+	TcpAbort();
+	NetState = NETLOOP_FAIL;
+}
+
+static void WgetDone(void)
+{
+	ulong ms = get_timer(WgetTime);
+
+	WgetState = WGET_DONE;
+	NetBootFileXferSize = WgetOffset;
+	printf("\ndone (%lu KiB/s)\n", (WgetOffset / (ms ? ms : 1)) *
+		1000 / 1024);
+
+	/* Finish once the connection is closed (or given up on) */
+	TcpClose();
+}
+
+#if defined(CONFIG_CMD_SF)
+static int WgetStoreFlash(ulong offset, uchar *data, unsigned len)
+{
+	ulong addr = WgetFlashOffset + offset;
+
+	if (addr + len > WgetFlash->size) {
+		WgetFail("file too big for flash");
+		return -1;
+	}
+
+	while (addr + len > WgetErased) {
+#if defined(CONFIG_IMGCACHE)
+		imgcache_flash_write(WgetErased, CONFIG_SYS_WGET_SF_ERASE_SIZE);
+#endif
+		if (spi_flash_erase(WgetFlash, WgetErased,
+				CONFIG_SYS_WGET_SF_ERASE_SIZE)) {
+			WgetFail("flash erase failed");
+			return -1;
+		}
+		WgetErased += CONFIG_SYS_WGET_SF_ERASE_SIZE;
+	}
+
+	if (spi_flash_write(WgetFlash, addr, len, data)) {
+		WgetFail("flash write failed");
+		return -1;
+	}
+
+	return 0;
+}
+#endif
+
+static void WgetStore(uchar *data, unsigned len)
+{
+	if (len > WgetLength - WgetOffset)
+		len = WgetLength - WgetOffset;
+
+#if defined(CONFIG_CMD_SF)
+	if (WgetFlash) {
+		if (WgetStoreFlash(WgetOffset, data, len))
+			return;
+	} else
+#endif
+	memcpy((void *)(load_addr + WgetOffset), data, len);
+
+	WgetOffset += len;
+	NetBootFileXferSize = WgetOffset;
+
+	while (WgetHashes < WgetOffset / HASH_BYTES) {
+		putc('#');
+		if ((++WgetHashes % HASHES_PER_LINE) == 0)
+			puts("\n\t ");
+	}
+
+	if (WgetOffset == WgetLength)
+		WgetDone();
+}
+
+/*
+ * Return the value of header line if it is the field name, else NULL
+ */
+static char *WgetField(char *line, const char *name)
+{
+	while (*name) {
+		if (tolower(*line++) != tolower(*name++))
+			return NULL;
+	}
+	if (*line++ != ':')
+		return NULL;
+
+	return line + strspn(line, " \t");
+}
+
+/*
+ * Check the status line and pick the headers we care about
+ */
+static int WgetParseHeader(void)
+{
+	char *line = WgetHeader;
+	char *next, *val;
+	int status;
+
+	if (strncmp(line, "HTTP/1.", 7) != 0) {
+		WgetFail("not an HTTP response");
+		return -1;
+	}
+	status = simple_strtoul(line + 9, NULL, 10);
+
+	for (; line; line = next) {
+		next = strstr(line, "\r\n");
+		if (next) {
+			*next = '\0';
+			next += 2;
+		}
+
+		if (line == WgetHeader) {
+			if (status != 200) {
+				WgetFail(line);
+				return -1;
+			}
+		} else if ((val = WgetField(line, "Content-Length"))) {
+			WgetLength = simple_strtoul(val, NULL, 10);
+		} else if ((val = WgetField(line, "Transfer-Encoding")) &&
+			   strcmp(val, "identity") != 0) {
+			WgetFail("transfer encoding not supported");
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void WgetRecv(uchar *data, unsigned len)
+{
+	unsigned n;
+	char *end;
+
+	if (WgetState == WGET_BODY) {
+		WgetStore(data, len);
+		return;
+	}
+	if (WgetState != WGET_HEADER)
+		return;
+
+	n = min(len, WGET_HDR_MAX - WgetHeaderLen);
+	memcpy(WgetHeader + WgetHeaderLen, data, n);
+	WgetHeader[WgetHeaderLen + n] = '\0';
+
+	end = strstr(WgetHeader, "\r\n\r\n");
+	if (!end) {
+		WgetHeaderLen += n;
+		if (WgetHeaderLen == WGET_HDR_MAX)
+			WgetFail("response header too long");
+		return;
+	}
+
+	/* Body bytes that came in with the end of the header */
+	n = end + 4 - (WgetHeader + WgetHeaderLen);
+	end[2] = '\0';
+	if (WgetParseHeader())
+		return;
+
+	WgetState = WGET_BODY;
+	if (len > n)
+		WgetStore(data + n, len - n);
+	else if (WgetLength == 0)
+		WgetDone();
+}
+
+static void WgetEvent(int event)
+{
+	if (WgetState == WGET_DONE) {
+		if (event != TCP_EV_CONNECTED && event != TCP_EV_FIN)
+			NetState = NETLOOP_SUCCESS;
+		return;
+	}
+
+	switch (event) {
+	case TCP_EV_CONNECTED:
+		TcpSend((uchar *)WgetRequest, strlen(WgetRequest));
+		break;
+	case TCP_EV_FIN:
+	case TCP_EV_CLOSED:
+		/* Without a Content-Length the body ends with the connection */
+		if (WgetState == WGET_BODY && WgetLength == ~0UL) {
+			WgetDone();
+			if (event == TCP_EV_CLOSED)
+				NetState = NETLOOP_SUCCESS;
+		} else
+			WgetFail("connection closed early");
+		break;
+	case TCP_EV_RESET:
+		WgetFail("connection reset");
+		break;
+	case TCP_EV_TIMEOUT:
+		WgetFail("timeout");
+		break;
+	}
+}
+
+static void WgetUdpHandler(uchar *pkt, unsigned dest, unsigned src,
+			   unsigned len)
+{
+}
+
+void WgetStart(void)
+{
+	char host[24];
+	char *path = BootFile;
+	char *s;
+
+	WgetServerIP = NetServerIP;
+	s = getenv("httpport");
+	WgetServerPort = s ? simple_strtoul(s, NULL, 10) : HTTP_PORT;
+
+	/* Split off "host[:port]" */
+	if (*path && *path != '/') {
+		s = strchr(path, '/');
+		if (!s || s - path >= sizeof(host)) {
+			puts("*** ERROR: file name must be [host[:port]]/path\n");
+			NetState = NETLOOP_FAIL;
+			return;
+		}
+		memcpy(host, path, s - path);
+		host[s - path] = '\0';
+		path = s;
+
+		s = strchr(host, ':');
+		if (s) {
+			*s++ = '\0';
+			WgetServerPort = simple_strtoul(s, NULL, 10);
+		}
+		WgetServerIP = string_to_ip(host);
+	}
+
+	if (!*path) {
+		puts("*** ERROR: no file name given\n");
+		NetState = NETLOOP_FAIL;
+		return;
+	}
+	if (!WgetServerIP) {
+		puts("*** ERROR: `serverip' not set\n");
+		NetState = NETLOOP_FAIL;
+		return;
+	}
+
+	if (!WgetHeader) {
+		WgetHeader = malloc(WGET_HDR_MAX + 1 + WGET_REQ_MAX);
+		if (!WgetHeader) {
+			puts("*** ERROR: out of memory\n");
+			NetState = NETLOOP_FAIL;
+			return;
+		}
+		WgetRequest = WgetHeader + WGET_HDR_MAX + 1;
+	}
+
+#if defined(CONFIG_CMD_SF)
+	WgetFlash = NULL;
+	if (WgetFlashOffset != WGET_TO_RAM) {
+		if (WgetFlashOffset % CONFIG_SYS_WGET_SF_ERASE_SIZE) {
+			printf("*** ERROR: flash offset must be a multiple "
+				"of 0x%x\n", CONFIG_SYS_WGET_SF_ERASE_SIZE);
+			NetState = NETLOOP_FAIL;
+			return;
+		}
+		WgetFlash = spi_flash_probe(CONFIG_SPI_FLASH_BUS,
+				CONFIG_SPI_FLASH_CS, CONFIG_SF_DEFAULT_SPEED,
+				CONFIG_SF_DEFAULT_MODE);
+		if (!WgetFlash) {
+			puts("*** ERROR: SPI flash probe failed\n");
+			NetState = NETLOOP_FAIL;
+			return;
+		}
+		WgetErased = WgetFlashOffset;
+	}
+#endif
+
+	sprintf(WgetRequest,
+		"GET %s HTTP/1.1\r\n"
+		"Host: %pI4:%d\r\n"
+		"User-Agent: U-Boot\r\n"
+		"Connection: close\r\n"
+		"\r\n", path, &WgetServerIP, WgetServerPort);
+
+#if defined(CONFIG_NET_MULTI)
+	printf("Using %s device\n", eth_get_name());
+#endif
+	printf("HTTP from server %pI4:%d; our IP address is %pI4\n",
+		&WgetServerIP, WgetServerPort, &NetOurIP);
+	printf("Filename '%s'.\n", path);
+#if defined(CONFIG_CMD_SF)
+	if (WgetFlash)
+		printf("Flash offset: 0x%lx\n", WgetFlashOffset);
+	else
+#endif
+	printf("Load address: 0x%lx\n", load_addr);
+	puts("Loading: *\b");
+
+	WgetState = WGET_HEADER;
+	WgetHeaderLen = 0;
+	WgetLength = ~0UL;
+	WgetOffset = 0;
+	WgetHashes = 0;
+	WgetTime = get_timer(0);
+
+	NetSetHandler(WgetUdpHandler);
+	TcpConnect(WgetServerIP, WgetServerPort, WgetRecv, WgetEvent);
+}
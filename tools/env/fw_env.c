@@ -46,6 +46,9 @@
 
 #include <config.h>
 #include "fw_env.h"
+#ifdef CONFIG_ENV_SF_LOG
+#include <env_log.h>
+#endif
 
 #define WHITESPACE(c) ((c == '\t') || (c == ' '))
 
@@ -102,6 +105,7 @@ enum flag_scheme {
 	FLAG_NONE,
 	FLAG_BOOLEAN,
 	FLAG_INCREMENTAL,
+	FLAG_LOG,		/* CONFIG_ENV_SF_LOG records */
 };
 
 struct environment {
@@ -930,6 +934,181 @@ static int flash_flag_obsolete (int dev, int fd, off_t offset)
 	return rc;
 }
 
+#ifdef CONFIG_ENV_SF_LOG
+/*
+ * Log-structured environment, see <env_log.h> and common/env_sf.c.
+ * Offsets are relative to DEVOFFSET (dev).
+ */
+static uint32_t env_log_seq;	/* Sequence number of the last record */
+static off_t env_log_next;	/* Where the next record goes */
+static int env_log_clean;	/* env_log_next is in erased space */
+
+/*
+ * Length of the used part of the environment, up to and including
+ * the terminating double NUL
+ */
+static uint32_t env_log_data_len (void)
+{
+	uint32_t i;
+
+	for (i = 0; i + 1 < ENV_SIZE; i++) {
+		if (environment.data[i] == '\0' &&
+		    environment.data[i + 1] == '\0')
+			return i + 2;
+	}
+	return ENV_SIZE;
+}
+
+/*
+ * Same scan as env_log_load() in U-Boot: take the record with the
+ * highest sequence number and a valid data CRC, and find the append
+ * point after the last record of the newest sector. Without a record
+ * the environment read in the original format is left as it is, and
+ * is converted by the next write.
+ */
+static int env_log_read (int dev, int fd)
+{
+	struct env_log_hdr *h, *best = NULL;
+	uint8_t *buf;
+	size_t start, end, off;
+	uint32_t last;
+	int s, clean, any;
+
+	buf = malloc (CONFIG_ENV_SF_LOG_SIZE);
+	if (!buf) {
+		fprintf (stderr, "Cannot malloc %u bytes: %s\n",
+			 CONFIG_ENV_SF_LOG_SIZE, strerror (errno));
+		return -1;
+	}
+	if (flash_read_buf (dev, fd, buf, CONFIG_ENV_SF_LOG_SIZE,
+			    DEVOFFSET (dev), DEVTYPE (dev)) !=
+	    CONFIG_ENV_SF_LOG_SIZE) {
+		free (buf);
+		return -1;
+	}
+
+	env_log_seq = 0;
+	env_log_next = 0;
+	env_log_clean = 0;
+
+	for (s = 0; s < ENV_LOG_SECTORS; s++) {
+		start = s * CONFIG_ENV_SECT_SIZE;
+		end = start + CONFIG_ENV_SECT_SIZE;
+		last = 0;
+		clean = 0;
+		any = 0;
+
+		for (off = start; off + sizeof (*h) <= end; ) {
+			h = (struct env_log_hdr *)(buf + off);
+			if (h->magic == 0xffffffff) {
+				clean = 1;
+				break;
+			}
+			/* A header cut short by a power failure */
+			if (h->magic != ENV_LOG_MAGIC ||
+			    h->hcrc != ENV_LOG_HCRC (h) ||
+			    h->len > ENV_SIZE ||
+			    off + ENV_LOG_REC_LEN (h->len) > end) {
+				off += ENV_LOG_ALIGN;
+				continue;
+			}
+
+			if ((!best || h->seq > best->seq) &&
+			    crc32 (0, (uint8_t *)(h + 1), h->len) == h->dcrc)
+				best = h;
+			last = h->seq;
+			any = 1;
+			off += ENV_LOG_REC_LEN (h->len);
+		}
+
+		if (any && last >= env_log_seq) {
+			env_log_seq = last;
+			env_log_next = off;
+			env_log_clean = clean;
+		}
+	}
+
+	if (best) {
+		memcpy (environment.data, best + 1, best->len);
+		memset (environment.data + best->len, 0,
+			ENV_SIZE - best->len);
+		*environment.crc = crc32 (0, (uint8_t *) environment.data,
+					  ENV_SIZE);
+	}
+	environment.flag_scheme = FLAG_LOG;
+
+	free (buf);
+	return 0;
+}
+
+/*
+ * Append the environment as a record, as saveenv() in U-Boot does
+ */
+static int env_log_write (int dev, int fd)
+{
+	struct env_log_hdr h;
+	struct erase_info_user erase;
+	off_t sector, end, offset;
+	int new_sector = 0;
+	int rc = 0;
+
+	h.magic = ENV_LOG_MAGIC;
+	h.seq = env_log_seq + 1;
+	h.len = env_log_data_len ();
+	h.dcrc = crc32 (0, (uint8_t *) environment.data, h.len);
+	h.hcrc = ENV_LOG_HCRC (&h);
+
+	if (ENV_LOG_REC_LEN (h.len) > CONFIG_ENV_SECT_SIZE) {
+		fprintf (stderr, "Environment too large for the log\n");
+		return -1;
+	}
+
+	sector = env_log_next / CONFIG_ENV_SECT_SIZE;
+	end = (sector + 1) * CONFIG_ENV_SECT_SIZE;
+
+	if (!env_log_clean || env_log_next + ENV_LOG_REC_LEN (h.len) > end) {
+		if (env_log_clean || env_log_next != 0 || env_log_seq != 0)
+			sector = (sector + 1) % ENV_LOG_SECTORS;
+		env_log_next = sector * CONFIG_ENV_SECT_SIZE;
+		new_sector = 1;
+	}
+
+	erase.start = DEVOFFSET (dev) + sector * CONFIG_ENV_SECT_SIZE;
+	erase.length = CONFIG_ENV_SECT_SIZE;
+	ioctl (fd, MEMUNLOCK, &erase);
+
+	/* Dataflash does not need an explicit erase cycle */
+	if (new_sector && DEVTYPE (dev) != MTD_DATAFLASH &&
+	    ioctl (fd, MEMERASE, &erase) != 0) {
+		fprintf (stderr, "MTD erase error on %s: %s\n",
+			 DEVNAME (dev), strerror (errno));
+		rc = -1;
+		goto out;
+	}
+
+#ifdef DEBUG
+	printf ("Writing log record %u at 0x%llx\n", h.seq,
+		(unsigned long long) (DEVOFFSET (dev) + env_log_next));
+#endif
+	/*
+	 * Header first: a record cut short then fails its data CRC, and
+	 * U-Boot does not reuse its space
+	 */
+	offset = DEVOFFSET (dev) + env_log_next;
+	if (pwrite (fd, &h, sizeof (h), offset) != sizeof (h) ||
+	    pwrite (fd, environment.data, h.len, offset + sizeof (h)) !=
+	    h.len) {
+		fprintf (stderr, "Write error on %s: %s\n",
+			 DEVNAME (dev), strerror (errno));
+		rc = -1;
+	}
+
+out:
+	ioctl (fd, MEMLOCK, &erase);
+	return rc;
+}
+#endif /* CONFIG_ENV_SF_LOG */
+
 static int flash_write (int fd_current, int fd_target, int dev_target)
 {
 	int rc;
@@ -937,6 +1116,10 @@ static int flash_write (int fd_current, int fd_target, int dev_target)
 	switch (environment.flag_scheme) {
 	case FLAG_NONE:
 		break;
+#ifdef CONFIG_ENV_SF_LOG
+	case FLAG_LOG:
+		return env_log_write (dev_target, fd_target);
+#endif
 	case FLAG_INCREMENTAL:
 		(*environment.flags)++;
 		break;
@@ -995,8 +1178,14 @@ static int flash_read (int fd)
 
 	rc = flash_read_buf (dev_current, fd, environment.image, CONFIG_ENV_SIZE,
 			     DEVOFFSET (dev_current), mtdinfo.type);
+	if (rc != CONFIG_ENV_SIZE)
+		return -1;
 
-	return (rc != CONFIG_ENV_SIZE) ? -1 : 0;
+#ifdef CONFIG_ENV_SF_LOG
+	if (!HaveRedundEnv)
+		return env_log_read (dev_current, fd);
+#endif
+	return 0;
 }
 
 static int flash_io (int mode)
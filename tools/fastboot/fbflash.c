@@ -0,0 +1,429 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * fbflash - host side of the U-Boot "fastboot" UDP flashing service.
+ *
+ *   fbflash [-p port] [-t seconds] board command...
+ *
+ * with the commands run in turn:
+ *
+ *   getvar <name>		print a variable
+ *   erase <part>		erase a partition
+ *   flash <part> <file>	stream a file into a partition and check
+ *				its CRC32 read back from flash
+ *   crc32 <part> <size>	print the CRC32 of a partition's start
+ *   reboot | continue	end the session
+ *
+ * e.g. "fbflash 10.0.0.2 flash normal horus.uImage reboot". The board
+ * is looked for for -t seconds (default 30), so this can be started
+ * before the board is powered up. The protocol is in include/fastboot.h.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fastboot.h>
+
+#define RETRY_MS	500		/* Command retransmission	*/
+#define COMMAND_MS	120000		/* Longest command (erase)	*/
+#define DATA_MS		200		/* DATA retransmission		*/
+#define DATA_TRIES	50		/* 10 s, more than a block write */
+
+extern unsigned long crc32(unsigned long, const unsigned char *, unsigned);
+
+static int sock;
+static uint16_t seq;
+static int packet_max = FB_PACKET_MAX;
+
+static uint64_t now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: fbflash [-p port] [-t seconds] board command...\n"
+		"  getvar <name> | erase <part> | flash <part> <file> |\n"
+		"  crc32 <part> <size> | reboot | continue\n");
+	exit(1);
+}
+
+/*
+ * Wait up to ms for a packet; returns its length, or 0 on timeout
+ */
+static int receive(uint8_t *buf, int size, int ms)
+{
+	struct pollfd pfd = { sock, POLLIN, 0 };
+	int len;
+
+	if (poll(&pfd, 1, ms) <= 0)
+		return 0;
+
+	len = recv(sock, buf, size, 0);
+	return len < 0 ? 0 : len;
+}
+
+static void put_hdr(uint8_t *buf, int id, uint16_t s)
+{
+	struct fb_hdr h;
+
+	h.id = id;
+	h.flags = 0;
+	h.seq = htons(s);
+	memcpy(buf, &h, sizeof(h));
+}
+
+/*
+ * Send a QUERY, INIT or FASTBOOT packet with the next sequence number
+ * until its answer arrives. Returns the answer length, or -1.
+ */
+static int transact(int id, const void *data, int len, uint8_t *ans,
+		    int timeout)
+{
+	uint8_t buf[FB_PACKET_MAX];
+	uint64_t start = now_ms();
+	struct fb_hdr h;
+	int n;
+
+	put_hdr(buf, id, seq);
+	memcpy(buf + sizeof(h), data, len);
+
+	while (now_ms() - start < (uint64_t)timeout) {
+		send(sock, buf, sizeof(h) + len, 0);
+
+		while ((n = receive(ans, FB_PACKET_MAX, RETRY_MS)) > 0) {
+			if (n < (int)sizeof(h))
+				continue;
+			memcpy(&h, ans, sizeof(h));
+			if (h.id == FB_ERROR) {
+				fprintf(stderr, "error: %.*s\n",
+					n - (int)sizeof(h), ans + sizeof(h));
+				return -1;
+			}
+			if (h.id == id && (id == FB_QUERY ||
+					   ntohs(h.seq) == seq)) {
+				if (id != FB_QUERY)
+					seq++;
+				return n;
+			}
+		}
+	}
+
+	fprintf(stderr, "no answer from board\n");
+	return -1;
+}
+
+static int connect_board(int timeout)
+{
+	uint8_t ans[FB_PACKET_MAX];
+	struct fb_init init;
+	int n;
+
+	n = transact(FB_QUERY, NULL, 0, ans, timeout);
+	if (n < (int)sizeof(struct fb_hdr) + 2)
+		return -1;
+	seq = (ans[4] << 8) | ans[5];
+
+	init.version = htons(FASTBOOT_VERSION);
+	init.packet_max = htons(FB_PACKET_MAX);
+	n = transact(FB_INIT, &init.version, 4, ans, RETRY_MS * 4);
+	if (n < (int)sizeof(init))
+		return -1;
+	memcpy(&init, ans, sizeof(init));
+	if (ntohs(init.packet_max) < packet_max)
+		packet_max = ntohs(init.packet_max);
+
+	return 0;
+}
+
+/*
+ * Run a text command. The answer, less "OKAY" or "DATA", goes to resp.
+ */
+static int command(const char *cmd, char *resp)
+{
+	uint8_t ans[FB_PACKET_MAX];
+	int n;
+
+	n = transact(FB_FASTBOOT, cmd, strlen(cmd), ans, COMMAND_MS);
+	if (n < 0)
+		return -1;
+
+	n -= sizeof(struct fb_hdr);
+	if (n > FB_RESPONSE_MAX)
+		n = FB_RESPONSE_MAX;
+	memcpy(resp, ans + sizeof(struct fb_hdr), n);
+	resp[n] = '\0';
+
+	if (strncmp(resp, "OKAY", 4) && strncmp(resp, "DATA", 4)) {
+		fprintf(stderr, "%s: %s\n", cmd,
+			strncmp(resp, "FAIL", 4) ? resp : resp + 4);
+		return -1;
+	}
+
+	memmove(resp, resp + 4, n - 3);
+	return 0;
+}
+
+static int send_data(uint32_t off, const uint8_t *data, int len)
+{
+	uint8_t buf[FB_PACKET_MAX];
+	uint32_t o = htonl(off);
+
+	put_hdr(buf, FB_DATA, 0);
+	memcpy(buf + sizeof(struct fb_hdr), &o, sizeof(o));
+	memcpy(buf + sizeof(struct fb_data), data, len);
+	return send(sock, buf, sizeof(struct fb_data) + len, 0);
+}
+
+/*
+ * Stream the image, going back to the acknowledged offset when the
+ * board asks for it or on a timeout
+ */
+static int stream(const uint8_t *img, uint32_t size)
+{
+	uint8_t ans[FB_PACKET_MAX];
+	uint32_t acked = 0, limit = 0, next = 0, back = ~0;
+	int chunk = packet_max - sizeof(struct fb_data);
+	int tries = 0;
+	struct fb_ack a;
+	int n;
+
+	while (acked < size) {
+		while (next < limit) {
+			n = limit - next < (uint32_t)chunk ?
+				(int)(limit - next) : chunk;
+			send_data(next, img + next, n);
+			next += n;
+		}
+
+		n = receive(ans, sizeof(ans), DATA_MS);
+		if (n == 0) {
+			if (++tries > DATA_TRIES) {
+				fprintf(stderr, "\ndata timeout\n");
+				return -1;
+			}
+			if (next > acked)
+				next = acked;
+			else
+				send_data(acked, NULL, 0);
+			continue;
+		}
+
+		if (ans[0] == FB_ERROR) {
+			fprintf(stderr, "\nerror: %.*s\n",
+				n - (int)sizeof(struct fb_hdr),
+				ans + sizeof(struct fb_hdr));
+			return -1;
+		}
+		if (ans[0] != FB_ACK || n < (int)sizeof(a))
+			continue;
+
+		memcpy(&a, ans, sizeof(a));
+		a.acked = ntohl(a.acked);
+		a.limit = ntohl(a.limit);
+
+		if (a.acked > acked || a.limit > limit) {
+			if (a.acked / 0x10000 != acked / 0x10000) {
+				putchar('#');
+				fflush(stdout);
+			}
+			acked = a.acked;
+			limit = a.limit;
+			if (next < acked)
+				next = acked;
+			tries = 0;
+		}
+		if ((a.h.flags & FB_ACK_RESEND) && back != acked) {
+			/* Lost data: go back, once per hole */
+			next = acked;
+			back = acked;
+		}
+	}
+
+	return 0;
+}
+
+static uint8_t *read_file(const char *name, uint32_t *size)
+{
+	struct stat st;
+	uint8_t *buf;
+	FILE *f;
+
+	f = fopen(name, "rb");
+	if (!f || fstat(fileno(f), &st) < 0) {
+		perror(name);
+		return NULL;
+	}
+
+	buf = malloc(st.st_size ? st.st_size : 1);
+	if (!buf || fread(buf, 1, st.st_size, f) != (size_t)st.st_size) {
+		perror(name);
+		fclose(f);
+		return NULL;
+	}
+
+	fclose(f);
+	*size = st.st_size;
+	return buf;
+}
+
+static int do_flash(const char *part, const char *file)
+{
+	char cmd[FB_RESPONSE_MAX], resp[FB_RESPONSE_MAX + 1];
+	uint64_t start;
+	uint32_t size, crc;
+	uint8_t *img;
+	int ret = -1;
+
+	img = read_file(file, &size);
+	if (!img)
+		return -1;
+	if (size == 0) {
+		fprintf(stderr, "%s: empty file\n", file);
+		goto out;
+	}
+
+	printf("flash %s: %u bytes\n", part, size);
+	start = now_ms();
+
+	snprintf(cmd, sizeof(cmd), "flash:%s:%08x", part, size);
+	if (command(cmd, resp) || stream(img, size))
+		goto out;
+	printf("\n");
+
+	crc = crc32(0, img, size);
+	snprintf(cmd, sizeof(cmd), "crc32:%s:%08x", part, size);
+	if (command(cmd, resp))
+		goto out;
+
+	if (strtoul(resp, NULL, 16) != crc) {
+		fprintf(stderr, "flash %s: CRC32 mismatch, board 0x%s, "
+			"file 0x%08x\n", part, resp, crc);
+		goto out;
+	}
+
+	printf("flash %s: done in %.1f s, CRC32 0x%08x verified\n", part,
+		(now_ms() - start) / 1000.0, crc);
+	ret = 0;
+out:
+	free(img);
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	char cmd[FB_RESPONSE_MAX], resp[FB_RESPONSE_MAX + 1];
+	struct sockaddr_in to;
+	struct hostent *he;
+	int port = FASTBOOT_PORT;
+	int timeout = 30;
+	int c, i;
+
+	while ((c = getopt(argc, argv, "p:t:")) != -1) {
+		switch (c) {
+		case 'p':
+			port = atoi(optarg);
+			break;
+		case 't':
+			timeout = atoi(optarg);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	if (argc < 2)
+		usage();
+
+	he = gethostbyname(argv[0]);
+	if (!he) {
+		fprintf(stderr, "Unknown host %s\n", argv[0]);
+		return 1;
+	}
+	memset(&to, 0, sizeof(to));
+	to.sin_family = AF_INET;
+	memcpy(&to.sin_addr, he->h_addr, sizeof(to.sin_addr));
+	to.sin_port = htons(port);
+
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0 || connect(sock, (struct sockaddr *)&to,
+				sizeof(to)) < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	if (connect_board(timeout * 1000))
+		return 1;
+
+	for (i = 1; i < argc; i++) {
+		const char *op = argv[i];
+
+		if (strcmp(op, "flash") == 0 && i + 2 < argc) {
+			if (do_flash(argv[i + 1], argv[i + 2]))
+				return 1;
+			i += 2;
+			continue;
+		}
+
+		if (strcmp(op, "crc32") == 0 && i + 2 < argc) {
+			snprintf(cmd, sizeof(cmd), "crc32:%s:%08lx",
+				argv[i + 1], strtoul(argv[i + 2], NULL, 0));
+			i += 2;
+		} else if ((strcmp(op, "getvar") == 0 ||
+			    strcmp(op, "erase") == 0) && i + 1 < argc) {
+			snprintf(cmd, sizeof(cmd), "%s:%s", op, argv[i + 1]);
+			i++;
+		} else if (strcmp(op, "reboot") == 0 ||
+			   strcmp(op, "continue") == 0) {
+			snprintf(cmd, sizeof(cmd), "%s", op);
+		} else {
+			usage();
+		}
+
+		if (command(cmd, resp))
+			return 1;
+		if (*resp)
+			printf("%s\n", resp);
+	}
+
+	return 0;
+}
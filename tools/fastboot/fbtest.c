@@ -0,0 +1,444 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * fbtest - run net/fastboot.c on the host and flash it with fbflash.
+ *
+ *   fbtest [-l loss%] [-w ms] [-s bytes] [-r seed] [fbflash]
+ *
+ * The board side is the unmodified net/fastboot.c, serving a UDP socket
+ * on the loopback interface with a flash in RAM. Each block erase takes
+ * -w ms (default 200), and like on the board, frames arriving meanwhile
+ * find a receive ring of PKTBUFSRX entries, the rest are dropped. -l
+ * drops that percentage of the packets both ways, at random.
+ *
+ * fbflash (by default the one next to fbtest) is then run to flash a
+ * random image of -s bytes (default 300000) into "normal", erase
+ * "backup" and leave the service. The test passes if fbflash succeeds,
+ * the flash holds what was sent, and the A/B slot record was reset for
+ * both partitions.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+#include "include/common.h"
+#include "include/command.h"
+#include "include/net.h"
+#include "include/spi_flash.h"
+#include "include/slot.h"
+#include <fastboot.h>
+
+#define PKTBUFSRX	2		/* m2s-volkh RX ring		*/
+#define PKT_MAX		1536
+#define TEST_LIMIT	120		/* Seconds			*/
+
+#define NORMAL_OFFSET	0x100000
+#define BACKUP_OFFSET	0x020000
+#define BACKUP_SIZE	0x0e0000
+
+extern void FastbootStart(void);
+extern ulong FastbootWait;
+
+static unsigned loss;			/* Per 100			*/
+static unsigned erase_ms = 200;
+static size_t image_size = 300000;
+
+static int sock;
+static uchar flash[FBTEST_FLASH_SIZE];
+static int flash_busy;			/* An erase ran since the last frame */
+static ulong written[4];		/* slot_written() calls		*/
+static int nwritten;
+static unsigned dropped, lost;
+
+static uchar tx_buf[PKT_MAX];
+static uchar rx_buf[PKT_MAX];
+volatile uchar *NetTxPacket = tx_buf;
+volatile uchar *NetRxPacket = rx_buf;
+IPaddr_t NetOurIP;
+int NetState;
+
+static rxhand_f *handler;
+static thand_f *timeout_handler;
+static ulong timeout_at;
+
+/* ------------------------------------------------------------------------- */
+
+static uint64_t now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t start_ms;
+
+ulong get_timer(ulong base)
+{
+	return (ulong)(now_ms() - start_ms) - base;
+}
+
+char *getenv(const char *name)
+{
+	return NULL;
+}
+
+int do_reset(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[])
+{
+	fprintf(stderr, "fbtest: unexpected reset\n");
+	exit(1);
+}
+
+void slot_written(ulong offset)
+{
+	if (nwritten < ARRAY_SIZE(written))
+		written[nwritten++] = offset;
+}
+
+/* ------------------------------------------------------------------------- */
+
+struct spi_flash *spi_flash_probe(unsigned int bus, unsigned int cs,
+		unsigned int max_hz, unsigned int spi_mode)
+{
+	return (struct spi_flash *)flash;
+}
+
+static int flash_range(u32 offset, size_t len)
+{
+	return offset <= sizeof(flash) && len <= sizeof(flash) - offset;
+}
+
+int spi_flash_read(struct spi_flash *f, u32 offset, size_t len, void *buf)
+{
+	if (!flash_range(offset, len))
+		return -1;
+	memcpy(buf, flash + offset, len);
+	return 0;
+}
+
+/* Like NOR flash, a write can only clear bits */
+int spi_flash_write(struct spi_flash *f, u32 offset, size_t len,
+		const void *buf)
+{
+	const uchar *p = buf;
+	size_t i;
+
+	if (!flash_range(offset, len))
+		return -1;
+	for (i = 0; i < len; i++)
+		flash[offset + i] &= p[i];
+	return 0;
+}
+
+int spi_flash_erase(struct spi_flash *f, u32 offset, size_t len)
+{
+	if (!flash_range(offset, len) || offset % 0x10000 || len % 0x10000)
+		return -1;
+	memset(flash + offset, 0xff, len);
+	usleep(erase_ms * (len / 0x10000) * 1000);
+	flash_busy = 1;
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+int NetEthHdrSize(void)
+{
+	return sizeof(Ethernet_t);
+}
+
+void NetSetTimeout(ulong iv, thand_f *f)
+{
+	timeout_handler = iv ? f : NULL;
+	timeout_at = get_timer(0) + iv;
+}
+
+void NetSetHandler(rxhand_f *f)
+{
+	handler = f;
+}
+
+int NetSendUDPPacket(uchar *ether, IPaddr_t dest, int dport, int sport,
+		int len)
+{
+	struct sockaddr_in sin;
+
+	if (rand() % 100 < loss) {
+		lost++;
+		return 0;
+	}
+
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = dest;
+	sin.sin_port = htons(dport);
+	sendto(sock, (uchar *)NetTxPacket + NetEthHdrSize() + IP_HDR_SIZE,
+		len, 0, (struct sockaddr *)&sin, sizeof(sin));
+	return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+struct frame {
+	struct sockaddr_in	from;
+	int			len;
+	uchar			data[PKT_MAX];
+};
+
+/* Pass a datagram to the handler as a received frame */
+static void deliver(struct frame *f)
+{
+	Ethernet_t *et = (Ethernet_t *)rx_buf;
+	IP_t *ip = (IP_t *)(rx_buf + sizeof(*et));
+	uchar *pkt = rx_buf + sizeof(*et) + IP_HDR_SIZE;
+
+	if (f->len > sizeof(rx_buf) - (pkt - rx_buf))
+		return;
+	memset(et->et_src, 0x02, sizeof(et->et_src));
+	memcpy(&ip->ip_src, &f->from.sin_addr.s_addr, sizeof(ip->ip_src));
+	memcpy(pkt, f->data, f->len);
+	handler(pkt, FASTBOOT_PORT, ntohs(f->from.sin_port), f->len);
+}
+
+static int receive(struct frame *f, int flags)
+{
+	socklen_t alen = sizeof(f->from);
+
+	f->len = recvfrom(sock, f->data, sizeof(f->data), flags,
+			(struct sockaddr *)&f->from, &alen);
+	return f->len;
+}
+
+/*
+ * The net loop: frames and timeouts until NetState leaves
+ * NETLOOP_CONTINUE
+ */
+static void net_loop(void)
+{
+	static struct frame ring[PKTBUFSRX], extra;
+	struct pollfd pfd = { .fd = sock, .events = POLLIN };
+	int queued = 0, wait;
+
+	NetState = NETLOOP_CONTINUE;
+	FastbootStart();
+
+	while (NetState == NETLOOP_CONTINUE) {
+		if (timeout_handler && get_timer(0) >= timeout_at) {
+			thand_f *f = timeout_handler;
+
+			timeout_handler = NULL;
+			f();
+			continue;
+		}
+
+		if (!queued) {
+			wait = timeout_handler ?
+				(int)(timeout_at - get_timer(0)) : 100;
+			if (poll(&pfd, 1, wait < 0 ? 0 : wait) <= 0)
+				continue;
+			if (receive(&ring[0], 0) < 0)
+				continue;
+			queued = 1;
+		}
+
+		/* Frames are lost at random, or dropped at a full ring */
+		flash_busy = 0;
+		if (rand() % 100 < loss)
+			lost++;
+		else
+			deliver(&ring[0]);
+
+		queued--;
+		memmove(&ring[0], &ring[1], queued * sizeof(ring[0]));
+		if (!flash_busy)
+			continue;
+
+		/* What came in during the erase: the ring fills, then drops */
+		while (receive(&extra, MSG_DONTWAIT) >= 0) {
+			if (queued < PKTBUFSRX)
+				ring[queued++] = extra;
+			else
+				dropped++;
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int check(const uchar *image)
+{
+	int fail = 0, i;
+
+	if (memcmp(flash + NORMAL_OFFSET, image, image_size)) {
+		puts("FAIL: normal does not hold the image\n");
+		fail = 1;
+	}
+	for (i = 0; i < BACKUP_SIZE; i++) {
+		if (flash[BACKUP_OFFSET + i] != 0xff) {
+			puts("FAIL: backup is not erased\n");
+			fail = 1;
+			break;
+		}
+	}
+	if (nwritten != 2 || written[0] != NORMAL_OFFSET ||
+	    written[1] != BACKUP_OFFSET) {
+		printf("FAIL: slot_written() called %d times\n", nwritten);
+		fail = 1;
+	}
+	return fail;
+}
+
+static void timeout(int sig)
+{
+	static const char msg[] = "FAIL: test timed out\n";
+
+	if (write(2, msg, sizeof(msg) - 1) < 0)
+		_exit(2);
+	_exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+	char tool[1024], image_name[] = "/tmp/fbtestXXXXXX", port[8];
+	struct sockaddr_in sin;
+	socklen_t alen = sizeof(sin);
+	unsigned seed = time(NULL);
+	uchar *image;
+	pid_t pid;
+	size_t i;
+	int c, fd, status;
+
+	while ((c = getopt(argc, argv, "l:w:s:r:")) != -1) {
+		switch (c) {
+		case 'l':
+			loss = atoi(optarg);
+			break;
+		case 'w':
+			erase_ms = atoi(optarg);
+			break;
+		case 's':
+			image_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			seed = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [-l loss%%] [-w ms] "
+				"[-s bytes] [-r seed] [fbflash]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (optind < argc) {
+		snprintf(tool, sizeof(tool), "%s", argv[optind]);
+	} else {
+		snprintf(tool, sizeof(tool), "%s", argv[0]);
+		if (strrchr(tool, '/'))
+			strcpy(strrchr(tool, '/') + 1, "fbflash");
+		else
+			strcpy(tool, "./fbflash");
+	}
+	if (image_size == 0 || image_size > 0x100000) {
+		fprintf(stderr, "Image size must be 1 to 0x100000 bytes\n");
+		return 1;
+	}
+	srand(seed);
+	printf("fbtest: %zu bytes, %u%% loss, %u ms erase, seed %u\n",
+		image_size, loss, erase_ms, seed);
+
+	/* An old image in both partitions */
+	memset(flash, 0xa5, sizeof(flash));
+
+	image = malloc(image_size);
+	fd = mkstemp(image_name);
+	if (!image || fd < 0) {
+		perror("fbtest");
+		return 1;
+	}
+	for (i = 0; i < image_size; i++)
+		image[i] = rand();
+	if (write(fd, image, image_size) != image_size) {
+		perror("fbtest");
+		return 1;
+	}
+	close(fd);
+
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&sin, 0, sizeof(sin));
+	sin.sin_family = AF_INET;
+	sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (sock < 0 || bind(sock, (struct sockaddr *)&sin, sizeof(sin)) ||
+	    getsockname(sock, (struct sockaddr *)&sin, &alen)) {
+		perror("fbtest");
+		return 1;
+	}
+	snprintf(port, sizeof(port), "%d", ntohs(sin.sin_port));
+	NetOurIP = sin.sin_addr.s_addr;
+
+	fflush(stdout);
+	pid = fork();
+	if (pid == 0) {
+		execl(tool, tool, "-p", port, "-t", "5", "127.0.0.1",
+			"flash", "normal", image_name, "erase", "backup",
+			"continue", (char *)NULL);
+		fprintf(stderr, "Can't run %s: %s\n", tool, strerror(errno));
+		_exit(127);
+	}
+
+	signal(SIGALRM, timeout);
+	alarm(TEST_LIMIT);
+	start_ms = now_ms();
+	FastbootWait = 10;
+	net_loop();
+	alarm(0);
+
+	waitpid(pid, &status, 0);
+	unlink(image_name);
+	printf("\nfbtest: %lu ms, %u packets lost, %u dropped at the ring\n",
+		get_timer(0), lost, dropped);
+
+	if (NetState != NETLOOP_SUCCESS) {
+		puts("FAIL: the service did not end with \"continue\"\n");
+		return 1;
+	}
+	if (!WIFEXITED(status) || WEXITSTATUS(status)) {
+		puts("FAIL: fbflash failed\n");
+		return 1;
+	}
+	if (check(image))
+		return 1;
+
+	puts("PASS\n");
+	return 0;
+}
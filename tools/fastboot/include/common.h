@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <common.h>: just what net/fastboot.c uses, and the
+ * board configuration it is built with. Time, flash and the network
+ * come from fbtest.c.
+ */
+#ifndef __FBTEST_COMMON_H__
+#define __FBTEST_COMMON_H__
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+typedef unsigned char	uchar;
+typedef unsigned short	ushort;
+typedef unsigned int	uint;
+typedef unsigned long	ulong;
+typedef uint32_t	u32;
+
+/* A smaller flash than m2s-volkh's, with the same kind of partitions */
+#define CONFIG_SPI_FLASH_BUS		0
+#define CONFIG_SPI_FLASH_CS		0
+#define CONFIG_SYS_FASTBOOT_PARTS	{				\
+	{ "normal", 0x100000, 0x100000 },				\
+	{ "backup", 0x020000, 0x0e0000 } }
+#define FBTEST_FLASH_SIZE		0x200000
+
+#define min(x, y)	((x) < (y) ? (x) : (y))
+#define ARRAY_SIZE(x)	(sizeof(x) / sizeof((x)[0]))
+
+#define simple_strtoul	strtoul
+
+#undef putc
+#define putc(c)		putchar(c)
+#define puts(s)		fputs(s, stdout)
+
+extern ulong	get_timer(ulong base);
+extern unsigned long crc32(unsigned long, const unsigned char *, unsigned);
+#define getenv		fbtest_getenv
+extern char	*getenv(const char *name);
+
+#endif /* __FBTEST_COMMON_H__ */
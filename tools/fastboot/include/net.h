@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <net.h>: the headers of a received frame and the
+ * few net.c services net/fastboot.c relies on, provided by fbtest.c.
+ */
+#ifndef __FBTEST_NET_H__
+#define __FBTEST_NET_H__
+
+typedef u32		IPaddr_t;
+typedef void		thand_f(void);
+typedef void		rxhand_f(uchar *, unsigned, unsigned, unsigned);
+
+typedef struct {
+	uchar		et_dest[6];	/* Destination node		*/
+	uchar		et_src[6];	/* Source node			*/
+	ushort		et_protlen;	/* Protocol or length		*/
+} Ethernet_t;
+
+typedef struct {
+	uchar		ip_hl_v;	/* header length and version	*/
+	uchar		ip_tos;		/* type of service		*/
+	ushort		ip_len;		/* total length			*/
+	ushort		ip_id;		/* identification		*/
+	ushort		ip_off;		/* fragment offset field	*/
+	uchar		ip_ttl;		/* time to live			*/
+	uchar		ip_p;		/* protocol			*/
+	ushort		ip_sum;		/* checksum			*/
+	IPaddr_t	ip_src;		/* Source IP address		*/
+	IPaddr_t	ip_dst;		/* Destination IP address	*/
+	ushort		udp_src;	/* UDP source port		*/
+	ushort		udp_dst;	/* UDP destination port		*/
+	ushort		udp_len;	/* Length of UDP packet		*/
+	ushort		udp_xsum;	/* Checksum			*/
+} IP_t;
+
+#define IP_HDR_SIZE	(sizeof (IP_t))
+
+#define NETLOOP_CONTINUE	1
+#define NETLOOP_RESTART		2
+#define NETLOOP_SUCCESS		3
+#define NETLOOP_FAIL		4
+
+extern volatile uchar	*NetTxPacket;
+extern volatile uchar	*NetRxPacket;
+extern IPaddr_t		NetOurIP;
+extern int		NetState;
+
+extern int	NetEthHdrSize(void);
+extern void	NetSetTimeout(ulong, thand_f *);
+extern void	NetSetHandler(rxhand_f *);
+extern int	NetSendUDPPacket(uchar *ether, IPaddr_t dest, int dport,
+				 int sport, int len);
+
+static inline IPaddr_t NetReadIP(volatile void *from)
+{
+	IPaddr_t ip;
+	memcpy((void*)&ip, (void*)from, sizeof(ip));
+	return ip;
+}
+
+#endif /* __FBTEST_NET_H__ */
@@ -0,0 +1,43 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <spi_flash.h>: a flash in RAM, see fbtest.c
+ */
+#ifndef __FBTEST_SPI_FLASH_H__
+#define __FBTEST_SPI_FLASH_H__
+
+#define SPI_MODE_3	3
+
+struct spi_flash;
+
+extern struct spi_flash *spi_flash_probe(unsigned int bus, unsigned int cs,
+		unsigned int max_hz, unsigned int spi_mode);
+extern int spi_flash_read(struct spi_flash *flash, u32 offset,
+		size_t len, void *buf);
+extern int spi_flash_write(struct spi_flash *flash, u32 offset,
+		size_t len, const void *buf);
+extern int spi_flash_erase(struct spi_flash *flash, u32 offset,
+		size_t len);
+
+#endif /* __FBTEST_SPI_FLASH_H__ */
@@ -0,0 +1,42 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <command.h>: U_BOOT_CMD() only keeps the handler,
+ * so that mallinfotest.c can run the command
+ */
+#ifndef __MALLINFOTEST_COMMAND_H__
+#define __MALLINFOTEST_COMMAND_H__
+
+typedef struct cmd_tbl_s cmd_tbl_t;
+
+struct cmd_tbl_s {
+	int	(*cmd)(cmd_tbl_t *cmdtp, int flag, int argc, char *argv[]);
+};
+
+#define cmd_usage(cmdtp)	puts("usage\n")
+
+#define U_BOOT_CMD(name, maxargs, rep, cmd, usage, help) \
+	cmd_tbl_t __u_boot_cmd_##name = { cmd }
+
+#endif /* __MALLINFOTEST_COMMAND_H__ */
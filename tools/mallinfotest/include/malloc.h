@@ -0,0 +1,66 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <malloc.h> with CONFIG_SYS_MALLOC_STATS: the dl*
+ * allocator underneath is a model in mallinfotest.c. The public names
+ * are mapped to mi_*, after the host headers came in through <common.h>,
+ * so the host C library keeps its own malloc().
+ */
+#ifndef __MALLINFOTEST_MALLOC_H__
+#define __MALLINFOTEST_MALLOC_H__
+
+#define malloc		mi_malloc
+#define free		mi_free
+#define realloc		mi_realloc
+#define memalign	mi_memalign
+#define calloc		mi_calloc
+
+extern ulong mem_malloc_start;
+extern ulong mem_malloc_end;
+
+void *dlmalloc(size_t bytes);
+void dlfree(void *mem);
+void *dlrealloc(void *oldmem, size_t bytes);
+void *dlmemalign(size_t alignment, size_t bytes);
+void *dlcalloc(size_t n, size_t elem_size);
+size_t malloc_usable_size(void *mem);
+
+void *malloc(size_t bytes);
+void free(void *mem);
+void *realloc(void *oldmem, size_t bytes);
+void *memalign(size_t alignment, size_t bytes);
+void *calloc(size_t n, size_t elem_size);
+
+struct malloc_arena_info {
+	ulong	arena;
+	ulong	max_arena;
+	ulong	topsize;
+	ulong	free;
+	ulong	free_chunks;
+	ulong	largest;
+};
+
+void malloc_arena_info(struct malloc_arena_info *ai);
+
+#endif /* __MALLINFOTEST_MALLOC_H__ */
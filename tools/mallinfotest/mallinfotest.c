@@ -0,0 +1,249 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * mallinfotest - run the malloc() instrumentation of common/cmd_mallinfo.c
+ * on the host, over a model of the dl* allocator.
+ *
+ *   mallinfotest
+ *
+ * It checks that:
+ *
+ * - with more blocks live than the table of live blocks holds, freeing
+ *   one that is not in the table returns, and the totals come back to
+ *   zero once everything is freed;
+ * - realloc(p, 0) does what dlrealloc() does, which here (no
+ *   REALLOC_ZERO_BYTES_FREES) is returning a minimum size block;
+ * - a failed realloc() counts one call and one failure, and the old
+ *   block stays live under the caller that allocated it.
+ *
+ * Each check prints "ok" or "FAIL"; a check that does not return within
+ * a few seconds is reported as hanging. The exit status is 0 if all of
+ * them passed.
+ */
+
+#include <signal.h>
+#include <unistd.h>
+
+#include "../../common/cmd_mallinfo.c"
+
+#define ARENA_SIZE	(1 << 20)
+#define MIN_SIZE	16		/* Smallest dlmalloc chunk	*/
+#define HANG_SECONDS	5
+
+ulong mem_malloc_start;
+ulong mem_malloc_end;
+
+/*
+ * Blocks are carved from the arena one after another and never reused,
+ * so that every block has its own address. The usable size sits in the
+ * word before the block.
+ */
+static unsigned char arena[ARENA_SIZE] __attribute__((aligned(16)));
+static size_t arena_used;
+static int realloc_fails;
+
+static size_t *block_size(void *mem)
+{
+	return (size_t *)mem - 1;
+}
+
+void *dlmalloc(size_t bytes)
+{
+	size_t size = bytes < MIN_SIZE ? MIN_SIZE : (bytes + 15) & ~15;
+	void *mem;
+
+	if (arena_used + 16 + size > ARENA_SIZE)
+		return NULL;
+	mem = arena + arena_used + 16;
+	*block_size(mem) = size;
+	arena_used += 16 + size;
+	return mem;
+}
+
+void dlfree(void *mem)
+{
+}
+
+void *dlrealloc(void *oldmem, size_t bytes)
+{
+	void *mem;
+
+	if (!oldmem)
+		return dlmalloc(bytes);
+	if (realloc_fails)
+		return NULL;
+	/* Shrink in place, like dlmalloc */
+	if (bytes <= *block_size(oldmem)) {
+		*block_size(oldmem) = bytes < MIN_SIZE ? MIN_SIZE :
+			(bytes + 15) & ~15;
+		return oldmem;
+	}
+	mem = dlmalloc(bytes);
+	if (mem)
+		memcpy(mem, oldmem, *block_size(oldmem));
+	return mem;
+}
+
+void *dlmemalign(size_t alignment, size_t bytes)
+{
+	return dlmalloc(bytes);
+}
+
+void *dlcalloc(size_t n, size_t elem_size)
+{
+	void *mem = dlmalloc(n * elem_size);
+
+	if (mem)
+		memset(mem, 0, n * elem_size);
+	return mem;
+}
+
+size_t malloc_usable_size(void *mem)
+{
+	return *block_size(mem);
+}
+
+void malloc_arena_info(struct malloc_arena_info *ai)
+{
+	memset(ai, 0, sizeof(*ai));
+	ai->arena = ai->max_arena = arena_used;
+	ai->topsize = ai->free = ai->largest = ARENA_SIZE - arena_used;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static int failed;
+static const char *running;
+
+static void check(const char *what, int ok)
+{
+	printf("%-60s %s\n", what, ok ? "ok" : "FAIL");
+	if (!ok)
+		failed = 1;
+}
+
+static void hang(int sig)
+{
+	printf("%-60s FAIL (hangs)\n", running);
+	exit(1);
+}
+
+static void start(const char *what)
+{
+	running = what;
+	alarm(HANG_SECONDS);
+}
+
+static int site_of(void *mem)
+{
+	ulong i;
+
+	for (i = 0; i < CONFIG_SYS_MALLOC_STATS_LIVE; i++) {
+		if (live[i].mem == mem)
+			return live[i].site;
+	}
+	return -1;
+}
+
+static void test_full_table(void)
+{
+	enum { N = CONFIG_SYS_MALLOC_STATS_LIVE + 8 };
+	static void *mem[N];
+	int i;
+
+	start("free() of an untracked block with the live table full");
+	for (i = 0; i < N; i++)
+		mem[i] = malloc(24);
+	check("live table keeps a slot empty",
+		nlive == CONFIG_SYS_MALLOC_STATS_LIVE - 1);
+	free(mem[N - 1]);
+	check(running, 1);
+	for (i = 0; i < N - 1; i++)
+		free(mem[i]);
+	check("all freed: no blocks, bytes or live entries left",
+		!ms.blocks && !ms.used && !nlive && !ms.untracked);
+	alarm(0);
+}
+
+static void test_realloc_zero(void)
+{
+	ulong calls, frees, fails;
+	void *p, *q;
+
+	start("realloc(p, 0)");
+	p = malloc(100);
+	calls = ms.calls;
+	frees = ms.frees;
+	fails = ms.fails;
+	q = realloc(p, 0);
+	check("realloc(p, 0) returns what dlrealloc() does",
+		q == p && malloc_usable_size(q) == MIN_SIZE);
+	check("realloc(p, 0) counts one call, no failure or free",
+		ms.calls == calls + 1 && ms.fails == fails &&
+		ms.frees == frees);
+	check("realloc(p, 0) leaves one block of the minimum size",
+		ms.blocks == 1 && ms.used == MIN_SIZE);
+	free(q);
+	alarm(0);
+}
+
+static void test_realloc_fail(void)
+{
+	ulong calls, fails;
+	void *p, *q;
+	int site;
+
+	start("failed realloc()");
+	p = malloc(100);
+	site = site_of(p);
+	calls = ms.calls;
+	fails = ms.fails;
+	realloc_fails = 1;
+	q = realloc(p, 1000);
+	realloc_fails = 0;
+	check("failed realloc() returns NULL", !q);
+	check("failed realloc() counts one call and one failure",
+		ms.calls == calls + 1 && ms.fails == fails + 1);
+	check("failed realloc() keeps the block with its caller",
+		site >= 0 && site_of(p) == site && sites[site].live == 1 &&
+		ms.blocks == 1 && ms.used == malloc_usable_size(p));
+	free(p);
+	alarm(0);
+}
+
+int main(void)
+{
+	signal(SIGALRM, hang);
+	mem_malloc_start = (ulong)arena;
+	mem_malloc_end = (ulong)arena + ARENA_SIZE;
+
+	test_full_table();
+	test_realloc_zero();
+	test_realloc_fail();
+
+	if (failed)
+		return 1;
+	__u_boot_cmd_mallinfo.cmd(NULL, 0, 2, (char *[]){ "mallinfo", "-v" });
+	return 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * netbench - host side of the U-Boot "netbench" command.
+ *
+ *   netbench [-p port] [-t seconds] [-l len] [-r kbit/s] send host
+ *   netbench [-p port] [-t seconds] sink
+ *
+ * "send" blasts UDP frames of len payload bytes (default 1472) at a
+ * board running "netbench sink", optionally paced to a rate. "sink"
+ * counts the frames of a board running "netbench send" and reports
+ * throughput, losses, reordering and jitter the same way the board
+ * does. The frame layout is in include/netbench.h.
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <netbench.h>
+
+#define IDLE_MS		2000	/* Sink stops after this silence */
+
+static struct {
+	unsigned long	frames;
+	unsigned long long bytes;
+	unsigned long	lost;
+	unsigned long	reordered;
+	uint32_t	first;
+	uint32_t	last;
+	uint32_t	next;
+	int32_t		transit;
+	uint32_t	jitter;		/* usec << 4 */
+} nb;
+
+static uint64_t now_usec(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: netbench [-p port] [-t seconds] [-l len] "
+		"[-r kbit/s] send host\n"
+		"       netbench [-p port] [-t seconds] sink\n");
+	exit(1);
+}
+
+static void report(int sink)
+{
+	uint32_t us = nb.last - nb.first;
+
+	if (us == 0)
+		us = 1;
+
+	printf("  %-10s %10lu\n", "frames", nb.frames);
+	printf("  %-10s %10llu\n", "bytes", nb.bytes);
+	printf("  %-10s %10u ms\n", "time", us / 1000);
+	printf("  %-10s %10llu frames/s %8llu kbit/s\n", "rate",
+		(unsigned long long)nb.frames * 1000000 / us,
+		nb.bytes * 8000 / us);
+
+	if (!sink)
+		return;
+
+	printf("  %-10s %10lu\n", "lost", nb.lost);
+	printf("  %-10s %10lu\n", "reordered", nb.reordered);
+	printf("  %-10s %10u us\n", "jitter", nb.jitter >> 4);
+}
+
+static void put_hdr(uint8_t *buf, uint32_t seq, uint32_t flags)
+{
+	struct netbench_hdr h;
+
+	h.magic = htonl(NETBENCH_MAGIC);
+	h.seq = htonl(seq);
+	h.usec = htonl((uint32_t)now_usec());
+	h.flags = htonl(flags);
+	memcpy(buf, &h, sizeof(h));
+}
+
+static int do_send(int s, struct sockaddr_in *to, int seconds, int len,
+		   unsigned long rate)
+{
+	static uint8_t buf[NETBENCH_MAX_LEN];
+	uint64_t start = now_usec();
+	uint64_t end = start + (uint64_t)seconds * 1000000;
+	uint64_t t;
+	int i;
+
+	printf("Sending %d byte UDP frames to %s:%d for %d s\n", len,
+		inet_ntoa(to->sin_addr), ntohs(to->sin_port), seconds);
+
+	nb.first = (uint32_t)start;
+	while ((t = now_usec()) < end) {
+		/* Pace to rate kbit/s: frame n is due at n * len * 8 / rate ms */
+		if (rate && t - start <
+		    (uint64_t)nb.frames * len * 8000 / rate)
+			continue;
+
+		put_hdr(buf, nb.frames, 0);
+		if (sendto(s, buf, len, 0, (struct sockaddr *)to,
+			   sizeof(*to)) < 0) {
+			/* Socket buffer full, try again */
+			if (errno == ENOBUFS || errno == EAGAIN)
+				continue;
+			perror("sendto");
+			return 1;
+		}
+		nb.frames++;
+		nb.bytes += len;
+		nb.last = (uint32_t)now_usec();
+	}
+
+	for (i = 0; i < NETBENCH_END_COUNT; i++) {
+		put_hdr(buf, nb.frames, NETBENCH_F_END);
+		sendto(s, buf, sizeof(struct netbench_hdr), 0,
+		       (struct sockaddr *)to, sizeof(*to));
+	}
+
+	report(0);
+	return 0;
+}
+
+static void sink_frame(const uint8_t *buf, int len, uint32_t now)
+{
+	struct netbench_hdr h;
+	uint32_t seq;
+	int32_t d;
+
+	memcpy(&h, buf, sizeof(h));
+	seq = ntohl(h.seq);
+
+	if (nb.frames == 0)
+		nb.first = now;
+	nb.last = now;
+	nb.frames++;
+	nb.bytes += len;
+
+	if (seq >= nb.next) {
+		nb.lost += seq - nb.next;
+		nb.next = seq + 1;
+	} else {
+		nb.reordered++;
+		if (nb.lost)
+			nb.lost--;
+	}
+
+	/* Interarrival jitter, as in RFC 3550, A.8 */
+	d = (int32_t)(now - ntohl(h.usec));
+	if (nb.frames > 1) {
+		int32_t diff = d - nb.transit;
+
+		if (diff < 0)
+			diff = -diff;
+		nb.jitter += diff - ((nb.jitter + 8) >> 4);
+	}
+	nb.transit = d;
+}
+
+static int do_sink(int s, int port, int seconds)
+{
+	static uint8_t buf[2048];
+	struct sockaddr_in addr;
+	struct timeval tv = { 0, 100000 };
+	uint64_t start = now_usec();
+	uint64_t seen = 0;
+	struct netbench_hdr h;
+	int len;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(port);
+	if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		perror("bind");
+		return 1;
+	}
+	setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+	printf("Counting UDP frames to port %d, ctrl-c to stop\n", port);
+
+	for (;;) {
+		uint64_t t;
+
+		len = recv(s, buf, sizeof(buf), 0);
+		t = now_usec();
+
+		if (len >= (int)sizeof(h)) {
+			memcpy(&h, buf, sizeof(h));
+			if (ntohl(h.magic) != NETBENCH_MAGIC)
+				continue;
+			if (ntohl(h.flags) & NETBENCH_F_END) {
+				/* Account for losses at the tail */
+				if (ntohl(h.seq) > nb.next)
+					nb.lost += ntohl(h.seq) - nb.next;
+				break;
+			}
+			sink_frame(buf, len, (uint32_t)t);
+			seen = t;
+		} else if (len < 0 && errno != EAGAIN &&
+			   errno != EWOULDBLOCK && errno != EINTR) {
+			perror("recv");
+			return 1;
+		}
+
+		if (seen && t - seen > IDLE_MS * 1000) {
+			printf("Sender went quiet\n");
+			break;
+		}
+		if (seconds && t - start >= (uint64_t)seconds * 1000000)
+			break;
+	}
+
+	report(1);
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	struct sockaddr_in to;
+	struct hostent *he;
+	unsigned long rate = 0;
+	int port = NETBENCH_PORT;
+	int seconds = -1;
+	int len = NETBENCH_MAX_LEN;
+	int buf = 1 << 20;
+	int c, s;
+
+	while ((c = getopt(argc, argv, "p:t:l:r:")) != -1) {
+		switch (c) {
+		case 'p':
+			port = atoi(optarg);
+			break;
+		case 't':
+			seconds = atoi(optarg);
+			break;
+		case 'l':
+			len = atoi(optarg);
+			break;
+		case 'r':
+			rate = strtoul(optarg, NULL, 10);
+			break;
+		default:
+			usage();
+		}
+	}
+	argc -= optind;
+	argv += optind;
+
+	if (argc < 1)
+		usage();
+
+	if (len < (int)sizeof(struct netbench_hdr) || len > NETBENCH_MAX_LEN) {
+		fprintf(stderr, "Frame length must be %d..%d\n",
+			(int)sizeof(struct netbench_hdr), NETBENCH_MAX_LEN);
+		return 1;
+	}
+
+	s = socket(AF_INET, SOCK_DGRAM, 0);
+	if (s < 0) {
+		perror("socket");
+		return 1;
+	}
+
+	if (strcmp(argv[0], "sink") == 0) {
+		setsockopt(s, SOL_SOCKET, SO_RCVBUF, &buf, sizeof(buf));
+		return do_sink(s, port, seconds < 0 ? 0 : seconds);
+	}
+
+	if (strcmp(argv[0], "send") != 0 || argc < 2)
+		usage();
+
+	he = gethostbyname(argv[1]);
+	if (!he) {
+		fprintf(stderr, "Unknown host %s\n", argv[1]);
+		return 1;
+	}
+	memset(&to, 0, sizeof(to));
+	to.sin_family = AF_INET;
+	memcpy(&to.sin_addr, he->h_addr, sizeof(to.sin_addr));
+	to.sin_port = htons(port);
+
+	return do_send(s, &to, seconds < 0 ? 10 : seconds, len, rate);
+}
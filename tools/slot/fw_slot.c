@@ -0,0 +1,263 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * fw_slot - A/B image slot record access from Linux.
+ *
+ *   fw_slot [-d device] [info]	show the current record
+ *   fw_slot [-d device] good	mark the slot U-Boot last tried as good
+ *
+ * The device is the MTD partition holding the slot record, by default
+ * the one named "fw_slot" in /proc/mtd. It must be a single erase
+ * block (CONFIG_SYS_SLOT_REC_SIZE in U-Boot). Run
+ * "fw_slot good" on every boot, once the system is known to work, e.g.
+ * at the end of the boot scripts: U-Boot takes one attempt per boot,
+ * and this gives them back. Attempts are counted from the first time
+ * this is run on a board.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#ifdef MTD_OLD
+# include <linux/mtd/mtd.h>
+#else
+# define  __user	/* nothing */
+# include <mtd/mtd-user.h>
+#endif
+
+#include <slot.h>
+
+#ifndef FW_SLOT_MTDNAME
+# define FW_SLOT_MTDNAME	"fw_slot"
+#endif
+
+extern unsigned	long  crc32	 (unsigned long, const unsigned char *, unsigned);
+
+static struct slot_rec rec;
+static off_t next;		/* Where the next entry goes		*/
+static int clean;		/* next is in erased space		*/
+
+static int erased(const uint8_t *p)
+{
+	int i;
+
+	for (i = 0; i < SLOT_REC_LEN; i++) {
+		if (p[i] != 0xff)
+			return 0;
+	}
+	return 1;
+}
+
+/*
+ * Find the MTD partition named FW_SLOT_MTDNAME
+ */
+static const char *find_device(void)
+{
+	static char dev[32];
+	char line[128];
+	FILE *f;
+	int n;
+
+	f = fopen("/proc/mtd", "r");
+	if (!f)
+		return NULL;
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "mtd%d:", &n) == 1 &&
+		    strstr(line, "\"" FW_SLOT_MTDNAME "\"")) {
+			snprintf(dev, sizeof(dev), "/dev/mtd%d", n);
+			fclose(f);
+			return dev;
+		}
+	}
+	fclose(f);
+	return NULL;
+}
+
+/*
+ * Same scan as slot_load() in U-Boot
+ */
+static int load(int fd, size_t size)
+{
+	uint8_t *buf;
+	struct slot_rec *r;
+	int found = 0;
+	size_t off;
+
+	buf = malloc(size);
+	if (!buf) {
+		fprintf(stderr, "Out of memory\n");
+		return -1;
+	}
+	if (pread(fd, buf, size, 0) != size) {
+		fprintf(stderr, "Read error: %s\n", strerror(errno));
+		free(buf);
+		return -1;
+	}
+
+	next = size;
+	clean = 0;
+	for (off = 0; off + SLOT_REC_LEN <= size; off += SLOT_REC_LEN) {
+		r = (struct slot_rec *)(buf + off);
+		if (erased(buf + off)) {
+			next = off;
+			clean = 1;
+			break;
+		}
+		if (r->magic != SLOT_MAGIC || r->crc != SLOT_REC_CRC(r))
+			continue;
+		if (!found || r->seq > rec.seq) {
+			rec = *r;
+			found = 1;
+		}
+	}
+	free(buf);
+
+	if (!found) {
+		fprintf(stderr, "No slot record\n");
+		return -1;
+	}
+	return 0;
+}
+
+static int save(int fd, size_t size)
+{
+	rec.seq++;
+	rec.crc = SLOT_REC_CRC(&rec);
+
+	if (!clean || next + SLOT_REC_LEN > size) {
+		struct erase_info_user erase;
+
+		erase.start = 0;
+		erase.length = size;
+		if (ioctl(fd, MEMERASE, &erase) != 0) {
+			fprintf(stderr, "Erase error: %s\n", strerror(errno));
+			return -1;
+		}
+		next = 0;
+	}
+
+	if (pwrite(fd, &rec, SLOT_REC_LEN, next) != SLOT_REC_LEN) {
+		fprintf(stderr, "Write error: %s\n", strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+static void info(void)
+{
+	struct slot_info *s;
+	int i;
+
+	printf("Active slot: %c, last tried: %c\n", 'a' + rec.active,
+		rec.booting < SLOT_MAX ? 'a' + rec.booting : '-');
+
+	for (i = 0; i < SLOT_MAX; i++) {
+		s = &rec.slot[i];
+		printf("  %c: ", 'a' + i);
+		if (!s->size) {
+			printf("empty\n");
+			continue;
+		}
+		printf("len 0x%08x dcrc 0x%08x time 0x%08x %s, "
+			"%u tries left\n", s->size, s->dcrc, s->version,
+			s->good ? "good" : "new", s->tries);
+	}
+	if (!rec.counting)
+		printf("Tries are not counted until a slot is marked good\n");
+}
+
+int main(int argc, char *argv[])
+{
+	const char *dev = NULL;
+	const char *cmd = "info";
+	struct mtd_info_user mtd;
+	struct slot_info *s;
+	int fd, c, good;
+
+	while ((c = getopt(argc, argv, "d:")) != -1) {
+		if (c != 'd') {
+			fprintf(stderr, "Usage: %s [-d device] [info|good]\n",
+				argv[0]);
+			return 1;
+		}
+		dev = optarg;
+	}
+	if (optind < argc)
+		cmd = argv[optind];
+
+	if (!dev)
+		dev = find_device();
+	if (!dev) {
+		fprintf(stderr, "No \"%s\" MTD partition\n", FW_SLOT_MTDNAME);
+		return 1;
+	}
+
+	good = strcmp(cmd, "good") == 0;
+	if (!good && strcmp(cmd, "info") != 0) {
+		fprintf(stderr, "Unknown command \"%s\"\n", cmd);
+		return 1;
+	}
+
+	fd = open(dev, good ? O_RDWR : O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "Can't open %s: %s\n", dev, strerror(errno));
+		return 1;
+	}
+	if (ioctl(fd, MEMGETINFO, &mtd) != 0) {
+		fprintf(stderr, "%s: not an MTD device\n", dev);
+		return 1;
+	}
+	if (load(fd, mtd.erasesize))
+		return 1;
+
+	if (!good) {
+		info();
+		return 0;
+	}
+
+	if (rec.booting >= SLOT_MAX) {
+		fprintf(stderr, "No slot was booted\n");
+		return 1;
+	}
+	s = &rec.slot[rec.booting];
+	if (s->good && s->tries == rec.limit && rec.counting)
+		return 0;
+
+	s->good = 1;
+	s->tries = rec.limit;
+	rec.counting = 1;
+	if (save(fd, mtd.erasesize))
+		return 1;
+
+	close(fd);
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <net.h>: the IP header and the few net.c services
+ * net/tcp.c relies on, provided by tcpsim.c.
+ */
+#ifndef __TCPSIM_NET_H__
+#define __TCPSIM_NET_H__
+
+typedef u32		IPaddr_t;
+typedef void		thand_f(void);
+
+#ifdef CONFIG_SYS_RX_ETH_BUFFER
+# define PKTBUFSRX	CONFIG_SYS_RX_ETH_BUFFER
+#else
+# define PKTBUFSRX	4
+#endif
+
+typedef struct {
+	uchar		ip_hl_v;	/* header length and version	*/
+	uchar		ip_tos;		/* type of service		*/
+	ushort		ip_len;		/* total length			*/
+	ushort		ip_id;		/* identification		*/
+	ushort		ip_off;		/* fragment offset field	*/
+	uchar		ip_ttl;		/* time to live			*/
+	uchar		ip_p;		/* protocol			*/
+	ushort		ip_sum;		/* checksum			*/
+	IPaddr_t	ip_src;		/* Source IP address		*/
+	IPaddr_t	ip_dst;		/* Destination IP address	*/
+	ushort		udp_src;	/* UDP source port		*/
+	ushort		udp_dst;	/* UDP destination port		*/
+	ushort		udp_len;	/* Length of UDP packet		*/
+	ushort		udp_xsum;	/* Checksum			*/
+} IP_t;
+
+#define IP_FLAGS_DFRAG	0x4000 /* don't fragments */
+
+#define IP_HDR_SIZE_NO_UDP	(sizeof (IP_t) - 8)
+
+extern uchar		*NetTxPacket;
+extern IPaddr_t		NetOurIP;
+extern unsigned		NetIPID;
+
+extern int	NetEthHdrSize(void);
+extern uint	NetCksum(uchar *, int);
+extern void	NetSetTimeout(ulong, thand_f *);
+extern int	NetSendIPPacket(uchar *ether, IPaddr_t dest, int len);
+extern unsigned int random_port(void);
+
+static inline IPaddr_t NetReadIP(volatile void *from)
+{
+	IPaddr_t ip;
+	memcpy((void*)&ip, (void*)from, sizeof(ip));
+	return ip;
+}
+
+static inline void NetCopyIP(volatile void *to, void *from)
+{
+	memcpy((void*)to, from, sizeof(IPaddr_t));
+}
+
+#endif /* __TCPSIM_NET_H__ */
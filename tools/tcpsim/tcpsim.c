@@ -0,0 +1,766 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * tcpsim - run net/tcp.c on the host against a simulated link and peer.
+ *
+ *   tcpsim [-b Mbit/s] [-n ring] [-w window] [-c us] [-s KB:us]
+ *          [-d us] [-l loss%] [-m MB] [-r seed]
+ *
+ * The board side is the unmodified net/tcp.c, pulling -m MB (default 4)
+ * like "wget" does. It sits behind an ethernet RX ring of -n frames
+ * (default 2) that is drained one frame per -c microseconds of CPU time
+ * (default 40, checksum plus the copy to DDR); a frame arriving at a
+ * full ring is dropped, as the MAC does. -s KB:us adds a stall of us
+ * microseconds every KB kilobytes received, e.g. a flash write.
+ *
+ * The peer is a Reno sender (initial window 10, fast retransmit and
+ * recovery, 200 ms minimum RTO, no SACK) on the far side of a -b Mbit/s
+ * (default 100) link with -d microseconds (default 50) one-way latency
+ * and -l percent random loss.
+ *
+ * Without -w, every window from 1 to 8 segments is run for the ring
+ * and the table is printed; -w runs only that window (in bytes). The
+ * window is handed to tcp.c through ${tcpwin}, like on the board.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "include/common.h"
+#include "include/net.h"
+#include "../../net/tcp.h"
+
+#define ETH_HDR		14
+#define ETH_WIRE	(4 + 8 + 12)	/* FCS, preamble, inter-frame gap */
+#define ETH_MIN		64
+#define HOST_IW		10		/* Initial window, segments	*/
+#define HOST_RTO_MIN	200000		/* us				*/
+#define HOST_TURN	20		/* ACK to next segment, us	*/
+#define RING_MAX	64
+#define EV_MAX		4096
+#define SIM_LIMIT	(120 * 1000000ULL)
+
+#define SEQ_LT(a, b)	((int)((a) - (b)) < 0)
+
+static struct {
+	unsigned	mbit;
+	unsigned	ring;
+	unsigned	wnd;
+	unsigned	cost;
+	unsigned	stall_kb;
+	unsigned	stall_us;
+	unsigned	delay;
+	unsigned	loss;		/* Per 10000		*/
+	unsigned	total;
+} cfg = { 100, 2, 0, 40, 0, 0, 50, 0, 4 << 20 };
+
+/* Simulated time, us */
+static uint64_t now;
+
+/*
+ * Events
+ */
+enum { EV_TO_BOARD, EV_TO_HOST, EV_BOARD_TIMER, EV_BOARD_DONE, EV_HOST_RTO };
+
+struct seg {
+	ushort		port;		/* Board's port			*/
+	u32		seq;
+	u32		ack;
+	unsigned	len;
+	int		flags;
+	unsigned	wnd;
+};
+
+struct event {
+	uint64_t	t;
+	int		type;
+	struct seg	seg;
+};
+
+static struct event	ev[EV_MAX];
+static int		nev;
+
+static void ev_add(uint64_t t, int type, struct seg *seg)
+{
+	int i = nev++, p;
+
+	if (nev > EV_MAX) {
+		fprintf(stderr, "tcpsim: event queue overflow\n");
+		exit(2);
+	}
+	/* Binary heap on time; equal times keep insertion order loosely */
+	while (i && ev[p = (i - 1) / 2].t > t) {
+		ev[i] = ev[p];
+		i = p;
+	}
+	ev[i].t = t;
+	ev[i].type = type;
+	if (seg)
+		ev[i].seg = *seg;
+}
+
+static struct event ev_pop(void)
+{
+	struct event top = ev[0], last = ev[--nev];
+	int i = 0, c;
+
+	while ((c = 2 * i + 1) < nev) {
+		if (c + 1 < nev && ev[c + 1].t < ev[c].t)
+			c++;
+		if (ev[c].t >= last.t)
+			break;
+		ev[i] = ev[c];
+		i = c;
+	}
+	ev[i] = last;
+
+	return top;
+}
+
+/*
+ * Wire: each direction serializes frames back to back
+ */
+static uint64_t wire_free[2];
+static unsigned long wire_lost;
+
+static void wire_send(int to_board, struct seg *seg, uint64_t t0)
+{
+	unsigned bytes = ETH_HDR + IP_HDR_SIZE_NO_UDP + TCP_HDR_SIZE + seg->len;
+	uint64_t *busy = &wire_free[to_board];
+	uint64_t t;
+
+	if (bytes < ETH_MIN - 4)
+		bytes = ETH_MIN - 4;
+	bytes += ETH_WIRE;
+
+	t = *busy > t0 ? *busy : t0;
+	t += (bytes * 8 + cfg.mbit - 1) / cfg.mbit;
+	*busy = t;
+
+	if (cfg.loss && (unsigned)(rand() % 10000) < cfg.loss) {
+		wire_lost++;
+		return;
+	}
+	ev_add(t + cfg.delay, to_board ? EV_TO_BOARD : EV_TO_HOST, seg);
+}
+
+/*
+ * Board: the services net.c gives tcp.c, the RX ring and the CPU
+ */
+static uchar		txbuf[2048];
+uchar			*NetTxPacket = txbuf;
+IPaddr_t		NetOurIP;
+unsigned		NetIPID;
+
+static IPaddr_t		host_ip;
+static char		wnd_str[16];
+
+static struct seg	ring[RING_MAX];
+static unsigned		ring_head, ring_cnt;
+static unsigned long	ring_drops;
+static int		board_busy;
+static uint64_t		board_stall;
+
+static ulong		timer_start, timer_delta;
+static thand_f		*timer_handler;
+
+static int		app_done, app_state;
+static unsigned long	app_bytes, app_bad;
+static uint64_t		app_first, app_last;
+
+static const char	req[] = "GET /image HTTP/1.0\r\n\r\n";
+
+ulong get_timer(ulong base)
+{
+	return now / 1000 - base;
+}
+
+char *getenv(const char *name)
+{
+	if (!strcmp(name, "tcpwin") && cfg.wnd) {
+		sprintf(wnd_str, "%u", cfg.wnd);
+		return wnd_str;
+	}
+	return NULL;
+}
+
+unsigned int random_port(void)
+{
+	return 1024 + rand() % 4096;
+}
+
+int NetEthHdrSize(void)
+{
+	return ETH_HDR;
+}
+
+uint NetCksum(uchar *ptr, int len)
+{
+	ulong	xsum;
+	ushort *p = (ushort *)ptr;
+
+	xsum = 0;
+	while (len-- > 0)
+		xsum += *p++;
+	xsum = (xsum & 0xffff) + (xsum >> 16);
+	xsum = (xsum & 0xffff) + (xsum >> 16);
+	return (xsum & 0xffff);
+}
+
+void NetSetTimeout(ulong ms, thand_f *handler)
+{
+	timer_handler = ms ? handler : NULL;
+	timer_start = get_timer(0);
+	timer_delta = ms;
+	if (timer_handler)
+		ev_add((timer_start + timer_delta + 1) * 1000ULL,
+		       EV_BOARD_TIMER, NULL);
+}
+
+static u32 get32(const uchar *p)
+{
+	return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static void put32(uchar *p, u32 v)
+{
+	p[0] = v >> 24;
+	p[1] = v >> 16;
+	p[2] = v >> 8;
+	p[3] = v;
+}
+
+/* The frame tcp.c built in NetTxPacket goes to the host */
+int NetSendIPPacket(uchar *ether, IPaddr_t dest, int len)
+{
+	IP_t *ip = (IP_t *)(NetTxPacket + ETH_HDR);
+	TCP_t *th = (TCP_t *)((uchar *)ip + IP_HDR_SIZE_NO_UDP);
+	struct seg seg;
+
+	seg.port = ntohs(th->tcp_src);
+	seg.seq = get32(th->tcp_seq);
+	seg.ack = get32(th->tcp_ack);
+	seg.flags = th->tcp_flags;
+	seg.wnd = ntohs(th->tcp_wnd);
+	seg.len = len - IP_HDR_SIZE_NO_UDP - (th->tcp_off >> 4) * 4;
+	wire_send(0, &seg, now);
+
+	/* The driver busy-waits for the transmission to finish */
+	board_stall += wire_free[0] - now;
+
+	return 0;
+}
+
+/* Payload byte at stream offset off */
+static uchar pattern(unsigned long off)
+{
+	return off * 7 + (off >> 11);
+}
+
+static void app_recv(uchar *data, unsigned len)
+{
+	unsigned i;
+
+	if (!app_bytes)
+		app_first = now;
+	for (i = 0; i < len; i++)
+		if (data[i] != pattern(app_bytes + i))
+			app_bad++;
+	if (cfg.stall_kb &&
+	    (app_bytes + len) / (cfg.stall_kb << 10) !=
+	    app_bytes / (cfg.stall_kb << 10))
+		board_stall += cfg.stall_us;
+	app_bytes += len;
+	app_last = now;
+}
+
+static void app_event(int event)
+{
+	app_state = event;
+	switch (event) {
+	case TCP_EV_CONNECTED:
+		TcpSend((const uchar *)req, sizeof(req) - 1);
+		break;
+	case TCP_EV_FIN:
+		TcpClose();
+		break;
+	default:
+		app_done = 1;
+		break;
+	}
+}
+
+/* Build the host's segment as a frame and feed it to tcp.c */
+static void board_input(struct seg *seg, u32 data_off)
+{
+	static uchar frame[2048];
+	IP_t *ip = (IP_t *)(frame + ETH_HDR);
+	TCP_t *th = (TCP_t *)((uchar *)ip + IP_HDR_SIZE_NO_UDP);
+	uchar *data = (uchar *)(th + 1);
+	unsigned len = TCP_HDR_SIZE + seg->len;
+	ushort ph[6];
+	uint sum;
+	unsigned i;
+
+	memset(frame, 0, ETH_HDR + IP_HDR_SIZE_NO_UDP + TCP_HDR_SIZE);
+	for (i = 0; i < seg->len; i++)
+		data[i] = pattern(data_off + i);
+
+	ip->ip_hl_v = 0x45;
+	ip->ip_len = htons(IP_HDR_SIZE_NO_UDP + len);
+	ip->ip_p = IPPROTO_TCP;
+	ip->ip_src = host_ip;
+	ip->ip_dst = NetOurIP;
+
+	th->tcp_src = htons(80);
+	th->tcp_dst = htons(seg->port);
+	put32(th->tcp_seq, seg->seq);
+	put32(th->tcp_ack, seg->ack);
+	th->tcp_off = (TCP_HDR_SIZE / 4) << 4;
+	th->tcp_flags = seg->flags;
+	th->tcp_wnd = htons(seg->wnd);
+
+	memcpy(ph, &ip->ip_src, 8);
+	ph[4] = htons(IPPROTO_TCP);
+	ph[5] = htons(len);
+	sum = NetCksum((uchar *)ph, 6) + NetCksum((uchar *)th, len / 2);
+	if (len & 1)
+		sum += data[seg->len - 1];
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	th->tcp_sum = ~sum;
+
+	TcpReceive(ip, IP_HDR_SIZE_NO_UDP + len);
+}
+
+/*
+ * Host: a Reno sender serving cfg.total bytes once the request is in
+ */
+#define HOST_ISS	1000000
+
+static struct {
+	int		syn;		/* SYN seen			*/
+	int		req;		/* Request seen, serving	*/
+	int		fin;		/* Board's FIN seen		*/
+	ushort		port;
+	u32		rcv_nxt;
+	u32		snd_una;
+	u32		snd_nxt;
+	u32		snd_max;
+	u32		data_end;	/* Seq of our FIN		*/
+	unsigned	wnd;		/* Board's window		*/
+	unsigned	cwnd;
+	unsigned	ssthresh;
+	int		dupacks;
+	int		recovery;
+	u32		recover;
+	uint64_t	rto;
+	uint64_t	rto_time;	/* 0: not armed			*/
+	uint64_t	rto_event;	/* Queued timer event, or 0	*/
+	unsigned long	rexmits;
+	unsigned long	timeouts;
+} host;
+
+static void host_segment(u32 seq, int flags, unsigned len)
+{
+	struct seg seg;
+
+	seg.port = host.port;
+	seg.seq = seq;
+	seg.ack = host.rcv_nxt;
+	seg.len = len;
+	seg.flags = flags | TCP_ACK;
+	seg.wnd = 0xffff;
+	if (SEQ_LT(seq, host.snd_max))
+		host.rexmits++;
+	wire_send(1, &seg, now + HOST_TURN);
+}
+
+/* One timer event in the queue at a time, however often it is rearmed */
+static void host_rto_arm(void)
+{
+	host.rto_time = now + host.rto;
+	if (!host.rto_event || host.rto_time < host.rto_event) {
+		host.rto_event = host.rto_time;
+		ev_add(host.rto_time, EV_HOST_RTO, NULL);
+	}
+}
+
+/* Send a segment at seq, data or our FIN */
+static unsigned host_send(u32 seq)
+{
+	unsigned len;
+
+	if (SEQ_LT(seq, host.data_end)) {
+		len = host.data_end - seq;
+		if (len > TCP_MSS)
+			len = TCP_MSS;
+		host_segment(seq, TCP_PSH, len);
+		return len;
+	}
+	host_segment(seq, TCP_FIN, 0);
+	return 1;
+}
+
+/* Send what the congestion and receive windows allow; 0 if nothing */
+static int host_output(void)
+{
+	unsigned wnd = host.cwnd < host.wnd ? host.cwnd : host.wnd;
+	int sent = 0;
+	unsigned len;
+
+	while (SEQ_LT(host.snd_nxt, host.data_end + 1)) {
+		len = host.data_end - host.snd_nxt;
+		if (len > TCP_MSS)
+			len = TCP_MSS;
+		if (host.snd_nxt + len - host.snd_una > wnd)
+			break;
+		host.snd_nxt += host_send(host.snd_nxt);
+		if (SEQ_LT(host.snd_max, host.snd_nxt))
+			host.snd_max = host.snd_nxt;
+		sent = 1;
+	}
+	if (sent && !host.rto_time)
+		host_rto_arm();
+
+	return sent;
+}
+
+static void host_ack(struct seg *seg)
+{
+	u32 ack = seg->ack;
+	unsigned flight = host.snd_max - host.snd_una;
+	unsigned n;
+
+	host.wnd = seg->wnd;
+
+	if (SEQ_LT(host.snd_una, ack) && !SEQ_LT(host.snd_max, ack)) {
+		n = ack - host.snd_una;
+		host.snd_una = ack;
+		if (SEQ_LT(host.snd_nxt, ack))
+			host.snd_nxt = ack;
+		host.dupacks = 0;
+		host.rto = HOST_RTO_MIN;
+		host.rto_time = 0;
+		if (ack != host.snd_max)
+			host_rto_arm();
+
+		if (host.recovery && SEQ_LT(ack, host.recover)) {
+			/* Partial ACK: the next hole */
+			host_send(ack);
+			host.cwnd = host.cwnd > n ? host.cwnd - n + TCP_MSS :
+				    TCP_MSS;
+		} else if (host.recovery) {
+			host.recovery = 0;
+			host.cwnd = host.ssthresh;
+		} else if (host.cwnd < host.ssthresh) {
+			host.cwnd += TCP_MSS;
+		} else {
+			host.cwnd += TCP_MSS * TCP_MSS / host.cwnd;
+		}
+		return;
+	}
+
+	if (ack != host.snd_una || seg->len || host.snd_una == host.snd_max)
+		return;
+
+	if (++host.dupacks == 3 && !host.recovery) {
+		host.ssthresh = flight / 2 > 2 * TCP_MSS ? flight / 2 :
+				2 * TCP_MSS;
+		host.cwnd = host.ssthresh + 3 * TCP_MSS;
+		host.recovery = 1;
+		host.recover = host.snd_max;
+		host_send(host.snd_una);
+	} else if (host.recovery) {
+		host.cwnd += TCP_MSS;
+	}
+}
+
+static void host_input(struct seg *seg)
+{
+	int need_ack = 0;
+
+	if (seg->flags & TCP_RST)
+		return;
+
+	if (seg->flags & TCP_SYN) {
+		host.syn = 1;
+		host.port = seg->port;
+		host.rcv_nxt = seg->seq + 1;
+		host.wnd = seg->wnd;
+		host.snd_una = HOST_ISS;
+		host.snd_nxt = host.snd_max = HOST_ISS + 1;
+		host.data_end = HOST_ISS + 1 + cfg.total;
+		wire_send(1, &(struct seg){ host.port, HOST_ISS, host.rcv_nxt,
+					    0, TCP_SYN | TCP_ACK, 0xffff },
+			  now + HOST_TURN);
+		return;
+	}
+	if (!host.syn)
+		return;
+
+	if (seg->flags & TCP_ACK)
+		host_ack(seg);
+
+	if (seg->len || (seg->flags & TCP_FIN)) {
+		if (seg->seq == host.rcv_nxt) {
+			host.rcv_nxt += seg->len;
+			if (seg->len)
+				host.req = 1;
+			if (seg->flags & TCP_FIN) {
+				host.rcv_nxt++;
+				host.fin = 1;
+			}
+		}
+		need_ack = 1;
+	}
+
+	if ((!host.req || !host_output()) && need_ack)
+		host_segment(host.snd_nxt, 0, 0);
+}
+
+static void host_timeout(void)
+{
+	unsigned flight = host.snd_max - host.snd_una;
+
+	if (now == host.rto_event)
+		host.rto_event = 0;
+	if (!host.rto_time)
+		return;
+	if (now < host.rto_time) {
+		if (!host.rto_event) {
+			host.rto_event = host.rto_time;
+			ev_add(host.rto_time, EV_HOST_RTO, NULL);
+		}
+		return;
+	}
+	host.rto_time = 0;
+	if (host.snd_una == host.snd_max)
+		return;
+
+	host.timeouts++;
+	host.ssthresh = flight / 2 > 2 * TCP_MSS ? flight / 2 : 2 * TCP_MSS;
+	host.cwnd = TCP_MSS;
+	host.recovery = 0;
+	host.dupacks = 0;
+	host.snd_nxt = host.snd_una;
+	if (host.rto < 60 * 1000000ULL)
+		host.rto *= 2;
+	if (!host_output())
+		host_rto_arm();
+}
+
+/*
+ * Board CPU: one frame per cfg.cost us, plus any stall the receiver
+ * asked for; the ring slot is freed when the frame is done
+ */
+static void board_poll(void)
+{
+	thand_f *h;
+
+	if (board_busy)
+		return;
+
+	if (timer_handler && get_timer(timer_start) > timer_delta) {
+		h = timer_handler;
+		timer_handler = NULL;
+		h();
+	}
+
+	if (ring_cnt) {
+		board_busy = 1;
+		ev_add(now + cfg.cost, EV_BOARD_DONE, NULL);
+	}
+}
+
+static void board_done(void)
+{
+	struct seg *seg = &ring[ring_head];
+	uint64_t stall;
+
+	if (board_busy == 1) {
+		board_input(seg, seg->seq - (HOST_ISS + 1));
+		if (board_stall) {
+			stall = board_stall;
+			board_stall = 0;
+			board_busy = 2;
+			ev_add(now + stall, EV_BOARD_DONE, NULL);
+			return;
+		}
+	}
+
+	ring_head = (ring_head + 1) % cfg.ring;
+	ring_cnt--;
+	board_busy = 0;
+	board_poll();
+}
+
+static void board_rx(struct seg *seg)
+{
+	if (ring_cnt == cfg.ring) {
+		ring_drops++;
+		return;
+	}
+	ring[(ring_head + ring_cnt++) % cfg.ring] = *seg;
+	board_poll();
+}
+
+/*
+ * Run one transfer with the current cfg and print a table row
+ */
+static void run(unsigned seed)
+{
+	struct event e;
+	double secs, kbs;
+
+	srand(seed);
+	memset(&host, 0, sizeof(host));
+	host.cwnd = HOST_IW * TCP_MSS;
+	host.ssthresh = 0xffffffff;
+	host.rto = HOST_RTO_MIN;
+	now = 0;
+	nev = 0;
+	wire_free[0] = wire_free[1] = 0;
+	wire_lost = 0;
+	ring_head = ring_cnt = 0;
+	ring_drops = 0;
+	board_busy = 0;
+	board_stall = 0;
+	timer_handler = NULL;
+	app_done = app_bytes = app_bad = 0;
+	app_first = app_last = 0;
+
+	NetOurIP = htonl(0xc0a80002);
+	host_ip = htonl(0xc0a80001);
+
+	TcpConnect(host_ip, 80, app_recv, app_event);
+
+	while (!app_done && nev && now < SIM_LIMIT) {
+		e = ev_pop();
+		now = e.t;
+		switch (e.type) {
+		case EV_TO_BOARD:
+			board_rx(&e.seg);
+			break;
+		case EV_TO_HOST:
+			host_input(&e.seg);
+			break;
+		case EV_BOARD_TIMER:
+			board_poll();
+			break;
+		case EV_BOARD_DONE:
+			board_done();
+			break;
+		case EV_HOST_RTO:
+			host_timeout();
+			break;
+		}
+	}
+
+	secs = (app_last - app_first) / 1e6;
+	kbs = secs > 0 ? app_bytes / 1024.0 / secs : 0;
+	printf("%6u %9.0f %7lu %7lu %5lu  %s\n",
+	       cfg.wnd, kbs, ring_drops,
+	       host.rexmits, host.timeouts,
+	       app_bad ? "corrupt" : app_bytes != cfg.total ? "too slow" :
+	       app_state == TCP_EV_CLOSED ? "ok" : "no close");
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"usage: tcpsim [-b Mbit/s] [-n ring] [-w window] [-c us] "
+		"[-s KB:us]\n"
+		"              [-d us] [-l loss%%] [-m MB] [-r seed]\n");
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	static const unsigned segs[] = { 1, 2, 3, 4, 6, 8, 12, 16, 44 };
+	unsigned seed = 1;
+	unsigned i;
+	int c;
+
+	while ((c = getopt(argc, argv, "b:n:w:c:s:d:l:m:r:")) != -1) {
+		switch (c) {
+		case 'b':
+			cfg.mbit = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			cfg.ring = strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			cfg.wnd = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			cfg.cost = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			if (sscanf(optarg, "%u:%u", &cfg.stall_kb,
+				   &cfg.stall_us) != 2)
+				usage();
+			break;
+		case 'd':
+			cfg.delay = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			cfg.loss = strtod(optarg, NULL) * 100;
+			break;
+		case 'm':
+			cfg.total = strtoul(optarg, NULL, 0) << 20;
+			break;
+		case 'r':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage();
+		}
+	}
+	if (optind != argc || !cfg.mbit || !cfg.ring || cfg.ring > RING_MAX)
+		usage();
+
+	printf("%u Mbit/s, %u us latency, %.2f%% loss; ring %u, %u us/frame",
+	       cfg.mbit, cfg.delay, cfg.loss / 100.0, cfg.ring, cfg.cost);
+	if (cfg.stall_kb)
+		printf(", %u us stall per %u KB", cfg.stall_us, cfg.stall_kb);
+	printf("; %u KB\n", cfg.total >> 10);
+	printf("window      KB/s   drops  rexmit  RTOs\n");
+
+	if (cfg.wnd) {
+		run(seed);
+		return 0;
+	}
+	for (i = 0; i < sizeof(segs) / sizeof(segs[0]); i++) {
+		cfg.wnd = segs[i] * TCP_MSS;
+		if (cfg.wnd > 0xffff)
+			cfg.wnd = 0xffff;
+		run(seed);
+	}
+
+	return 0;
+}
@@ -0,0 +1,47 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * Host stand-in for <common.h>: just what common/xyzModem.c uses. The
+ * console is the pseudo terminal the sender runs on, see ymodemtest.c.
+ */
+#ifndef __YMODEMTEST_COMMON_H__
+#define __YMODEMTEST_COMMON_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* xyzModem.c has its own EOF (^Z) */
+#undef EOF
+
+int ymt_tstc(void);
+int ymt_getc(void);
+void ymt_putc(const char c);
+void udelay(unsigned long usec);
+
+#define tstc	ymt_tstc
+#define getc	ymt_getc
+#define putc	ymt_putc
+
+#endif /* __YMODEMTEST_COMMON_H__ */
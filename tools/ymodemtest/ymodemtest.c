@@ -0,0 +1,289 @@
+/*
+ * (C) Copyright 2026 CSIRO
+ * Commonwealth Scientific and Industrial Research Organisation
+ *
+ * See file CREDITS for list of people who contributed to this
+ * project.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ * MA 02111-1307 USA
+ */
+
+/*
+ * ymodemtest - receive a file with common/xyzModem.c on the host, from
+ * a real sender running on the far side of a pseudo terminal.
+ *
+ *   ymodemtest [-x | -y | -g] [-e offset] file sender [args...]
+ *
+ * The sender runs with the pty as its stdin and stdout, and "file" is
+ * appended to its arguments. -x, -y and -g (the default) receive with
+ * X-modem, Y-modem and Y-modem-G, as "loadx", "loady" and "loadyg" do.
+ * -e flips a bit in the byte at that offset of the received stream:
+ * X-/Y-modem should NAK and get the block again, Y-modem-G should
+ * cancel the transfer.
+ *
+ * With lrzsz installed:
+ *
+ *   ymodemtest -g image.bin sb
+ *   ymodemtest -y image.bin sb
+ *   ymodemtest -x image.bin sx -k
+ *   ymodemtest -g -e 50000 image.bin sb
+ *
+ * The exit status is 0 if the received data matches the file (plus the
+ * ^Z padding X-modem adds to the last block), 1 otherwise.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+
+#include <common.h>
+#include <xyzModem.h>
+
+static int ymt_fd = -1;		/* pty master			*/
+static int ymt_have;		/* ymt_byte holds a byte	*/
+static unsigned char ymt_byte;
+static long ymt_count;		/* Bytes received so far	*/
+static long ymt_flip = -1;	/* Offset of the byte to corrupt */
+
+int ymt_tstc(void)
+{
+	ssize_t n;
+
+	if (ymt_have)
+		return 1;
+	/* EIO once the sender has exited: no more input, as on a UART */
+	n = read(ymt_fd, &ymt_byte, 1);
+	if (n == 1) {
+		if (ymt_count++ == ymt_flip)
+			ymt_byte ^= 0x01;
+		ymt_have = 1;
+	}
+	return ymt_have;
+}
+
+int ymt_getc(void)
+{
+	while (!ymt_tstc())
+		udelay(100);
+	ymt_have = 0;
+	return ymt_byte;
+}
+
+void ymt_putc(const char c)
+{
+	while (write(ymt_fd, &c, 1) != 1 && errno == EAGAIN)
+		udelay(100);
+}
+
+static long long ymt_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+void udelay(unsigned long usec)
+{
+	struct pollfd p = { .fd = ymt_fd, .events = POLLIN };
+	long long end = ymt_ns() + usec * 1000LL;
+
+	/*
+	 * Spin: xyzModem times out by counting udelay(20) calls, and
+	 * sleeping for 20 us takes several times that. A byte arriving
+	 * ends the wait early; callers poll tstc() again.
+	 */
+	do {
+		if (poll(&p, 1, 0) > 0 && (p.revents & POLLIN))
+			return;
+	} while (ymt_ns() < end);
+}
+
+/* As in common/cmd_load.c */
+static int ymt_getcxmodem(void)
+{
+	if (tstc())
+		return getc();
+	return -1;
+}
+
+static pid_t ymt_spawn(char **argv)
+{
+	struct termios t;
+	char *slave;
+	pid_t pid;
+	int fd;
+
+	ymt_fd = posix_openpt(O_RDWR | O_NOCTTY);
+	if (ymt_fd < 0 || grantpt(ymt_fd) || unlockpt(ymt_fd) ||
+	    !(slave = ptsname(ymt_fd))) {
+		perror("pty");
+		exit(2);
+	}
+
+	/* Raw before the sender starts, so its first byte is not mangled */
+	fd = open(slave, O_RDWR | O_NOCTTY);
+	if (fd < 0 || tcgetattr(fd, &t)) {
+		perror(slave);
+		exit(2);
+	}
+	cfmakeraw(&t);
+	tcsetattr(fd, TCSANOW, &t);
+
+	pid = fork();
+	if (pid < 0) {
+		perror("fork");
+		exit(2);
+	}
+	if (pid == 0) {
+		setsid();
+		dup2(fd, 0);
+		dup2(fd, 1);
+		close(fd);
+		close(ymt_fd);
+		execvp(argv[0], argv);
+		perror(argv[0]);
+		_exit(127);
+	}
+	close(fd);
+	fcntl(ymt_fd, F_SETFL, fcntl(ymt_fd, F_GETFL) | O_NONBLOCK);
+
+	return pid;
+}
+
+static unsigned char *ymt_load(const char *name, long *len)
+{
+	unsigned char *buf;
+	struct stat st;
+	FILE *f;
+
+	f = fopen(name, "rb");
+	if (!f || fstat(fileno(f), &st)) {
+		perror(name);
+		exit(2);
+	}
+	buf = malloc(st.st_size + 1);
+	*len = fread(buf, 1, st.st_size, f);
+	fclose(f);
+
+	return buf;
+}
+
+static void ymt_usage(void)
+{
+	fprintf(stderr, "usage: ymodemtest [-x | -y | -g] [-e offset] "
+		"file sender [args...]\n");
+	exit(2);
+}
+
+int main(int argc, char **argv)
+{
+	connection_info_t info;
+	struct timeval t0, t1;
+	unsigned char *want, *got = NULL;
+	long want_len, got_len = 0, size = 0, ms, i;
+	char buf[1024], **sargv;
+	int opt, err = 0, res, status, ok;
+	pid_t pid;
+
+	info.mode = xyzModem_ymodem_g;
+	info.chan = 0;
+	while ((opt = getopt(argc, argv, "+xyge:")) != -1) {
+		switch (opt) {
+		case 'x':
+			info.mode = xyzModem_xmodem;
+			break;
+		case 'y':
+			info.mode = xyzModem_ymodem;
+			break;
+		case 'g':
+			info.mode = xyzModem_ymodem_g;
+			break;
+		case 'e':
+			ymt_flip = strtol(optarg, NULL, 0);
+			break;
+		default:
+			ymt_usage();
+		}
+	}
+	if (argc - optind < 2)
+		ymt_usage();
+
+	want = ymt_load(argv[optind], &want_len);
+
+	/* sender [args...] file */
+	sargv = calloc(argc - optind + 1, sizeof(*sargv));
+	for (i = optind + 1; i < argc; i++)
+		sargv[i - optind - 1] = argv[i];
+	sargv[argc - optind - 1] = argv[optind];
+
+	signal(SIGPIPE, SIG_IGN);
+	pid = ymt_spawn(sargv);
+	gettimeofday(&t0, NULL);
+
+	res = xyzModem_stream_open(&info, &err);
+	if (!res) {
+		while ((res = xyzModem_stream_read(buf, sizeof(buf), &err)) > 0) {
+			if (got_len + res > size) {
+				size = 2 * size + sizeof(buf);
+				got = realloc(got, size);
+			}
+			memcpy(got + got_len, buf, res);
+			got_len += res;
+		}
+	}
+	if (err)
+		printf("%s\n", xyzModem_error(err));
+	xyzModem_stream_close(&err);
+	xyzModem_stream_terminate(false, &ymt_getcxmodem);
+
+	gettimeofday(&t1, NULL);
+	ms = (t1.tv_sec - t0.tv_sec) * 1000 + (t1.tv_usec - t0.tv_usec) / 1000;
+
+	/* The sender sees the line hang up; one that still hangs on is killed */
+	close(ymt_fd);
+	for (i = 0; i < 50 && !waitpid(pid, &status, WNOHANG); i++)
+		usleep(100000);
+	if (i == 50) {
+		kill(pid, SIGKILL);
+		waitpid(pid, &status, 0);
+	}
+
+	ok = got_len >= want_len && !memcmp(got, want, want_len);
+	for (i = want_len; ok && i < got_len; i++)
+		ok = info.mode == xyzModem_xmodem && got[i] == 0x1A;
+
+	printf("%ld of %ld bytes in %ld ms, %s", got_len, want_len, ms,
+		ok ? "match" : "MISMATCH");
+	if (info.filename)
+		printf(", name \"%s\"", info.filename);
+	if (WIFEXITED(status))
+		printf(", sender exit %d\n", WEXITSTATUS(status));
+	else
+		printf(", sender killed\n");
+
+	return !ok;
+}